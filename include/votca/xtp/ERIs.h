@@ -41,6 +41,16 @@ class ERIs {
   void Initialize_4c_screening(AOBasis& _dftbasis,
                                double eps);  // Pre-screening
 
+  // RI integrals in float only, e.g. for the first SCF iterations, has to be
+  // set before Initialize
+  void setSinglePrecision(bool single) {
+    _threecenter.setSinglePrecision(single);
+  }
+  bool isSinglePrecision() const { return _threecenter.isSinglePrecision(); }
+  // recomputes the RI integrals in double, the basis objects of Initialize
+  // have to exist
+  void SwitchToDoublePrecision() { _threecenter.RefillDouble(); }
+
   const Eigen::MatrixXd& getEXX() const { return _EXXs; }
 
   const Eigen::MatrixXd& getERIs() const { return _ERIs; }
@@ -85,7 +95,7 @@ class ERIs {
   void CalculateEXXEnergy(const Eigen::MatrixXd& DMAT);
 
   void FillERIsBlock(Eigen::MatrixXd& ERIsCur, const Eigen::MatrixXd& DMAT,
-                     const tensor4d& block, const AOShell& shell_1,
+                     const tensor4d_ref& block, const AOShell& shell_1,
                      const AOShell& shell_2, const AOShell& shell_3,
                      const AOShell& shell_4);
 };
@@ -0,0 +1,93 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __XTP_AOKERNELTABLE__H
+#define __XTP_AOKERNELTABLE__H
+
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <votca/xtp/aoshell.h>
+#include <votca/xtp/eigen.h>
+
+namespace votca {
+namespace xtp {
+
+// number of cartesian functions of all shells up to lmax, as getBlockSize
+constexpr int AOBlockSize(int lmax) {
+  return (lmax + 1) * (lmax + 2) * (lmax + 3) / 6;
+}
+
+/* Dispatch table for shell pair kernels which are specialized at compile time
+ * on the angular momenta of both shells, so that all branches on l and all
+ * buffer sizes are resolved by the compiler.
+ * Kernel<LROW, LCOL>::Fill has to exist for all LROW, LCOL <= LMAX.
+ */
+template <template <int, int> class Kernel, int LMAX>
+class AOKernelTable {
+ public:
+  typedef void (*Function)(Eigen::Block<Eigen::MatrixXd>& matrix,
+                           const AOShell* shell_row, const AOShell* shell_col);
+
+  static Function get(int lmax_row, int lmax_col) {
+    static const std::array<Function, Size> table =
+        Build(std::make_integer_sequence<int, Size>());
+    return table[lmax_row * (LMAX + 1) + lmax_col];
+  }
+
+ private:
+  static constexpr int Size = (LMAX + 1) * (LMAX + 1);
+
+  template <int... I>
+  static std::array<Function, Size> Build(std::integer_sequence<int, I...>) {
+    return {{&Kernel<I / (LMAX + 1), I % (LMAX + 1)>::Fill...}};
+  }
+};
+
+/* Fixed size scratch array for the recursions, indexed as a[i][j][k]. It
+ * lives on the stack unless it is larger than 64kB, as for high l.
+ */
+template <int N1, int N2, int N3>
+class AOScratch3D {
+ public:
+  typedef double Slice[N2][N3];
+
+  AOScratch3D() { Init(_data); }
+
+  Slice& operator[](int i) {
+    return reinterpret_cast<Slice*>(_data.data())[i];
+  }
+
+ private:
+  static constexpr int Size = N1 * N2 * N3;
+  typedef typename std::conditional<(Size * sizeof(double) <= 65536),
+                                    std::array<double, Size>,
+                                    std::vector<double> >::type Storage;
+
+  static void Init(std::array<double, Size>& data) { data.fill(0.0); }
+  static void Init(std::vector<double>& data) { data.assign(Size, 0.0); }
+
+  Storage _data;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif /* __XTP_AOKERNELTABLE__H */
@@ -221,8 +221,6 @@ class AOMatrix : public AOSuperMatrix {
     return _aomatrix;
   }
   void Fill(const AOBasis& aobasis);
-  // integrate F
-  static std::vector<double> XIntegrate(int size, double U);
 
  protected:
   virtual void FillBlock(
@@ -271,32 +269,89 @@ class AODipole : public AOMatrix3D {
   tools::vec _r = tools::vec(0.0);
 };
 
-// derived class for atomic orbital nuclear potential
-class AOESP : public AOMatrix<double> {
+/* base class for the potential of external multipoles (MM sites). Sites far
+ * away from a pair of atoms are represented by a Taylor expansion of their
+ * potential around the center of the pair, which only needs the overlap,
+ * dipole and quadrupole moments of the basis functions.
+ */
+class AOMultipolePotential : public AOMatrix<double> {
  public:
-  void Fillnucpotential(const AOBasis& aobasis,
-                        const std::vector<QMAtom*>& atoms);
+  // with R = r - position the potential operator of a site is
+  // charge/R + dipole.R/R^3 + R.quadrupole.R/R^5, all in atomic units
+  struct Multipole {
+    tools::vec position = tools::vec(0.0);
+    double charge = 0.0;
+    Eigen::Vector3d dipole = Eigen::Vector3d::Zero();
+    Eigen::Matrix3d quadrupole = Eigen::Matrix3d::Zero();
+  };
+
   void Fillextpotential(
       const AOBasis& aobasis,
       const std::vector<std::shared_ptr<ctp::PolarSeg> >& sites);
-  const Eigen::MatrixXd& getNuclearpotential() const {
-    return _nuclearpotential;
-  }
+  Eigen::MatrixXd& getExternalpotential() { return _externalpotential; }
   const Eigen::MatrixXd& getExternalpotential() const {
     return _externalpotential;
   }
-  void setPosition(const tools::vec& r) { _r = r; };
+  // relative error of the expanded potential, 0 treats all sites exactly
+  void setFarFieldAccuracy(double accuracy) { _farfield_accuracy = accuracy; }
+
+  // overlap, dipole (x,y,z) and quadrupole (xx,xy,xz,yy,yz,zz) moments
+  // around center of the functions of two shells
+  static std::vector<Eigen::MatrixXd> FillMoments(const AOShell* shell_row,
+                                                  const AOShell* shell_col,
+                                                  const tools::vec& center);
 
  protected:
+  // false if the site does not contribute to this potential
+  virtual bool getMultipole(ctp::APolarSite* site,
+                            Multipole& multipole) const = 0;
+  // adds the exact matrix elements of a single site
+  virtual void FillPotential(Eigen::Block<Eigen::MatrixXd>& matrix,
+                             const AOShell* shell_row,
+                             const AOShell* shell_col,
+                             const Multipole& multipole) = 0;
+
   void FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
-                 const AOShell* shell_row, const AOShell* shell_col);
+                 const AOShell* shell_row, const AOShell* shell_col) {
+    FillPotential(matrix, shell_row, shell_col, _multipole);
+  }
+
+  Multipole _multipole;
 
  private:
-  tools::vec _r;
-  Eigen::MatrixXd _nuclearpotential;
+  // adds the Taylor coefficients of the potential around center
+  static void AddFarField(const Multipole& multipole, const tools::vec& center,
+                          double& potential, Eigen::Vector3d& gradient,
+                          Eigen::Matrix3d& hessian);
+
+  double _farfield_accuracy = 0.0;
   Eigen::MatrixXd _externalpotential;
 };
 
+// derived class for atomic orbital nuclear potential
+class AOESP : public AOMultipolePotential {
+ public:
+  void Fillnucpotential(const AOBasis& aobasis,
+                        const std::vector<QMAtom*>& atoms);
+  const Eigen::MatrixXd& getNuclearpotential() const {
+    return _nuclearpotential;
+  }
+  // unit charge at r for Fill
+  void setPosition(const tools::vec& r) {
+    _multipole.position = r;
+    _multipole.charge = 1.0;
+  };
+
+ protected:
+  bool getMultipole(ctp::APolarSite* site, Multipole& multipole) const;
+  void FillPotential(Eigen::Block<Eigen::MatrixXd>& matrix,
+                     const AOShell* shell_row, const AOShell* shell_col,
+                     const Multipole& multipole);
+
+ private:
+  Eigen::MatrixXd _nuclearpotential;
+};
+
 // derived class for Effective Core Potentials
 class AOECP : public AOMatrix<double> {
  public:
@@ -332,6 +387,8 @@ class AOKinetic : public AOMatrix<double> {
 class AOOverlap : public AOMatrix<double> {
  public:
   Eigen::MatrixXd FillShell(const AOShell* shell);
+  Eigen::MatrixXd FillShellPair(const AOShell* shell_row,
+                                const AOShell* shell_col);
   int Removedfunctions() const { return removedfunctions; }
   double SmallestEigenValue() const { return smallestEigenvalue; }
 
@@ -347,45 +404,20 @@ class AOOverlap : public AOMatrix<double> {
   double smallestEigenvalue;
 };
 
-class AODipole_Potential : public AOMatrix<double> {
- public:
-  void Fillextpotential(
-      const AOBasis& aobasis,
-      const std::vector<std::shared_ptr<ctp::PolarSeg> >& sites);
-  Eigen::MatrixXd& getExternalpotential() { return _externalpotential; }
-  const Eigen::MatrixXd& getExternalpotential() const {
-    return _externalpotential;
-  }
-
+class AODipole_Potential : public AOMultipolePotential {
  protected:
-  void FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
-                 const AOShell* shell_row, const AOShell* shell_col);
-
- private:
-  void setAPolarSite(ctp::APolarSite* site) { apolarsite = site; };
-  ctp::APolarSite* apolarsite;
-  Eigen::MatrixXd _externalpotential;
+  bool getMultipole(ctp::APolarSite* site, Multipole& multipole) const;
+  void FillPotential(Eigen::Block<Eigen::MatrixXd>& matrix,
+                     const AOShell* shell_row, const AOShell* shell_col,
+                     const Multipole& multipole);
 };
 
-class AOQuadrupole_Potential : public AOMatrix<double> {
- public:
-  void Fillextpotential(
-      const AOBasis& aobasis,
-      const std::vector<std::shared_ptr<ctp::PolarSeg> >& sites);
-  Eigen::MatrixXd& getExternalpotential() { return _externalpotential; }
-  const Eigen::MatrixXd& getExternalpotential() const {
-    return _externalpotential;
-  }
-
+class AOQuadrupole_Potential : public AOMultipolePotential {
  protected:
-  void FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
-                 const AOShell* shell_row, const AOShell* shell_col);
-
- private:
-  void setAPolarSite(ctp::APolarSite* site) { apolarsite = site; };
-
-  ctp::APolarSite* apolarsite;
-  Eigen::MatrixXd _externalpotential;
+  bool getMultipole(ctp::APolarSite* site, Multipole& multipole) const;
+  void FillPotential(Eigen::Block<Eigen::MatrixXd>& matrix,
+                     const AOShell* shell_row, const AOShell* shell_col,
+                     const Multipole& multipole);
 };
 
 // derived class for atomic orbital Coulomb interaction
@@ -0,0 +1,73 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_XTP_ATOMICGUESSLIBRARY_H
+#define __VOTCA_XTP_ATOMICGUESSLIBRARY_H
+
+#include <map>
+#include <string>
+#include <votca/tools/mutex.h>
+#include <votca/xtp/eigen.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief Library of the spherically averaged atomic densities of the atomic
+ * guess
+ *
+ * An atomic density only depends on the element, the basis set, the ECP, the
+ * functional and the grid, which together form its key. Each density is kept
+ * in memory for the rest of the process. If a directory is given it is also
+ * stored there as a checkpoint file, so later processes read it instead of
+ * redoing the atomic SCF. Files are written under a temporary name and then
+ * renamed, so jobs sharing the directory never see partial files. All
+ * methods may be called from several threads.
+ */
+class AtomicGuessLibrary {
+ public:
+  /// the library shared by all DFTEngines of the process
+  static AtomicGuessLibrary& Instance();
+
+  static std::string Key(const std::string& element, const std::string& basis,
+                         const std::string& ecp, const std::string& functional,
+                         const std::string& grid);
+
+  /// looks in memory and then in directory, returns false if key is unknown
+  bool Find(const std::string& key, const std::string& directory,
+            Eigen::MatrixXd& dmat);
+
+  /// keeps dmat in memory and writes it to directory, if that is not empty
+  void Insert(const std::string& key, const std::string& directory,
+              const Eigen::MatrixXd& dmat);
+
+  int size();
+
+ private:
+  static std::string FileName(const std::string& key,
+                              const std::string& directory);
+
+  std::map<std::string, Eigen::MatrixXd> _densities;
+  tools::Mutex _mutex;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif  // __VOTCA_XTP_ATOMICGUESSLIBRARY_H
@@ -0,0 +1,53 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_XTP_BOYSFUNCTION_H
+#define __VOTCA_XTP_BOYSFUNCTION_H
+
+#include <array>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief Boys function F_m(U) = int_0^1 t^2m exp(-U t^2) dt
+ *
+ * The highest order is interpolated by a Taylor expansion around the nearest
+ * point of a precomputed grid, the lower orders follow from the stable
+ * downward recursion, so one evaluation costs a single exp. For large U the
+ * asymptotic upward recursion is used. The table is built on first use.
+ */
+class BoysFunction {
+ public:
+  // enough for (ii|ii) four-center integrals
+  static constexpr int MaxSize = 32;
+  typedef std::array<double, MaxSize> Values;
+
+  // writes F_0(U) ... F_size-1(U) to FmU, size <= MaxSize
+  static void Evaluate(int size, double U, double* FmU);
+
+  static void Evaluate(int size, double U, Values& FmU) {
+    Evaluate(size, U, FmU.data());
+  }
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif  // __VOTCA_XTP_BOYSFUNCTION_H
@@ -82,6 +82,12 @@ class BSE {
 
   void SetupHt();
 
+  /// applies the TDA hamiltonians to the columns of X without setting up the
+  /// full matrix, costs O(vc(v+c)aux) per column instead of O(v^2c^2aux)
+  Eigen::MatrixXd ApplyHs(const Eigen::MatrixXd& X) const;
+
+  Eigen::MatrixXd ApplyHt(const Eigen::MatrixXd& X) const;
+
   void FreeTriplets() { _bse_triplet_coefficients.resize(0, 0); }
 
   void FreeSinglets() {
@@ -138,6 +144,12 @@ class BSE {
   void Add_Hd(Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& H);
   template <typename T, int factor>
   void Add_Hd2(Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& H);
+  MatrixXfd StackTransitions() const;
+
+  void Apply_Hqp(const MatrixXfd& X, MatrixXfd& HX) const;
+  template <int factor>
+  void Apply_Hx(const MatrixXfd& X, MatrixXfd& HX) const;
+  void Apply_Hd(const MatrixXfd& X, MatrixXfd& HX) const;
 
   void printFragInfo(const Population& pop, int i);
   void printWeights(int i_bse, double weight);
@@ -17,6 +17,7 @@
  *
  */
 
+#include <votca/xtp/bse.h>
 #include <votca/xtp/couplingbase.h>
 #include <votca/xtp/qmstate.h>
 
@@ -39,6 +40,9 @@ class BSECoupling : public CouplingBase {
   void Initialize(tools::Property& options);
   std::string Identify() { return "bsecoupling"; }
 
+  /// overrides the openmp option, 0 uses the threads of the calling thread
+  void setNumofThreads(int threads) { _openmp_threads = threads; }
+
   Eigen::MatrixXd getJAB_singletstorage() {
     return (_output_perturbation ? JAB_singlet[0] : JAB_singlet[1]);
   }
@@ -63,7 +67,12 @@ class BSECoupling : public CouplingBase {
 
   std::vector<Eigen::MatrixXd> ProjectExcitons(const Eigen::MatrixXd& bseA_T,
                                                const Eigen::MatrixXd& bseB_T,
-                                               Eigen::MatrixXd& H);
+                                               const QMStateType& type,
+                                               const Orbitals& orbitalsAB,
+                                               const BSE& bse);
+
+  BSE::options SetupDimerInteraction(const Orbitals& orbitalsAB,
+                                     TCMatrix_gwbse& Mmn, Eigen::MatrixXd& Hqp);
 
   Eigen::MatrixXd Fulldiag(const Eigen::MatrixXd& J_dimer);
 
@@ -75,6 +84,7 @@ class BSECoupling : public CouplingBase {
   bool _doTriplets;
   bool _doSinglets;
   bool _output_perturbation;
+  bool _matrixfree;
   int _levA;
   int _levB;
   int _occA;
@@ -20,21 +20,21 @@
 #define __VOTCA_CHARGECARRIER_H
 
 #include <votca/tools/vec.h>
-#include <votca/xtp/gnode.h>
+#include <votca/xtp/kmcgraph.h>
 
 namespace votca {
 namespace xtp {
 
 class Chargecarrier {
  public:
-  Chargecarrier() : lifetime(0.0), steps(0) {
+  Chargecarrier(KMCGraph* graph)
+      : node(-1), _graph(graph), lifetime(0.0), steps(0) {
     dr_travelled = tools::vec(0.0, 0.0, 0.0);
-    node = NULL;
   }
   ~Chargecarrier(){};
-  bool hasNode() { return (node != NULL); }
+  bool hasNode() { return (node >= 0); }
   void updateLifetime(double dt) { lifetime += dt; }
-  void updateOccupationtime(double dt) { node->occupationtime += dt; }
+  void updateOccupationtime(double dt) { _graph->AddOccupationTime(node, dt); }
   void updateSteps(unsigned t) { steps += t; }
   void resetCarrier() {
     lifetime = 0;
@@ -43,18 +43,17 @@ class Chargecarrier {
   }
   const double& getLifetime() { return lifetime; }
   const unsigned& getSteps() { return steps; }
-  const int& getCurrentNodeId() { return node->id; }
-  double getCurrentEnergy() { return node->siteenergy; }
-  tools::vec getCurrentPosition() { return node->position; }
-  double getCurrentEscapeRate() { return node->escape_rate; }
-  GNode* getCurrentNode() { return node; }
-  void settoNote(GNode* newnode) {
+  const int& getCurrentNodeId() { return node; }
+  double getCurrentEnergy() { return _graph->SiteEnergy(node); }
+  tools::vec getCurrentPosition() { return _graph->Position(node); }
+  double getCurrentEscapeRate() { return _graph->EscapeRate(node); }
+  void settoNote(int newnode) {
     node = newnode;
-    node->occupied = true;
+    _graph->setOccupied(node, true);
   }
 
-  void jumpfromCurrentNodetoNode(GNode* newnode) {
-    node->occupied = false;
+  void jumpfromCurrentNodetoNode(int newnode) {
+    _graph->setOccupied(node, false);
     settoNote(newnode);
   }
   int id;
@@ -62,7 +61,8 @@ class Chargecarrier {
   tools::vec dr_travelled;
 
  private:
-  GNode* node;
+  int node;
+  KMCGraph* _graph;
   double lifetime;
   unsigned steps;
 };
@@ -21,8 +21,9 @@
 #define _VOTCA_XTP_COUPLINGBASE_H
 
 #include <boost/format.hpp>
+#include <memory>
 #include <votca/ctp/logger.h>
-#include <votca/xtp/aomatrix.h>
+#include <votca/xtp/dimerprojection.h>
 #include <votca/xtp/orbitals.h>
 
 namespace votca {
@@ -50,25 +51,50 @@ class CouplingBase {
 
   void setLogger(ctp::Logger* pLog) { _pLog = pLog; }
 
+  /// shares the projection of one pair between several couplings, it is
+  /// initialized by the first coupling using it. Without it every
+  /// CalculateCouplings sets up its own projection.
+  void setDimerProjection(std::shared_ptr<DimerProjection> projection) {
+    _projection = projection;
+    _shared_projection = (projection != nullptr);
+  }
+
  protected:
   ctp::Logger* _pLog;
   void CheckAtomCoordinates(const Orbitals& orbitalsA,
                             const Orbitals& orbitalsB,
                             const Orbitals& orbitalsAB);
 
-  Eigen::MatrixXd CalculateOverlapMatrix(Orbitals& orbitalsAB);
+  const DimerProjection& getDimerProjection(const Orbitals& orbitalsA,
+                                            const Orbitals& orbitalsB,
+                                            const Orbitals& orbitalsAB);
+
+ private:
+  std::shared_ptr<DimerProjection> _projection;
+  bool _shared_projection = false;
 };
 
-inline Eigen::MatrixXd CouplingBase::CalculateOverlapMatrix(
-    Orbitals& orbitalsAB) {
-  BasisSet dftbasisset;
-  AOBasis dftbasis;
-  dftbasisset.LoadBasisSet(orbitalsAB.getDFTbasisName());
-  dftbasis.AOBasisFill(dftbasisset, orbitalsAB.QMAtoms());
-  AOOverlap dftAOoverlap;
-  dftAOoverlap.Fill(dftbasis);
-  Eigen::MatrixXd overlapAB = dftAOoverlap.Matrix();
-  return overlapAB;
+inline const DimerProjection& CouplingBase::getDimerProjection(
+    const Orbitals& orbitalsA, const Orbitals& orbitalsB,
+    const Orbitals& orbitalsAB) {
+  if (!_shared_projection) {
+    _projection = std::make_shared<DimerProjection>();
+  }
+  if (!_projection->isInitialized()) {
+    if (orbitalsAB.hasAOOverlap()) {
+      CTP_LOG(ctp::logDEBUG, *_pLog)
+          << "Reading overlap matrix from orbitals" << std::flush;
+    } else {
+      CTP_LOG(ctp::logDEBUG, *_pLog)
+          << "Calculating inter-monomer overlap for basisset: "
+          << orbitalsAB.getDFTbasisName() << std::flush;
+    }
+    _projection->Initialize(orbitalsA, orbitalsB, orbitalsAB);
+  } else {
+    CTP_LOG(ctp::logDEBUG, *_pLog)
+        << "Reusing overlap of monomers and dimer" << std::flush;
+  }
+  return *_projection;
 }
 
 inline void CouplingBase::CheckAtomCoordinates(const Orbitals& orbitalsA,
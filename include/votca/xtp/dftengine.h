@@ -21,9 +21,11 @@
 #define _VOTCA_XTP_DFTENGINE_H
 
 #include <boost/filesystem.hpp>
+#include <memory>
 #include <votca/ctp/logger.h>
 #include <votca/ctp/polarseg.h>
 #include <votca/ctp/topology.h>
+#include <votca/tools/thread.h>
 #include <votca/xtp/ERIs.h>
 #include <votca/xtp/convergenceacc.h>
 #include <votca/xtp/numerical_integrations.h>
@@ -49,12 +51,20 @@ class DFTEngine {
     _integrate_ext_density = false;
   };
 
+  // the grid setup thread uses the atoms and basis of this engine
+  ~DFTEngine() { WaitGridSetup(); }
+
   void Initialize(tools::Property& options);
 
   void CleanUp();
 
   void setLogger(ctp::Logger* pLog) { _pLog = pLog; }
 
+  /// 0 uses the OpenMP threads of the calling thread
+  void setNumofThreads(int threads) { _openmp_threads = threads; }
+
+  void setReadGuess(bool read_guess) { _with_guess = read_guess; }
+
   void ConfigureExternalGrid(const std::string& grid_name_ext) {
     _grid_name_ext = grid_name_ext;
     _do_externalfield = true;
@@ -91,10 +101,17 @@ class DFTEngine {
   void SetupInvariantMatrices();
   Eigen::MatrixXd AtomicGuess(Orbitals& orbitals);
   std::string ReturnSmallGrid(const std::string& largegrid);
+  std::vector<std::string> ReturnGridLadder(const std::string& smallgrids);
+  NumericalIntegration& GridLevel(unsigned level);
+  double GridSwitchError() const;
+  void StartGridSetup(unsigned level);
+  void WaitGridSetup();
+  void SwitchGridLevel();
 
   Eigen::MatrixXd IntegrateExternalDensity(Orbitals& extdensity);
 
-  Eigen::MatrixXd RunAtomicDFT_unrestricted(QMAtom* uniqueAtom);
+  Eigen::MatrixXd RunAtomicDFT_unrestricted(QMAtom* uniqueAtom,
+                                            ctp::Logger* pLog);
   Eigen::MatrixXd RunAtomicDFT_fractional(QMAtom* uniqueAtom);
 
   void NuclearRepulsion();
@@ -132,10 +149,16 @@ class DFTEngine {
 
   // numerical integration Vxc
   std::string _grid_name;
-  std::string _grid_name_small;
-  bool _use_small_grid;
+  // grids the SCF moves through from coarse to fine, ends with _grid_name
+  std::vector<std::string> _grid_ladder;
+  double _grid_switch_error;
+  // OpenMP threads of the background setup of the next grid
+  int _grid_setup_threads;
+  unsigned _grid_level;
   NumericalIntegration _gridIntegration;
-  NumericalIntegration _gridIntegration_small;
+  std::vector<std::unique_ptr<NumericalIntegration> > _gridIntegration_ladder;
+  // sets up the next grid of the ladder while the SCF iterates
+  std::unique_ptr<tools::Thread> _grid_setup;
   // used to store Vxc after final iteration
 
   // numerical integration externalfield;
@@ -160,6 +183,8 @@ class DFTEngine {
 
   bool _with_guess;
   std::string _initial_guess;
+  // directory of the atomic guess library, not written if empty
+  std::string _atomic_guess_cache;
 
   // Convergence
   int _numofelectrons = 0;
@@ -169,10 +194,16 @@ class DFTEngine {
   ConvergenceAcc _conv_accelerator;
   // Electron repulsion integrals
   ERIs _ERIs;
+  // RI integrals in float while the DIIS error is above
+  // _mixed_precision_error, then recomputed in double
+  bool _mixed_precision;
+  double _mixed_precision_error;
 
   // external charges
   std::vector<std::shared_ptr<ctp::PolarSeg> > _externalsites;
   bool _addexternalsites;
+  // sites beyond this relative accuracy use a multipole expansion
+  double _farfield_accuracy;
 
   // exchange and correlation
   double _ScaHFX;
@@ -0,0 +1,92 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_XTP_DIMERPROJECTION_H
+#define __VOTCA_XTP_DIMERPROJECTION_H
+
+#include <votca/xtp/aobasis.h>
+#include <votca/xtp/eigen.h>
+#include <votca/xtp/orbitals.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief Projection of monomer orbitals on the orbitals of a dimer
+ *
+ * The dimer AO basis consists of the functions of A, then B, then of the
+ * linker atoms. The projection <phi^A_i|phi^AB_j> only needs the overlap of
+ * A with B and the linker, the overlap inside A enters as C_A^T S_AA, which
+ * is C_A^-1 for a complete set of monomer orbitals. So only the
+ * inter-monomer shell pairs are integrated, unless the dimer orbitals
+ * already carry their AO overlap.
+ *
+ * The projection is set up once per pair and shared by DFTcoupling and
+ * BSECoupling. It keeps no reference to the orbitals, Project has to be
+ * called with the orbitals it was initialized with.
+ */
+class DimerProjection {
+ public:
+  /// monomer orbitals as block diagonal matrix | A 0 |
+  ///                                             | 0 B |
+  static Eigen::MatrixXd MergeMOs(const Eigen::MatrixXd& mosA,
+                                  const Eigen::MatrixXd& mosB);
+
+  void Initialize(const Orbitals& orbitalsA, const Orbitals& orbitalsB,
+                  const Orbitals& orbitalsAB);
+
+  bool isInitialized() const { return _initialized; }
+
+  /// overlap of nA levels of A from minA and nB levels of B from minB (rows)
+  /// with all dimer orbitals (cols)
+  Eigen::MatrixXd Project(const Orbitals& orbitalsA, const Orbitals& orbitalsB,
+                          const Orbitals& orbitalsAB, int minA, int nA,
+                          int minB, int nB) const;
+
+ private:
+  Eigen::MatrixXd OverlapBlock(const AOBasis& basis, int row_start,
+                               int row_size, int col_start,
+                               int col_size) const;
+  void SetupProjector(const Eigen::MatrixXd& mos, const AOBasis& basis,
+                      int start, Eigen::MatrixXd& projector,
+                      Eigen::PartialPivLU<Eigen::MatrixXd>& lu) const;
+  static Eigen::MatrixXd ProjectorRows(
+      const Eigen::MatrixXd& projector,
+      const Eigen::PartialPivLU<Eigen::MatrixXd>& lu, int min, int n);
+
+  bool _initialized = false;
+  int _basisA = 0;
+  int _basisB = 0;
+  int _basisL = 0;
+
+  // C^T S of the monomers, or the LU decomposition of C^T if C is square
+  Eigen::MatrixXd _projectorA;
+  Eigen::MatrixXd _projectorB;
+  Eigen::PartialPivLU<Eigen::MatrixXd> _luA;
+  Eigen::PartialPivLU<Eigen::MatrixXd> _luB;
+
+  Eigen::MatrixXd _overlapAB;
+  Eigen::MatrixXd _overlapAL;
+  Eigen::MatrixXd _overlapBL;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif  // __VOTCA_XTP_DIMERPROJECTION_H
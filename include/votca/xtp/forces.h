@@ -36,7 +36,9 @@ class Forces {
   Forces(GWBSEEngine& gwbse_engine, const Statefilter& filter)
       : _gwbse_engine(gwbse_engine),
         _filter(filter),
-        _remove_total_force(false){};
+        _remove_total_force(false),
+        _tasks(1),
+        _warm_start(true){};
 
   void Initialize(tools::Property& options);
   void Calculate(const Orbitals& orbitals);
@@ -47,8 +49,18 @@ class Forces {
   void Report() const;
 
  private:
-  Eigen::Vector3d NumForceForward(Orbitals orbitals, int atom_index);
-  Eigen::Vector3d NumForceCentral(Orbitals orbitals, int atom_index);
+  // one displaced geometry of the finite difference scheme
+  struct Displacement {
+    int atom;
+    int cart;
+    double delta;
+    double energy;
+  };
+
+  void RunDisplacements(const Orbitals& orbitals,
+                        std::vector<Displacement>& displacements);
+  double DisplacedEnergy(GWBSEEngine& engine, const Orbitals& orbitals,
+                         const Displacement& displacement) const;
   void RemoveTotalForce();
 
   double _displacement;
@@ -57,6 +69,10 @@ class Forces {
   GWBSEEngine& _gwbse_engine;
   const Statefilter& _filter;
   bool _remove_total_force;
+  // number of displacements evaluated concurrently
+  int _tasks;
+  // start every displaced SCF from the MOs of the reference geometry
+  bool _warm_start;
 
   Eigen::MatrixX3d _forces;
   ctp::Logger* _pLog;
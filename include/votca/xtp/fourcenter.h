@@ -41,7 +41,7 @@ class FCMatrix {
 
   const Eigen::VectorXd& get_4c_vector() { return _4c_vector; }
 
-  bool FillFourCenterRepBlock(tensor4d& block, const AOShell* _shell_1,
+  bool FillFourCenterRepBlock(tensor4d_ref& block, const AOShell* _shell_1,
                               const AOShell* _shell_2, const AOShell* _shell_3,
                               const AOShell* _shell_4);
 
@@ -22,15 +22,17 @@
 #include <fstream>
 #include <votca/ctp/logger.h>
 #include <votca/tools/property.h>
+#include <votca/xtp/aobasis.h>
 #include <votca/xtp/eigen.h>
 #include <votca/xtp/gw.h>
+#include <votca/xtp/threecenter.h>
 
 #include "bse.h"
 
 namespace votca {
 namespace xtp {
 class Orbitals;
-class AOBasis;
+class BasisSet;
 /**
  * \brief Electronic excitations from GW-BSE
  *
@@ -48,7 +50,8 @@ class AOBasis;
 
 class GWBSE {
  public:
-  GWBSE(Orbitals& orbitals) : _orbitals(orbitals){};
+  GWBSE(Orbitals& orbitals)
+      : _orbitals(orbitals), _dftbasisset(NULL), _auxbasisset(NULL){};
 
   void Initialize(tools::Property& options);
 
@@ -56,8 +59,21 @@ class GWBSE {
 
   void setLogger(ctp::Logger* pLog) { _pLog = pLog; }
 
+  /// overrides the openmp option, 0 uses the threads of the calling thread
+  void setNumofThreads(int threads) { _openmp_threads = threads; }
+
   bool Evaluate();
 
+  // Evaluate in two steps, so that the integrals of one geometry can be
+  // prepared while another one is solved. The basis sets, if given, must
+  // match the basis set names of the options and outlive PrepareIntegrals.
+  void setBasisSets(const BasisSet* dftbasisset, const BasisSet* auxbasisset) {
+    _dftbasisset = dftbasisset;
+    _auxbasisset = auxbasisset;
+  }
+  void PrepareIntegrals();
+  void SolveGWBSE();
+
   void addoutput(tools::Property& summary);
 
  private:
@@ -86,6 +102,13 @@ class GWBSE {
 
   int _openmp_threads;
 
+  // relative tolerance for truncating the aux space of Mmn, 0 is off
+  double _aux_compression;
+
+  // memory limit for the 3c integrals in MB, 0 is no limit
+  int _max_memory_3c;
+  std::string _scratch_directory;
+
   // fragment definitions
   int _fragA;
 
@@ -97,6 +120,14 @@ class GWBSE {
   // basis sets
   std::string _auxbasis_name;
   std::string _dftbasis_name;
+  const BasisSet* _dftbasisset;
+  const BasisSet* _auxbasisset;
+
+  // kept from PrepareIntegrals for SolveGWBSE
+  AOBasis _dftbasis;
+  AOBasis _auxbasis;
+  Eigen::MatrixXd _vxc;
+  TCMatrix_gwbse _Mmn;
 };
 }  // namespace xtp
 }  // namespace votca
@@ -51,6 +51,8 @@ class GWBSEEngine {
 
   void setQMPackage(QMPackage* qmpackage) { _qmpackage = qmpackage; }
 
+  QMPackage* getQMPackage() { return _qmpackage; }
+
   std::string GetDFTLog() const { return _dftlog_file; };
 
   void setLoggerFile(std::string logger_file) { _logger_file = logger_file; };
@@ -0,0 +1,101 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_XTP_JOBSTORE_H
+#define __VOTCA_XTP_JOBSTORE_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <votca/ctp/job.h>
+#include <votca/tools/database.h>
+#include <votca/tools/mutex.h>
+#include <votca/tools/property.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief sqlite database holding the jobs of a job calculator
+ */
+class JobDatabase : public tools::Database {
+ public:
+  void onCreate();
+};
+
+/**
+ * \brief Job queue of xtp_parallel in an sqlite database
+ *
+ * Replaces the xml job file during a run. Jobs are claimed and reported one
+ * row at a time inside sqlite transactions, so several processes can work on
+ * the same store without rereading and rewriting all jobs. A crashed process
+ * leaves its jobs ASSIGNED, they are made available again with the usual
+ * restart pattern. Each job carries a cost estimate and jobs are handed out
+ * largest first (longest processing time first), so no expensive job is
+ * left over at the end of a run. Jobs are imported from and exported to the
+ * xml job format, so WriteJobFile and ReadJobFile of the calculators are
+ * unchanged.
+ * All methods may be called from several threads.
+ */
+class JobStore {
+ public:
+  ~JobStore() { Close(); }
+
+  void Open(const std::string& file);
+  void Close() { _db.Close(); }
+
+  /// inserts or replaces the jobs of an xml job file, returns their number
+  int ImportJobs(const std::string& xmlfile,
+                 const std::function<double(ctp::Job*)>& cost = nullptr);
+  void ExportJobs(const std::string& xmlfile);
+
+  int CountJobs(const std::string& status);
+  double MeanCost(const std::string& status);
+
+  /// makes jobs matching 'host(name:pid) stat(FAILED)' available again
+  void ResetJobs(const std::string& restart_pattern);
+
+  /// marks up to n available jobs as ASSIGNED to host and returns them,
+  /// most expensive first
+  std::vector<ctp::Job*> ClaimJobs(int n, const std::string& host,
+                                   std::vector<double>* costs = NULL);
+
+  void ReportJob(ctp::Job& job, ctp::Job::JobResult& result,
+                 const std::string& host);
+
+  static std::string EncodeProperty(tools::Property& prop);
+  /// adds the encoded property as child of parent
+  static void DecodeProperty(const std::string& code, tools::Property& parent);
+
+ private:
+  static void EncodeString(const std::string& value, std::string& code);
+  static std::string DecodeString(const std::string& code, size_t& pos);
+  static void DecodeNode(const std::string& code, size_t& pos,
+                         tools::Property& parent);
+
+  static std::string CurrentTime();
+
+  JobDatabase _db;
+  tools::Mutex _mutex;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif  // __VOTCA_XTP_JOBSTORE_H
@@ -0,0 +1,117 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_XTP_JOBSTORECALC_H
+#define __VOTCA_XTP_JOBSTORECALC_H
+
+#include <deque>
+#include <map>
+#include <votca/ctp/parallelxjobcalc.h>
+#include <votca/ctp/segment.h>
+#include <votca/tools/mutex.h>
+#include <votca/xtp/jobstore.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief Job calculator which can run its jobs from a JobStore
+ *
+ * Without UseJobStore it behaves like ctp::ParallelXJobCalc and works on the
+ * xml job file through the progress observer. With the job store the jobs
+ * are claimed from and reported to the sqlite file <job_file>.sql, which is
+ * imported from the xml job file if it does not exist yet.
+ *
+ * In the job store every job gets the cost estimate of JobCost. Jobs are run
+ * largest first and each job gets OpenMP threads from the threads available
+ * to the process in proportion to its cost relative to the mean cost, so
+ * large jobs run on more cores than small ones.
+ */
+class JobStoreCalc
+    : public ctp::ParallelXJobCalc<std::vector<ctp::Job*>, ctp::Job*,
+                                   ctp::Job::JobResult> {
+ public:
+  JobStoreCalc()
+      : _use_store(false),
+        _cache(8),
+        _maxjobs(-1),
+        _restart(""),
+        _jobs_claimed(0),
+        _core_budget(1),
+        _free_cores(1),
+        _mean_cost(1.0){};
+  virtual ~JobStoreCalc(){};
+
+  void UseJobStore(int cache, int maxjobs, const std::string& restart);
+  bool UsesJobStore() const { return _use_store; }
+
+  /// copies the xml job file into the job store, estimating the job costs
+  void ImportJobFile(ctp::Topology* top);
+  /// writes the job store back to the xml job file
+  void ExportJobFile();
+
+  bool EvaluateFrame(ctp::Topology* top);
+
+ protected:
+  std::string JobStoreFile() const { return _jobfile + ".sql"; }
+
+  /// relative cost of a job, only the ratios between jobs matter
+  virtual double JobCost(ctp::Topology* top, ctp::Job* job) { return 1.0; }
+
+  /// number of basis functions of the QM atoms of segments, falls back to
+  /// the number of QM atoms if the basisset cannot be loaded
+  int CountBasisFunctions(const std::vector<ctp::Segment*>& segments,
+                          const std::string& basisname);
+
+  /// OpenMP threads allocated to the job that thread runs, 0 if the job
+  /// does not come from the job store. The engines of EvalJob have to use
+  /// this instead of their own thread options.
+  int JobThreads(ctp::QMThread* thread) const;
+
+ private:
+  class JobStoreOperator;
+
+  ctp::Job* NextJob(double& cost);
+  int AllocateThreads(double cost);
+  void ReleaseThreads(int threads);
+  static std::string GenerateHost();
+
+  bool _use_store;
+  int _cache;
+  int _maxjobs;
+  std::string _restart;
+  std::string _host;
+
+  int _jobs_claimed;
+  std::deque<std::pair<ctp::Job*, double> > _queue;
+  tools::Mutex _claim_mutex;
+  JobStore _store;
+
+  int _core_budget;
+  int _free_cores;
+  double _mean_cost;
+  tools::Mutex _core_mutex;
+
+  std::map<std::string, int> _funcs_per_element;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif  // __VOTCA_XTP_JOBSTORECALC_H
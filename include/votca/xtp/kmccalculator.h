@@ -38,7 +38,9 @@
 #include <votca/xtp/chargecarrier.h>
 
 #include <votca/ctp/qmcalculator.h>
+#include <votca/xtp/eigen.h>
 #include <votca/xtp/gnode.h>
+#include <votca/xtp/kmcgraph.h>
 using namespace std;
 
 namespace votca {
@@ -60,23 +62,46 @@ class KMCCalculator : public ctp::QMCalculator {
   int StringtoCarriertype(std::string name);
 
   void LoadGraph(ctp::Topology* top);
+  void BuildGraph();
   virtual void RunVSSM(ctp::Topology* top){};
   void InitialRates();
+  void BuildRateTable();
+  Eigen::ArrayXd CalculateRates(double temperature,
+                                const tools::vec& field) const;
+  int UpdateRates(const Eigen::ArrayXd& rates);
 
   double Promotetime(double cumulated_rate);
   void ResetForbiddenlist(std::vector<int>& forbiddenid);
   void AddtoForbiddenlist(int id, std::vector<int>& forbiddenid);
   bool CheckForbidden(int id, const std::vector<int>& forbiddenlist);
-  bool CheckSurrounded(GNode* node, const std::vector<int>& forbiddendests);
-  GLink* ChooseHoppingDest(GNode* node);
+  bool CheckSurrounded(int node, const std::vector<int>& forbiddendests);
+  int ChooseHoppingDest(int node);
   Chargecarrier* ChooseAffectedCarrier(double cumulated_rate);
 
   void RandomlyCreateCharges();
   void RandomlyAssignCarriertoSite(Chargecarrier* Charge);
-  void AddtoJumplengthdistro(const GLink* event, double dt);
+  void AddtoJumplengthdistro(int event, double dt);
   void PrintJumplengthdistro();
+  // nodes are only used to assemble the graph, the run works on _graph
   std::vector<GNode*> _nodes;
+  KMCGraph _graph;
   std::vector<Chargecarrier*> _carriers;
+
+  // temperature and field independent data of all hopping events, so that
+  // rates can be recomputed without going through the nodes, event is the
+  // index into the event arrays of _graph
+  struct RateTable {
+    std::vector<int> node;
+    std::vector<int> event;
+    Eigen::ArrayXd reorg;
+    Eigen::ArrayXd dG_Site;
+    Eigen::ArrayXd J2;
+    Eigen::ArrayXd drx;
+    Eigen::ArrayXd dry;
+    Eigen::ArrayXd drz;
+  };
+  RateTable _ratetable;
+
   tools::Random2 _RandomVariable;
 
   std::string _injection_name;
@@ -94,6 +119,10 @@ class KMCCalculator : public ctp::QMCalculator {
 
   double _temperature;
   std::string _rates;
+
+  // progress output of a run, each worker of a parallel sweep points it to
+  // its own file
+  std::ostream* _log = &std::cout;
 };
 
 }  // namespace xtp
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_KMC_GRAPH_H
+#define _VOTCA_KMC_GRAPH_H
+
+#include <vector>
+#include <votca/tools/vec.h>
+#include <votca/xtp/gnode.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief Flat (CSR) layout of the hopping graph used during a KMC run
+ *
+ * The events of node i are the entries [EventsBegin(i), EventsEnd(i)) of the
+ * event arrays. Destinations, rates, dr vectors and the normalised cumulative
+ * rates of a node are contiguous, so choosing a hop is a binary search in one
+ * cache line instead of a walk through a pointer linked tree. Nodes and
+ * events are addressed by index, node index and node id are identical.
+ * Decay events have destination -1.
+ */
+class KMCGraph {
+ public:
+  KMCGraph(){};
+  explicit KMCGraph(const std::vector<GNode*>& nodes);
+
+  int NumberofNodes() const { return int(_escape_rate.size()); }
+  int NumberofEvents() const { return int(_destination.size()); }
+
+  int EventsBegin(int node) const { return _offsets[node]; }
+  int EventsEnd(int node) const { return _offsets[node + 1]; }
+
+  int Destination(int event) const { return _destination[event]; }
+  bool isDecay(int event) const { return _destination[event] < 0; }
+  double Rate(int event) const { return _rate[event]; }
+  void setRate(int event, double rate) { _rate[event] = rate; }
+  const tools::vec& dr(int event) const { return _dr[event]; }
+  double Jeff2(int event) const { return _Jeff2[event]; }
+  double ReorgOut(int event) const { return _reorg_out[event]; }
+
+  double EscapeRate(int node) const { return _escape_rate[node]; }
+  const tools::vec& Position(int node) const { return _position[node]; }
+  double SiteEnergy(int node) const { return _siteenergy[node]; }
+  double ReorgIntOrig(int node) const { return _reorg_intorig[node]; }
+  double ReorgIntDest(int node) const { return _reorg_intdest[node]; }
+  bool isInjectable(int node) const { return _injectable[node]; }
+  bool hasDecay(int node) const { return _hasdecay[node]; }
+
+  bool isOccupied(int node) const { return _occupied[node]; }
+  void setOccupied(int node, bool occupied) { _occupied[node] = occupied; }
+  double OccupationTime(int node) const { return _occupationtime[node]; }
+  void AddOccupationTime(int node, double dt) { _occupationtime[node] += dt; }
+  void ResetOccupation();
+
+  /// recalculates escape rate and cumulative table after rates changed
+  void UpdateNode(int node);
+
+  /// returns the event of node for p in (0,1]
+  int FindHoppingDestination(int node, double p) const;
+
+ private:
+  std::vector<int> _offsets;
+
+  // hot event data, touched for every hop
+  std::vector<int> _destination;
+  std::vector<double> _cumulative;
+  std::vector<tools::vec> _dr;
+  std::vector<double> _rate;
+  // only needed to recalculate rates
+  std::vector<double> _Jeff2;
+  std::vector<double> _reorg_out;
+
+  std::vector<double> _escape_rate;
+  std::vector<char> _occupied;
+  std::vector<double> _occupationtime;
+  std::vector<tools::vec> _position;
+  std::vector<double> _siteenergy;
+  std::vector<double> _reorg_intorig;
+  std::vector<double> _reorg_intdest;
+  std::vector<char> _injectable;
+  std::vector<char> _hasdecay;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif /* _VOTCA_KMC_GRAPH_H */
@@ -26,6 +26,9 @@ namespace votca {
 namespace xtp {
 typedef boost::multi_array<double, 3> tensor3d;
 typedef boost::multi_array<double, 4> tensor4d;
+// views on external storage, e.g. from the ScratchArena
+typedef boost::multi_array_ref<double, 3> tensor3d_ref;
+typedef boost::multi_array_ref<double, 4> tensor4d_ref;
 
 typedef boost::multi_array_types::extent_range range;  //////////////////
 typedef tensor3d::index index3d;                       /////////////////////
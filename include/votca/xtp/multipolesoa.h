@@ -0,0 +1,75 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_XTP_MULTIPOLESOA_H
+#define _VOTCA_XTP_MULTIPOLESOA_H
+
+#include <vector>
+#include <votca/tools/vec.h>
+
+namespace votca {
+namespace ctp {
+class APolarSite;
+}
+namespace xtp {
+
+/**
+ * \brief Static multipoles of a set of sites as structure of arrays
+ *
+ * Holds positions, charges, dipoles and traceless cartesian quadrupoles
+ * (Buckingham convention, Q20=Qzz) of the sites in separate contiguous
+ * arrays, so that the site-site sum of the static interaction energy
+ * vectorises over the sites of the second set. The energy is the same as
+ * the undamped permanent energy of ctp::XInteractor::E_f summed over all
+ * site pairs.
+ */
+class MultipoleSoA {
+ public:
+  MultipoleSoA(){};
+  /// uses the multipoles of the current state of the sites
+  explicit MultipoleSoA(const std::vector<ctp::APolarSite*>& sites);
+
+  /// Q2 are the spherical components Q20,Q21c,Q21s,Q22c,Q22s
+  void Add(const tools::vec& pos, double Q00, const tools::vec& Q1,
+           const std::vector<double>& Q2);
+
+  int size() const { return int(_q.size()); }
+
+  /// static interaction energy with other, whose sites are shifted by shift
+  double InteractionEnergy(const MultipoleSoA& other,
+                           const tools::vec& shift) const;
+
+ private:
+  std::vector<double> _x;
+  std::vector<double> _y;
+  std::vector<double> _z;
+  std::vector<double> _q;
+  std::vector<double> _dx;
+  std::vector<double> _dy;
+  std::vector<double> _dz;
+  std::vector<double> _qxx;
+  std::vector<double> _qxy;
+  std::vector<double> _qxz;
+  std::vector<double> _qyy;
+  std::vector<double> _qyz;
+  std::vector<double> _qzz;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif /* _VOTCA_XTP_MULTIPOLESOA_H */
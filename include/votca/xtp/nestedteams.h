@@ -0,0 +1,58 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_XTP_NESTEDTEAMS_H
+#define __VOTCA_XTP_NESTEDTEAMS_H
+
+#include <votca/xtp/votca_config.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief Enables nested OpenMP teams for the lifetime of the object
+ *
+ * omp_set_nested changes the setting for the whole process. The guard
+ * restores the previous setting when it goes out of scope, also when an
+ * exception leaves the scope, so later OpenMP regions do not nest.
+ */
+class NestedTeams {
+ public:
+  explicit NestedTeams(bool enable = true) {
+#ifdef _OPENMP
+    _previous = omp_get_nested();
+    if (enable) omp_set_nested(1);
+#endif
+  }
+  ~NestedTeams() {
+#ifdef _OPENMP
+    omp_set_nested(_previous);
+#endif
+  }
+
+ private:
+  NestedTeams(const NestedTeams&) = delete;
+  NestedTeams& operator=(const NestedTeams&) = delete;
+  int _previous = 0;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif  // __VOTCA_XTP_NESTEDTEAMS_H
@@ -0,0 +1,74 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_XTP_ORBITALSCACHE_H
+#define __VOTCA_XTP_ORBITALSCACHE_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <votca/tools/mutex.h>
+#include <votca/xtp/orbitals.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief Least recently used cache of orbitals read from checkpoint files
+ *
+ * Keeps up to capacity orbitals in memory, so that the monomer orbitals of
+ * a segment are read once for all pair jobs it takes part in, as long as
+ * they are close enough in the job order. The cached orbitals are shared
+ * and must not be modified. Get may be called from several threads, files
+ * are read outside the lock.
+ */
+class OrbitalsCache {
+ public:
+  explicit OrbitalsCache(int capacity = 0) : _capacity(capacity) {}
+
+  void setCapacity(int capacity);
+
+  /// orbitals of the checkpoint file, which is only read if not cached
+  std::shared_ptr<const Orbitals> Get(const std::string& filename);
+
+  int size();
+
+  int Hits() const { return _hits; }
+  int Misses() const { return _misses; }
+
+ private:
+  typedef std::list<std::pair<std::string, std::shared_ptr<const Orbitals> > >
+      LRUList;
+
+  void Evict();
+
+  // most recently used first
+  LRUList _lru;
+  std::map<std::string, LRUList::iterator> _index;
+  int _capacity;
+  int _hits = 0;
+  int _misses = 0;
+  tools::Mutex _mutex;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif  // __VOTCA_XTP_ORBITALSCACHE_H
@@ -0,0 +1,72 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_XTP_OUTOFCOREARRAY_H
+#define __VOTCA_XTP_OUTOFCOREARRAY_H
+
+#include <boost/interprocess/interprocess_fwd.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <votca/xtp/eigen.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief Zero initialized array which lives in memory or, if it is larger
+ * than a memory limit, in a memory mapped scratch file
+ *
+ * The scratch file is removed as soon as it is mapped, so it disappears with
+ * the process. Out of core the kernel moves the data between the page cache
+ * and the file. Prefetch and Release tell it which parts are used next and
+ * which are done, so only those in use occupy memory. In memory both do
+ * nothing.
+ */
+class OutOfCoreArray {
+ public:
+  OutOfCoreArray();
+  ~OutOfCoreArray();
+
+  /// max_memory in bytes, 0 keeps every size in memory
+  void Allocate(std::size_t size, std::size_t max_memory,
+                const std::string& directory);
+
+  real_gwbse* data() { return _data; }
+  const real_gwbse* data() const { return _data; }
+  std::size_t size() const { return _size; }
+  bool isOutOfCore() const { return bool(_region); }
+
+  void Prefetch(std::size_t start, std::size_t size) const;
+  void Release(std::size_t start, std::size_t size) const;
+
+ private:
+  void Advise(std::size_t start, std::size_t size, int advice) const;
+
+  std::vector<real_gwbse> _memory;
+  std::unique_ptr<boost::interprocess::mapped_region> _region;
+  real_gwbse* _data = nullptr;
+  std::size_t _size = 0;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif  // __VOTCA_XTP_OUTOFCOREARRAY_H
@@ -42,6 +42,14 @@ class QMDatabase : public Database {
    * All tables and triggers should be added here.
    */
   void onCreate();
+
+  /**
+   * \brief Create the secondary indices of the state file
+   *
+   * Indices are created only if missing, so this can also be used to
+   * upgrade state files written by older versions.
+   */
+  void CreateIndices();
 };
 
 }  // namespace xtp
@@ -45,6 +45,9 @@ class QMMachine {
 
   void setLog(ctp::Logger *log) { _log = log; }
 
+  /// OpenMP threads of the GW-BSE runs, 0 keeps the gwbse openmp option
+  void setThreads(int threads) { _threads = threads; }
+
  private:
   bool Iterate(string jobFolder, int iterCnt);
   bool RunDFT(
@@ -60,6 +63,7 @@ class QMMachine {
   ctp::XInductor *_xind;
   QMPackage *_qmpack;
   ctp::Logger *_log;
+  int _threads = 0;
 
   std::vector<QMMIter *> _iters;
   bool _isConverged;
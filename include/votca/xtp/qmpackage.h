@@ -45,6 +45,9 @@ class QMPackage {
 
   virtual std::string getPackageName() = 0;
 
+  /// copy of the package with all options, e.g. to run it in another folder
+  virtual QMPackage* Clone() const = 0;
+
   virtual void Initialize(tools::Property& options) = 0;
 
   /// writes a coordinate file WITHOUT taking into account PBCs
@@ -58,11 +61,20 @@ class QMPackage {
 
   virtual void CleanUp() = 0;
 
+  /// whether RunInMemory is available, i.e. the package runs in this process
+  virtual bool SupportsInMemory() const { return false; }
+
+  /// does WriteInputFile, Run, ParseLogFile and ParseOrbitalsFile at once,
+  /// without writing or reading any files
+  virtual bool RunInMemory(Orbitals& orbitals) { return false; }
+
   void setMultipoleBackground(
       std::vector<std::shared_ptr<ctp::PolarSeg> > PolarSegments);
 
   void setRunDir(const std::string& run_dir) { _run_dir = run_dir; }
 
+  const std::string& getRunDir() const { return _run_dir; }
+
   void setInputFileName(const std::string& input_file_name) {
     _input_file_name = input_file_name;
   }
@@ -77,7 +89,9 @@ class QMPackage {
 
   void setLog(ctp::Logger* pLog) { _pLog = pLog; }
 
-  bool GuessRequested() { return _write_guess; }
+  bool GuessRequested() { return _use_guess; }
+
+  void setUseGuess(bool use_guess) { _use_guess = use_guess; }
 
   bool ECPRequested() { return _write_pseudopotentials; }
 
@@ -140,7 +154,8 @@ class QMPackage {
   bool _get_overlap;
   bool _get_charges;
 
-  bool _write_guess;
+  // start the SCF from the MOs of the orbitals passed to WriteInputFile
+  bool _use_guess;
   bool _write_charges;
   bool _write_basis_set;
   bool _write_pseudopotentials;
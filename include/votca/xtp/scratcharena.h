@@ -0,0 +1,98 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_XTP_SCRATCHARENA_H
+#define __VOTCA_XTP_SCRATCHARENA_H
+
+#include <cstddef>
+#include <vector>
+#include <votca/xtp/multiarray.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief Per thread stack of scratch memory for the integral kernels
+ *
+ * The kernels need temporary arrays for every shell pair, triple or quartet,
+ * which made the heap allocator a point of contention inside the OpenMP
+ * loops. The arena hands out memory from a few large blocks, which are kept
+ * for the lifetime of the thread and grow to the largest combination of
+ * angular momenta and contractions seen so far. Memory is released in stack
+ * order by a Frame:
+ *
+ *   ScratchArena::Frame frame;
+ *   tensor3d_ref R = frame.Tensor3D(n1, n2, n3);
+ *
+ */
+class ScratchArena {
+ public:
+  // arena of the calling thread
+  static ScratchArena& Instance();
+
+  // zero initialised memory for size doubles, valid until the enclosing
+  // Frame is destroyed
+  double* Allocate(std::size_t size);
+
+  tensor3d_ref Tensor3D(int n1, int n2, int n3) {
+    return tensor3d_ref(Allocate(std::size_t(n1) * n2 * n3),
+                        boost::extents[n1][n2][n3]);
+  }
+
+  tensor4d_ref Tensor4D(int n1, int n2, int n3, int n4) {
+    return tensor4d_ref(Allocate(std::size_t(n1) * n2 * n3 * n4),
+                        boost::extents[n1][n2][n3][n4]);
+  }
+
+  // number of doubles held by the arena
+  std::size_t Capacity() const;
+
+  class Frame {
+   public:
+    Frame() : _arena(ScratchArena::Instance()), _mark(_arena._top) {}
+    ~Frame() { _arena._top = _mark; }
+
+    double* Allocate(std::size_t size) { return _arena.Allocate(size); }
+    tensor3d_ref Tensor3D(int n1, int n2, int n3) {
+      return _arena.Tensor3D(n1, n2, n3);
+    }
+    tensor4d_ref Tensor4D(int n1, int n2, int n3, int n4) {
+      return _arena.Tensor4D(n1, n2, n3, n4);
+    }
+
+   private:
+    Frame(const Frame&) = delete;
+    Frame& operator=(const Frame&) = delete;
+    ScratchArena& _arena;
+    std::size_t _mark;
+  };
+
+ private:
+  ScratchArena() : _top(0) {}
+
+  std::vector<std::vector<double> > _blocks;
+  // blocks are used one after the other, _top counts the doubles handed out
+  // including the unused tails of the blocks before the current one
+  std::size_t _top;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif  // __VOTCA_XTP_SCRATCHARENA_H
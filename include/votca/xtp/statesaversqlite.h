@@ -31,11 +31,13 @@ namespace xtp {
 
 class StateSaverSQLite {
  public:
-  StateSaverSQLite(){};
+  StateSaverSQLite() : _use_snapshot(false){};
   ~StateSaverSQLite() { _db.Close(); }
 
   void Open(ctp::Topology &qmtop, const std::string &file, bool lock = true);
   void Close() { _db.Close(); }
+  // read frames from (and create) binary topology snapshots next to the file
+  void UseSnapshot(bool use) { _use_snapshot = use; }
   bool NextFrame();
 
   void WriteFrame();
@@ -48,6 +50,9 @@ class StateSaverSQLite {
   void WritePairs(bool update);
   void WriteSuperExchange(bool update);
 
+  bool UpdateSegments();
+  bool UpdatePairs();
+
   void ReadFrame();
   void ReadMeta(int topId);
   void ReadMolecules(int topId);
@@ -66,6 +71,23 @@ class StateSaverSQLite {
   void UnlockStateFile();
 
  private:
+  struct Column {
+    std::string name;
+    bool isInt;
+  };
+
+  static const std::vector<Column> &SegmentColumns();
+  static const std::vector<Column> &PairColumns();
+  std::vector<double> SegmentRow(ctp::Segment *seg) const;
+  std::vector<double> PairRow(ctp::QMPair *pair) const;
+  void SnapshotSegments();
+  void SnapshotPairs();
+  int UpdateColumns(const std::string &table,
+                    const std::vector<Column> &columns, int firstcol,
+                    const std::vector<int> &ids,
+                    const std::vector<std::vector<double> > &rows,
+                    std::vector<std::vector<double> > &snapshot);
+
   ctp::Topology *_qmtop;
   QMDatabase _db;
 
@@ -76,6 +98,12 @@ class StateSaverSQLite {
 
   std::string _sqlfile;
   bool _was_read;
+  bool _use_snapshot;
+
+  // column values of segments and pairs as they are stored in the state file,
+  // so that an update only touches the columns a calculator has changed
+  std::vector<std::vector<double> > _seg_snapshot;
+  std::vector<std::vector<double> > _pair_snapshot;
 
   boost::interprocess::file_lock *_flock;
 };
@@ -25,6 +25,7 @@
 #include <votca/xtp/eigen.h>
 #include <votca/xtp/multiarray.h>
 #include <votca/xtp/orbitals.h>
+#include <votca/xtp/outofcorearray.h>
 #include <votca/xtp/symmetric_matrix.h>
 
 /**
@@ -48,7 +49,7 @@ class TCMatrix {
   int _removedfunctions = 0;
   Eigen::MatrixXd _inv_sqrt;
 
-  bool FillThreeCenterRepBlock(tensor3d& threec_block, const AOShell* shell,
+  bool FillThreeCenterRepBlock(tensor3d_ref& threec_block, const AOShell* shell,
                                const AOShell* shell_row,
                                const AOShell* shell_col);
 };
@@ -57,26 +58,78 @@ class TCMatrix_dft : public TCMatrix {
  public:
   void Fill(const AOBasis& auxbasis, const AOBasis& dftbasis);
 
-  int size() const { return _matrix.size(); }
+  // number of aux functions
+  int size() const { return _auxsize; }
 
-  Symmetric_Matrix& operator[](int i) { return _matrix[i]; }
+  // Shell pairs whose largest primitive overlap is below threshold are not
+  // stored, so memory scales with N * N_aux instead of N^2 * N_aux for
+  // extended systems. Has to be set before Fill.
+  void setPairScreening(double threshold) { _pair_threshold = threshold; }
+  int SignificantPairs() const { return _pairs.size(); }
 
-  const Symmetric_Matrix& operator[](int i) const { return _matrix[i]; }
+  // Fill stores the integrals in float only, which halves memory and the
+  // memory traffic of the contractions below at float accuracy, e.g. for the
+  // first SCF iterations. Has to be set before Fill.
+  void setSinglePrecision(bool single) { _single_precision = single; }
+  bool isSinglePrecision() const { return _single_precision; }
+  // recomputes the integrals in double and frees the float ones, only works
+  // if the basis objects of Fill still exist
+  void RefillDouble();
+
+  // (mn|P) for aux function P as a full symmetric matrix
+  Eigen::MatrixXd FullMatrix(int aux) const;
+  Eigen::MatrixXf FullMatrixFloat(int aux) const;
+
+  // J_mn = sum_P (mn|P) sum_kl (P|kl) D_kl, accumulated in double
+  Eigen::MatrixXd ContractDensity(const Eigen::MatrixXd& dmat) const;
 
  private:
-  std::vector<Symmetric_Matrix> _matrix;
+  // shell pair with row >= col and the first row of its functions in
+  // _matrix, stored as row_function * ncol + col_function
+  struct ShellPair {
+    const AOShell* row;
+    const AOShell* col;
+    int offset;
+  };
+  std::vector<ShellPair> _pairs;
+  int _dftbasissize = 0;
+  int _auxsize = 0;
+  double _pair_threshold = 1e-10;
+  bool _single_precision = false;
+  const AOBasis* _auxbasis = nullptr;
+
+  // rows: functions of significant shell pairs, cols: aux functions
+  Eigen::MatrixXd _matrix;
+  // the same in single precision, _matrix is then empty
+  Eigen::MatrixXf _matrix_float;
+
+  int PairFunctions() const;
+  void FillMatrix(const AOBasis& auxbasis);
+
+  template <typename T>
+  Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> FullMatrix(
+      const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& matrix,
+      int aux) const;
+
+  // result = M^T d and result = M c for the rows [start, start + size)
+  Eigen::VectorXd ContractRows(const Eigen::VectorXd& dpacked, int start,
+                               int size) const;
+  Eigen::VectorXd ExpandRows(const Eigen::VectorXd& coeff, int start,
+                             int size) const;
 
-  void FillBlock(std::vector<Eigen::MatrixXd>& block, int shellindex,
-                 const AOBasis& dftbasis, const AOBasis& auxbasis);
+  bool isSignificant(const AOShell* shell_row, const AOShell* shell_col) const;
+
+  void FillBlock(Eigen::MatrixXd& block, const ShellPair& pair,
+                 const AOBasis& auxbasis);
 };
 
 class TCMatrix_gwbse : public TCMatrix {
  public:
-  // returns one level as a constant reference
-  const MatrixXfd& operator[](int i) const { return _matrix[i]; }
-
-  // returns one level as a reference
-  MatrixXfd& operator[](int i) { return _matrix[i]; }
+  // returns one level, a nsize x auxsize matrix
+  Eigen::Map<const MatrixXfd> operator[](int i) const {
+    return Eigen::Map<const MatrixXfd>(_matrix.data() + i * _levelstride,
+                                       _ntotal, _basissize);
+  }
   // returns auxbasissize
   int auxsize() const { return _basissize; }
 
@@ -100,11 +153,50 @@ class TCMatrix_gwbse : public TCMatrix {
   // still exist
   void Rebuild() { Fill(*_auxbasis, *_dftbasis, *_dft_orbitals); }
 
+  // AuxMatrix may have fewer columns than rows, which shrinks the aux space
   void MultiplyRightWithAuxMatrix(const Eigen::MatrixXd& AuxMatrix);
 
+  // With a tolerance > 0 Fill truncates the aux space to the eigenvectors of
+  // sum_m M_m^T M_m, dropping eigenvalues which sum to at most tolerance x
+  // trace. All users only contract over the aux index, so they are
+  // invariant under this rotation and work on the smaller matrices.
+  // The eigenvectors need the full tensor, so Fill compresses after it has
+  // built all levels: the peak memory of Fill does not shrink, only the
+  // memory and time of RPA, sigma and BSE afterwards.
+  void setCompression(double tolerance) { _compression = tolerance; }
+  int Compressedfunctions() const { return _compressedfunctions; }
+
+  // If the levels need more than max_memory bytes, Initialize puts them into
+  // a memory mapped scratch file in directory, into which Fill writes the
+  // transformed integrals of one aux shell after the other. 0 means no limit.
+  void setOutOfCore(std::size_t max_memory, const std::string& directory) {
+    _max_memory = max_memory;
+    _scratch_directory = directory;
+  }
+  bool isOutOfCore() const { return _matrix.isOutOfCore(); }
+
+  // Level i is read soon or not for a while, only a hint out of core
+  void Prefetch(int i) const {
+    _matrix.Prefetch(std::size_t(i) * _levelstride, _levelstride);
+  }
+  void Release(int i) const {
+    _matrix.Release(std::size_t(i) * _levelstride, _levelstride);
+  }
+
  private:
-  // store vector of matrices
-  std::vector<MatrixXfd> _matrix;
+  void Compress();
+
+  Eigen::Map<MatrixXfd> Level(int i) {
+    return Eigen::Map<MatrixXfd>(_matrix.data() + i * _levelstride, _ntotal,
+                                 _basissize);
+  }
+
+  // the levels one after the other, each with room for nsize x auxsize
+  // entries as at Initialize, so that the aux space can shrink in place
+  OutOfCoreArray _matrix;
+  std::size_t _levelstride = 0;
+  std::size_t _max_memory = 0;
+  std::string _scratch_directory = ".";
 
   // band summation indices
   int _mmin;
@@ -115,12 +207,15 @@ class TCMatrix_gwbse : public TCMatrix {
   int _mtotal;
   int _basissize;
 
+  double _compression = 0.0;
+  int _compressedfunctions = 0;
+
   const AOBasis* _auxbasis = nullptr;
   const AOBasis* _dftbasis = nullptr;
   const Eigen::MatrixXd* _dft_orbitals = nullptr;
 
-  void FillBlock(std::vector<Eigen::MatrixXd>& matrix, const AOShell* auxshell,
-                 const AOBasis& dftbasis, const Eigen::MatrixXd& dft_orbitals);
+  void FillBlock(const AOShell* auxshell, const AOBasis& dftbasis,
+                 const Eigen::MatrixXd& dft_orbitals);
 };
 
 }  // namespace xtp
@@ -0,0 +1,61 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_XTP_TOPOLOGYSNAPSHOT_H
+#define __VOTCA_XTP_TOPOLOGYSNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <votca/ctp/topology.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief Binary sidecar of one frame of the sqlite state file
+ *
+ * The snapshot stores molecules, segment types, segments, fragments, atoms
+ * and pairs of a topology as flat arrays of fixed size records plus a string
+ * table. It is read through a memory mapping, so that many processes on a
+ * node share it through the page cache. The snapshot carries a checksum of
+ * the sqlite header, which changes whenever the state file is modified, and
+ * is ignored if it does not match the state file anymore.
+ */
+class TopologySnapshot {
+ public:
+  TopologySnapshot(const std::string& sqlfile, int topId);
+
+  const std::string& getFileName() const { return _snapfile; }
+
+  /// returns false if no valid snapshot exists, qmtop is untouched then
+  bool Read(ctp::Topology& qmtop) const;
+  void Write(ctp::Topology& qmtop) const;
+
+ private:
+  std::uint64_t StateFileChecksum() const;
+
+  std::string _sqlfile;
+  std::string _snapfile;
+  int _topId;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif /* __VOTCA_XTP_TOPOLOGYSNAPSHOT_H */
@@ -18,7 +18,7 @@
  */
 
 #include <votca/xtp/ERIs.h>
-#include <votca/xtp/symmetric_matrix.h>
+#include <votca/xtp/scratcharena.h>
 
 namespace votca {
 namespace xtp {
@@ -41,37 +41,7 @@ void ERIs::Initialize_4c_screening(AOBasis& dftbasis, double eps) {
 }
 
 void ERIs::CalculateERIs(const Eigen::MatrixXd& DMAT) {
-
-  int nthreads = 1;
-#ifdef _OPENMP
-  nthreads = omp_get_max_threads();
-#endif
-  std::vector<Eigen::MatrixXd> ERIS_thread;
-
-  for (int i = 0; i < nthreads; ++i) {
-    Eigen::MatrixXd thread = Eigen::MatrixXd::Zero(DMAT.rows(), DMAT.cols());
-    ERIS_thread.push_back(thread);
-  }
-
-#pragma omp parallel for
-  for (int thread = 0; thread < nthreads; ++thread) {
-    Symmetric_Matrix dmat_sym = Symmetric_Matrix(DMAT);
-    for (int i = thread; i < _threecenter.size(); i += nthreads) {
-      const Symmetric_Matrix& threecenter = _threecenter[i];
-      // Trace over prod::DMAT,I(l)=componentwise product over
-      const double factor = threecenter.TraceofProd(dmat_sym);
-      Eigen::SelfAdjointView<Eigen::MatrixXd, Eigen::Upper> m =
-          ERIS_thread[thread].selfadjointView<Eigen::Upper>();
-      threecenter.AddtoEigenUpperMatrix(m, factor);
-    }
-  }
-
-  _ERIs = Eigen::MatrixXd::Zero(DMAT.rows(), DMAT.cols());
-  for (const auto& thread : ERIS_thread) {
-    _ERIs += thread;
-  }
-  _ERIs += _ERIs.triangularView<Eigen::StrictlyUpper>().transpose();
-
+  _ERIs = _threecenter.ContractDensity(DMAT);
   CalculateEnergy(DMAT);
   return;
 }
@@ -89,13 +59,20 @@ void ERIs::CalculateEXX(const Eigen::MatrixXd& DMAT) {
     EXX_thread.push_back(thread);
   }
 
+  const bool single = isSinglePrecision();
 #pragma omp parallel for
   for (int thread = 0; thread < nthreads; ++thread) {
     Eigen::MatrixXd D = DMAT;
+    Eigen::MatrixXf D_float = DMAT.cast<float>();
     for (int i = thread; i < _threecenter.size(); i += nthreads) {
-      const Eigen::MatrixXd threecenter = _threecenter[i].UpperMatrix();
-      EXX_thread[thread] += threecenter.selfadjointView<Eigen::Upper>() * D *
-                            threecenter.selfadjointView<Eigen::Upper>();
+      if (single) {
+        const Eigen::MatrixXf threecenter = _threecenter.FullMatrixFloat(i);
+        EXX_thread[thread] +=
+            (threecenter * D_float * threecenter).cast<double>();
+      } else {
+        const Eigen::MatrixXd threecenter = _threecenter.FullMatrix(i);
+        EXX_thread[thread] += threecenter * D * threecenter;
+      }
     }
   }
   _EXXs = Eigen::MatrixXd::Zero(DMAT.rows(), DMAT.cols());
@@ -121,14 +98,21 @@ void ERIs::CalculateEXX(const Eigen::Block<Eigen::MatrixXd>& occMos,
     EXX_thread.push_back(thread);
   }
 
+  const bool single = isSinglePrecision();
 #pragma omp parallel for
   for (int thread = 0; thread < nthreads; ++thread) {
     Eigen::MatrixXd occ = occMos;
+    Eigen::MatrixXf occ_float = occ.cast<float>();
     for (int i = thread; i < _threecenter.size(); i += nthreads) {
-      const Eigen::MatrixXd TCxMOs_T =
-          occ.transpose() *
-          _threecenter[i].UpperMatrix().selfadjointView<Eigen::Upper>();
-      EXX_thread[thread] += TCxMOs_T.transpose() * TCxMOs_T;
+      if (single) {
+        const Eigen::MatrixXf TCxMOs_T =
+            occ_float.transpose() * _threecenter.FullMatrixFloat(i);
+        EXX_thread[thread] += (TCxMOs_T.transpose() * TCxMOs_T).cast<double>();
+      } else {
+        const Eigen::MatrixXd TCxMOs_T =
+            occ.transpose() * _threecenter.FullMatrix(i);
+        EXX_thread[thread] += TCxMOs_T.transpose() * TCxMOs_T;
+      }
     }
   }
   _EXXs = Eigen::MatrixXd::Zero(occMos.rows(), occMos.rows());
@@ -247,8 +231,6 @@ void ERIs::CalculateEXX_4c_small_molecule(const Eigen::MatrixXd& DMAT) {
 void ERIs::CalculateERIs_4c_direct(const AOBasis& dftbasis,
                                    const Eigen::MatrixXd& DMAT) {
 
-  tensor4d::extent_gen extents;
-
   // Number of shells
   int numShells = dftbasis.getNumofShells();
 
@@ -281,17 +263,9 @@ void ERIs::CalculateERIs_4c_direct(const AOBasis& dftbasis,
               continue;
 
             // Get the current 4c block
-            tensor4d block(extents[range(0, numFunc_1)][range(0, numFunc_2)]
-                                  [range(0, numFunc_3)][range(0, numFunc_4)]);
-            for (int i = 0; i < numFunc_1; ++i) {
-              for (int j = 0; j < numFunc_2; ++j) {
-                for (int k = 0; k < numFunc_3; ++k) {
-                  for (int l = 0; l < numFunc_4; ++l) {
-                    block[i][j][k][l] = 0.0;
-                  }
-                }
-              }
-            }
+            ScratchArena::Frame scratch;
+            tensor4d_ref block =
+                scratch.Tensor4D(numFunc_1, numFunc_2, numFunc_3, numFunc_4);
             bool nonzero = _fourcenter.FillFourCenterRepBlock(
                 block, &shell_1, &shell_2, &shell_3, &shell_4);
 
@@ -323,8 +297,8 @@ void ERIs::CalculateERIs_4c_direct(const AOBasis& dftbasis,
             if (iShell_1 != iShell_3) {
 
               // We need the 'transpose' of block
-              tensor4d block2(extents[range(0, numFunc_3)][range(
-                  0, numFunc_4)][range(0, numFunc_1)][range(0, numFunc_2)]);
+              tensor4d_ref block2 =
+                  scratch.Tensor4D(numFunc_3, numFunc_4, numFunc_1, numFunc_2);
               for (int i = 0; i < numFunc_1; ++i) {
                 for (int j = 0; j < numFunc_2; ++j) {
                   for (int k = 0; k < numFunc_3; ++k) {
@@ -376,7 +350,7 @@ void ERIs::CalculateERIs_4c_direct(const AOBasis& dftbasis,
 }
 
 void ERIs::FillERIsBlock(Eigen::MatrixXd& ERIsCur, const Eigen::MatrixXd& DMAT,
-                         const tensor4d& block, const AOShell& shell_1,
+                         const tensor4d_ref& block, const AOShell& shell_1,
                          const AOShell& shell_2, const AOShell& shell_3,
                          const AOShell& shell_4) {
 
@@ -416,8 +390,6 @@ void ERIs::FillERIsBlock(Eigen::MatrixXd& ERIsCur, const Eigen::MatrixXd& DMAT,
 
 void ERIs::CalculateERIsDiagonals(const AOBasis& dftbasis) {
 
-  tensor4d::extent_gen extents;
-
   // Number of shells
   int numShells = dftbasis.getNumofShells();
   // Total number of functions
@@ -433,17 +405,9 @@ void ERIs::CalculateERIsDiagonals(const AOBasis& dftbasis) {
       int numFunc_2 = shell_2.getNumFunc();
 
       // Get the current 4c block
-      tensor4d block(extents[range(0, numFunc_1)][range(0, numFunc_2)]
-                            [range(0, numFunc_1)][range(0, numFunc_2)]);
-      for (int i = 0; i < numFunc_1; ++i) {
-        for (int j = 0; j < numFunc_2; ++j) {
-          for (int k = 0; k < numFunc_1; ++k) {
-            for (int l = 0; l < numFunc_2; ++l) {
-              block[i][j][k][l] = 0.0;
-            }
-          }
-        }
-      }
+      ScratchArena::Frame scratch;
+      tensor4d_ref block =
+          scratch.Tensor4D(numFunc_1, numFunc_2, numFunc_1, numFunc_2);
       bool nonzero = _fourcenter.FillFourCenterRepBlock(
           block, &shell_1, &shell_2, &shell_1, &shell_2);
 
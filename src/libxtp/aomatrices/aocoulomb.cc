@@ -19,23 +19,35 @@
 
 #include <vector>
 #include <votca/xtp/aobasis.h>
+#include <votca/xtp/aokerneltable.h>
 #include <votca/xtp/aomatrix.h>
+#include <votca/xtp/boysfunction.h>
 
 namespace votca {
 namespace xtp {
 
-void AOCoulomb::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
-                          const AOShell* shell_row, const AOShell* shell_col) {
+namespace {
+
+template <int LROW, int LCOL>
+struct CoulombKernel {
+  static void Fill(Eigen::Block<Eigen::MatrixXd>& matrix,
+                   const AOShell* shell_row, const AOShell* shell_col);
+};
+
+template <int LROW, int LCOL>
+void CoulombKernel<LROW, LCOL>::Fill(Eigen::Block<Eigen::MatrixXd>& matrix,
+                                     const AOShell* shell_row,
+                                     const AOShell* shell_col) {
 
   // shell info, only lmax tells how far to go
-  const int lmax_row = shell_row->getLmax();
-  const int lmax_col = shell_col->getLmax();
+  constexpr int lmax_row = LROW;
+  constexpr int lmax_col = LCOL;
 
   // set size of internal block for recursion
-  int nrows = this->getBlockSize(lmax_row);
-  int ncols = this->getBlockSize(lmax_col);
-  const int mmax = lmax_row + lmax_col;
-  const int nextra = mmax + 1;
+  constexpr int nrows = AOBlockSize(lmax_row);
+  constexpr int ncols = AOBlockSize(lmax_col);
+  constexpr int mmax = lmax_row + lmax_col;
+  constexpr int nextra = mmax + 1;
 
   // get shell positions
   const tools::vec& pos_row = shell_row->getPos();
@@ -104,15 +116,7 @@ void AOCoulomb::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
       const double rdecay_col = 0.5 / decay_col;
       const double powfactor_col = itc->getPowfactor();
 
-      tensor3d cou(boost::extents[nrows][ncols][nextra]);
-
-      for (index3d i = 0; i != nrows; ++i) {
-        for (index3d j = 0; j != ncols; ++j) {
-          for (index3d k = 0; k != nextra; ++k) {
-            cou[i][j][k] = 0.0;
-          }
-        }
-      }
+      AOScratch3D<nrows, ncols, nextra> cou;
 
       const double decay = decay_row + decay_col;
       const double r_decay = 0.5 / decay;
@@ -146,7 +150,8 @@ void AOCoulomb::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
                    (decay_row * decay_col * sqrt(decay_row + decay_col));
       fak = fak * powfactor_col * powfactor_row;
 
-      const std::vector<double> FmT = XIntegrate(nextra, T);
+      double FmT[BoysFunction::MaxSize];
+      BoysFunction::Evaluate(nextra, T, FmT);
 
       // get initial data from FmT -> s-s element
       for (index3d i = 0; i != nextra; ++i) {
@@ -919,7 +924,7 @@ void AOCoulomb::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
       const std::vector<double>& contractions_col = itc->getContraction();
 
       // put cou[i][j][0] into eigen matrix
-      Eigen::MatrixXd coumat = Eigen::MatrixXd::Zero(nrows, ncols);
+      Eigen::Matrix<double, nrows, ncols> coumat;
       for (unsigned i = 0; i < coumat.rows(); i++) {
         for (unsigned j = 0; j < coumat.cols(); j++) {
           coumat(i, j) = cou[i][j][0];
@@ -1477,6 +1482,23 @@ void AOCoulomb::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
   return;
 }
 
+}  // namespace
+
+void AOCoulomb::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
+                          const AOShell* shell_row, const AOShell* shell_col) {
+  int lmax_row = shell_row->getLmax();
+  int lmax_col = shell_col->getLmax();
+  if (lmax_col > 6 || lmax_row > 6) {
+    std::cerr << "Orbitals higher than i are not yet implemented. This should "
+                 "not have happened!"
+              << std::flush;
+    exit(1);
+  }
+  AOKernelTable<CoulombKernel, 6>::get(lmax_row, lmax_col)(matrix, shell_row,
+                                                           shell_col);
+  return;
+}
+
 // This converts V into ((S-1/2 V S-1/2)-1/2 S-1/2)T, which is needed to
 // construct 4c integrals,
 Eigen::MatrixXd AOCoulomb::Pseudo_InvSqrt_GWBSE(const AOOverlap& auxoverlap,
@@ -20,6 +20,8 @@
 #include <votca/xtp/aomatrix.h>
 
 #include <votca/xtp/aobasis.h>
+#include <votca/xtp/boysfunction.h>
+#include <votca/xtp/scratcharena.h>
 
 #include <votca/tools/constants.h>
 #include <votca/tools/elements.h>
@@ -27,17 +29,15 @@
 namespace votca {
 namespace xtp {
 
-void AODipole_Potential::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
-                                   const AOShell* shell_row,
-                                   const AOShell* shell_col) {
+void AODipole_Potential::FillPotential(Eigen::Block<Eigen::MatrixXd>& matrix,
+                                       const AOShell* shell_row,
+                                       const AOShell* shell_col,
+                                       const Multipole& multipole) {
 
   const double pi = boost::math::constants::pi<double>();
 
-  // Get components of dipole vector somehow
-
-  tools::vec dipole =
-      -(apolarsite->getU1() + apolarsite->getQ1()) * tools::conv::nm2bohr;
-  tools::vec position = apolarsite->getPos() * tools::conv::nm2bohr;
+  const Eigen::Vector3d& dipole = multipole.dipole;
+  const tools::vec& position = multipole.position;
 
   // shell info, only lmax tells how far to go
   int lmax_row = shell_row->getLmax();
@@ -137,32 +137,12 @@ void AODipole_Potential::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
 
       const double U = zeta * (PmC0 * PmC0 + PmC1 * PmC1 + PmC2 * PmC2);
 
-      const std::vector<double> FmU = XIntegrate(lsum + 2, U);
-
-      typedef boost::multi_array<double, 3> ma_type;
-      typedef boost::multi_array<double, 4> ma4_type;  //////////////////
-      ma_type nuc3(boost::extents[nrows][ncols][lsum + 1]);
-      ma4_type dip4(boost::extents[nrows][ncols][3][lsum + 1]);
-      typedef ma_type::index index;
+      double FmU[BoysFunction::MaxSize];
+      BoysFunction::Evaluate(lsum + 2, U, FmU);
 
-      for (index i = 0; i < nrows; ++i) {
-        for (index j = 0; j < ncols; ++j) {
-          for (index m = 0; m < lsum + 1; ++m) {
-            nuc3[i][j][m] = 0.;
-          }
-        }
-      }
-
-      for (index i = 0; i < nrows; ++i) {
-        for (index j = 0; j < ncols; ++j) {
-          for (index k = 0; k < 3;
-               ++k) {  ///////////////////////////////// error corrected
-            for (index m = 0; m < lsum + 1; ++m) {
-              dip4[i][j][k][m] = 0.;
-            }
-          }
-        }
-      }
+      ScratchArena::Frame scratch;
+      tensor3d_ref nuc3 = scratch.Tensor3D(nrows, ncols, lsum + 1);
+      tensor4d_ref dip4 = scratch.Tensor4D(nrows, ncols, 3, lsum + 1);
 
       // (s-s element normiert )
       double _prefactor = 4. * sqrt(2. / pi) * pow(decay_row * decay_col, .75) *
@@ -1291,9 +1271,9 @@ void AODipole_Potential::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
       // votca dipoles are spherical in ordering z,y,x
       for (int i = 0; i < nrows; i++) {
         for (int j = 0; j < ncols; j++) {
-          dip(i, j) = dipole.getX() * dip4[i][j][0][0] +
-                      dipole.getY() * dip4[i][j][1][0] +
-                      dipole.getZ() * dip4[i][j][2][0];
+          dip(i, j) = dipole.x() * dip4[i][j][0][0] +
+                      dipole.y() * dip4[i][j][1][0] +
+                      dipole.z() * dip4[i][j][2][0];
         }
       }
 
@@ -1312,28 +1292,19 @@ void AODipole_Potential::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
   }    // shell_row Gaussians
 }
 
-void AODipole_Potential::Fillextpotential(
-    const AOBasis& aobasis,
-    const std::vector<std::shared_ptr<ctp::PolarSeg> >& sites) {
-
-  _externalpotential =
-      Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
-  for (unsigned int i = 0; i < sites.size(); i++) {
-    for (ctp::APolarSite* site : *(sites[i])) {
-
-      if (site->getRank() > 0 || site->IsPolarizable()) {
-        if (tools::abs(site->getU1() + site->getQ1()) < 1e-12) {
-          continue;
-        }
-        _aomatrix =
-            Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
-        setAPolarSite(site);
-        Fill(aobasis);
-        _externalpotential += _aomatrix;
-      }
-    }
+bool AODipole_Potential::getMultipole(ctp::APolarSite* site,
+                                      Multipole& multipole) const {
+  if (site->getRank() < 1 && !site->IsPolarizable()) {
+    return false;
+  }
+  tools::vec dipole = site->getU1() + site->getQ1();
+  if (tools::abs(dipole) < 1e-12) {
+    return false;
   }
-  return;
+  dipole = -dipole * tools::conv::nm2bohr;
+  multipole.position = site->getPos() * tools::conv::nm2bohr;
+  multipole.dipole << dipole.getX(), dipole.getY(), dipole.getZ();
+  return true;
 }
 
 }  // namespace xtp
@@ -26,14 +26,17 @@
 #include <votca/tools/elements.h>
 #include <votca/tools/property.h>
 #include <votca/xtp/aobasis.h>
+#include <votca/xtp/boysfunction.h>
+#include <votca/xtp/scratcharena.h>
 
 #include "votca/xtp/qmatom.h"
 
 namespace votca {
 namespace xtp {
 
-void AOESP::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
-                      const AOShell* shell_row, const AOShell* shell_col) {
+void AOESP::FillPotential(Eigen::Block<Eigen::MatrixXd>& matrix,
+                          const AOShell* shell_row, const AOShell* shell_col,
+                          const Multipole& multipole) {
 
   const double pi = boost::math::constants::pi<double>();
 
@@ -134,17 +137,18 @@ void AOESP::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
 
       double PmC0 =
           fak2 * (decay_row * pos_row.getX() + decay_col * pos_col.getX()) -
-          _r.getX();
+          multipole.position.getX();
       double PmC1 =
           fak2 * (decay_row * pos_row.getY() + decay_col * pos_col.getY()) -
-          _r.getY();
+          multipole.position.getY();
       double PmC2 =
           fak2 * (decay_row * pos_row.getZ() + decay_col * pos_col.getZ()) -
-          _r.getZ();
+          multipole.position.getZ();
 
       const double U = zeta * (PmC0 * PmC0 + PmC1 * PmC1 + PmC2 * PmC2);
 
-      const std::vector<double> _FmU = XIntegrate(lsum + 1, U);
+      double _FmU[BoysFunction::MaxSize];
+      BoysFunction::Evaluate(lsum + 1, U, _FmU);
       // cout << endl;
 
       // (s-s element normiert )
@@ -153,17 +157,8 @@ void AOESP::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
                          exp(-exparg);
       nuc(Cart::s, Cart::s) = prefactor * _FmU[0];
 
-      typedef boost::multi_array<double, 3> ma_type;
-      ma_type nuc3(boost::extents[nrows][ncols][lsum + 1]);
-      typedef ma_type::index index;
-
-      for (index i = 0; i < nrows; ++i) {
-        for (index j = 0; j < ncols; ++j) {
-          for (index k = 0; k < lsum + 1; ++k) {
-            nuc3[i][j][k] = 0.;
-          }
-        }
-      }
+      ScratchArena::Frame scratch;
+      tensor3d_ref nuc3 = scratch.Tensor3D(nrows, ncols, lsum + 1);
 
       for (int i = 0; i < lsum + 1; i++) {  //////////////////////
         nuc3[0][0][i] = prefactor * _FmU[i];
@@ -637,8 +632,9 @@ void AOESP::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
 
       for (unsigned i = 0; i < matrix.rows(); i++) {
         for (unsigned j = 0; j < matrix.cols(); j++) {
-          matrix(i, j) +=
-              nuc_sph(i + shell_row->getOffset(), j + shell_col->getOffset());
+          matrix(i, j) += multipole.charge *
+                          nuc_sph(i + shell_row->getOffset(),
+                                  j + shell_col->getOffset());
         }
       }
 
@@ -666,24 +662,10 @@ void AOESP::Fillnucpotential(const AOBasis& aobasis,
   return;
 }
 
-void AOESP::Fillextpotential(
-    const AOBasis& aobasis,
-    const std::vector<std::shared_ptr<ctp::PolarSeg> >& sites) {
-
-  _externalpotential =
-      Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
-
-  for (unsigned int i = 0; i < sites.size(); i++) {
-    for (ctp::APolarSite* site : *(sites[i])) {
-      tools::vec positionofsite = site->getPos() * tools::conv::nm2bohr;
-      _aomatrix =
-          Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
-      setPosition(positionofsite);
-      Fill(aobasis);
-      _externalpotential -= site->getQ00() * _aomatrix;
-    }
-  }
-  return;
+bool AOESP::getMultipole(ctp::APolarSite* site, Multipole& multipole) const {
+  multipole.position = site->getPos() * tools::conv::nm2bohr;
+  multipole.charge = -site->getQ00();
+  return true;
 }
 
 }  // namespace xtp
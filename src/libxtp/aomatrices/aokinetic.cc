@@ -20,29 +20,33 @@
 #include <votca/xtp/aomatrix.h>
 
 #include <votca/xtp/aobasis.h>
+#include <votca/xtp/aokerneltable.h>
 
 #include <vector>
 
 namespace votca {
 namespace xtp {
 
-void AOKinetic::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
-                          const AOShell* shell_row, const AOShell* shell_col) {
+namespace {
 
-  // shell info, only lmax tells how far to go
-  int lmax_row = shell_row->getLmax();
-  int lmax_col = shell_col->getLmax();
+template <int LROW, int LCOL>
+struct KineticKernel {
+  static void Fill(Eigen::Block<Eigen::MatrixXd>& matrix,
+                   const AOShell* shell_row, const AOShell* shell_col);
+};
 
-  if (lmax_col > 4 || lmax_row > 4) {
-    std::cerr << "Orbitals higher than g are not yet implemented. This should "
-                 "not have happened!"
-              << std::flush;
-    exit(1);
-  }
+template <int LROW, int LCOL>
+void KineticKernel<LROW, LCOL>::Fill(Eigen::Block<Eigen::MatrixXd>& matrix,
+                                     const AOShell* shell_row,
+                                     const AOShell* shell_col) {
+
+  // shell info, only lmax tells how far to go
+  constexpr int lmax_row = LROW;
+  constexpr int lmax_col = LCOL;
 
   // set size of internal block for recursion
-  int nrows = this->getBlockSize(lmax_row);
-  int ncols = this->getBlockSize(lmax_col);
+  constexpr int nrows = AOBlockSize(lmax_row);
+  constexpr int ncols = AOBlockSize(lmax_col);
 
   // get shell positions
   const tools::vec& pos_row = shell_row->getPos();
@@ -128,9 +132,11 @@ void AOKinetic::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
       const double fak_b = rzeta * decay_row;  ////////////
 
       // matrix for kinetic energies
-      Eigen::MatrixXd kin = Eigen::MatrixXd::Zero(nrows, ncols);
+      Eigen::Matrix<double, nrows, ncols> kin =
+          Eigen::Matrix<double, nrows, ncols>::Zero();
       // matrix for unnormalized overlap integrals
-      Eigen::MatrixXd ol = Eigen::MatrixXd::Zero(nrows, ncols);
+      Eigen::Matrix<double, nrows, ncols> ol =
+          Eigen::Matrix<double, nrows, ncols>::Zero();
 
       // s-s overlap integral
       ol(Cart::s, Cart::s) = pow(rzeta, 1.5) *
@@ -627,8 +633,8 @@ void AOKinetic::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
       }  // end if (lmax_col > 3)
 
       // normalization and cartesian -> spherical factors
-      Eigen::MatrixXd kin_sph =
-          getTrafo(*itr).transpose() * kin * getTrafo(*itc);
+      Eigen::MatrixXd kin_sph = AOSuperMatrix::getTrafo(*itr).transpose() *
+                                kin * AOSuperMatrix::getTrafo(*itc);
       // save to matrix
 
       for (unsigned i = 0; i < matrix.rows(); i++) {
@@ -642,5 +648,22 @@ void AOKinetic::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
   }    // row
   return;
 }
+
+}  // namespace
+
+void AOKinetic::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
+                          const AOShell* shell_row, const AOShell* shell_col) {
+  int lmax_row = shell_row->getLmax();
+  int lmax_col = shell_col->getLmax();
+  if (lmax_col > 4 || lmax_row > 4) {
+    std::cerr << "Orbitals higher than g are not yet implemented. This should "
+                 "not have happened!"
+              << std::flush;
+    exit(1);
+  }
+  AOKernelTable<KineticKernel, 4>::get(lmax_row, lmax_col)(matrix, shell_row,
+                                                           shell_col);
+  return;
+}
 }  // namespace xtp
 }  // namespace votca
@@ -0,0 +1,292 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/xtp/aomatrix.h>
+
+#include <votca/xtp/aobasis.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace votca {
+namespace xtp {
+
+void AOMultipolePotential::Fillextpotential(
+    const AOBasis& aobasis,
+    const std::vector<std::shared_ptr<ctp::PolarSeg> >& sites) {
+
+  _externalpotential =
+      Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
+
+  std::vector<Multipole> multipoles;
+  for (const std::shared_ptr<ctp::PolarSeg>& segment : sites) {
+    for (ctp::APolarSite* site : *segment) {
+      Multipole multipole;
+      if (getMultipole(site, multipole)) {
+        multipoles.push_back(multipole);
+      }
+    }
+  }
+  if (multipoles.empty()) {
+    return;
+  }
+
+  // shells of one atom are stored consecutively
+  std::vector<std::vector<const AOShell*> > atoms;
+  for (const AOShell* shell : aobasis) {
+    if (atoms.empty() ||
+        atoms.back()[0]->getAtomIndex() != shell->getAtomIndex()) {
+      atoms.push_back(std::vector<const AOShell*>(0));
+    }
+    atoms.back().push_back(shell);
+  }
+  // an atom extends to where its most diffuse primitive has decayed to 1/e
+  std::vector<double> extents;
+  for (const std::vector<const AOShell*>& shells : atoms) {
+    double mindecay = std::numeric_limits<double>::max();
+    for (const AOShell* shell : shells) {
+      mindecay = std::min(mindecay, shell->getMinDecay());
+    }
+    extents.push_back(1.0 / std::sqrt(mindecay));
+  }
+  std::vector<std::pair<int, int> > atompairs;
+  for (unsigned a = 0; a < atoms.size(); a++) {
+    for (unsigned b = a; b < atoms.size(); b++) {
+      atompairs.push_back(std::make_pair(a, b));
+    }
+  }
+
+#pragma omp parallel for schedule(dynamic)
+  for (unsigned pair = 0; pair < atompairs.size(); pair++) {
+    const int a = atompairs[pair].first;
+    const int b = atompairs[pair].second;
+    const tools::vec& pos_a = atoms[a][0]->getPos();
+    const tools::vec& pos_b = atoms[b][0]->getPos();
+    const tools::vec center = (pos_a + pos_b) * 0.5;
+
+    // the error of the second order expansion scales as (extent/R)^3
+    double farfield2 = std::numeric_limits<double>::max();
+    if (_farfield_accuracy > 0.0) {
+      double extent =
+          0.5 * tools::abs(pos_a - pos_b) + std::max(extents[a], extents[b]);
+      farfield2 = extent * extent * std::pow(_farfield_accuracy, -2.0 / 3.0);
+    }
+
+    double potential = 0.0;
+    Eigen::Vector3d gradient = Eigen::Vector3d::Zero();
+    Eigen::Matrix3d hessian = Eigen::Matrix3d::Zero();
+    int farsites = 0;
+    std::vector<const Multipole*> nearsites;
+    for (const Multipole& multipole : multipoles) {
+      const tools::vec dist = center - multipole.position;
+      if (dist * dist > farfield2) {
+        AddFarField(multipole, center, potential, gradient, hessian);
+        farsites++;
+      } else {
+        nearsites.push_back(&multipole);
+      }
+    }
+
+    for (unsigned i = 0; i < atoms[a].size(); i++) {
+      const AOShell* shell_row = atoms[a][i];
+      // on the same atom the upper triangle suffices
+      unsigned j_start = (a == b) ? i : 0;
+      for (unsigned j = j_start; j < atoms[b].size(); j++) {
+        const AOShell* shell_col = atoms[b][j];
+        Eigen::MatrixXd block_matrix = Eigen::MatrixXd::Zero(
+            shell_row->getNumFunc(), shell_col->getNumFunc());
+        Eigen::Block<Eigen::MatrixXd> block = block_matrix.block(
+            0, 0, shell_row->getNumFunc(), shell_col->getNumFunc());
+        for (const Multipole* multipole : nearsites) {
+          FillPotential(block, shell_row, shell_col, *multipole);
+        }
+        if (farsites > 0) {
+          std::vector<Eigen::MatrixXd> moments =
+              FillMoments(shell_row, shell_col, center);
+          block_matrix += potential * moments[0];
+          int index = 4;
+          for (int k = 0; k < 3; k++) {
+            block_matrix += gradient(k) * moments[1 + k];
+            for (int l = k; l < 3; l++) {
+              double factor = (k == l) ? 0.5 : 1.0;
+              block_matrix += factor * hessian(k, l) * moments[index];
+              index++;
+            }
+          }
+        }
+        _externalpotential.block(
+            shell_row->getStartIndex(), shell_col->getStartIndex(),
+            shell_row->getNumFunc(), shell_col->getNumFunc()) = block_matrix;
+        _externalpotential.block(
+            shell_col->getStartIndex(), shell_row->getStartIndex(),
+            shell_col->getNumFunc(), shell_row->getNumFunc()) =
+            block_matrix.transpose();
+      }
+    }
+  }
+  return;
+}
+
+// derivatives of 1/R up to fourth order contracted with the multipoles
+void AOMultipolePotential::AddFarField(const Multipole& multipole,
+                                       const tools::vec& center,
+                                       double& potential,
+                                       Eigen::Vector3d& gradient,
+                                       Eigen::Matrix3d& hessian) {
+  const tools::vec dist = center - multipole.position;
+  const Eigen::Vector3d R(dist.getX(), dist.getY(), dist.getZ());
+  const Eigen::Matrix3d RR = R * R.transpose();
+  const Eigen::Matrix3d unit = Eigen::Matrix3d::Identity();
+  const double invR = 1.0 / R.norm();
+  const double invR2 = invR * invR;
+  const double invR3 = invR * invR2;
+  const double invR5 = invR3 * invR2;
+  const double invR7 = invR5 * invR2;
+
+  const double q = multipole.charge;
+  potential += q * invR;
+  gradient -= q * invR3 * R;
+  hessian += q * (3.0 * invR5 * RR - invR3 * unit);
+
+  const Eigen::Vector3d& p = multipole.dipole;
+  const double pR = p.dot(R);
+  const Eigen::Matrix3d pR_sym = p * R.transpose() + R * p.transpose();
+  potential += pR * invR3;
+  gradient += invR3 * p - 3.0 * pR * invR5 * R;
+  hessian += 15.0 * pR * invR7 * RR - 3.0 * invR5 * (pR_sym + pR * unit);
+
+  const Eigen::Matrix3d& theta = multipole.quadrupole;
+  const Eigen::Vector3d t = theta * R;
+  const double s = R.dot(t);
+  const Eigen::Matrix3d tR_sym = t * R.transpose() + R * t.transpose();
+  const double invR9 = invR7 * invR2;
+  potential += s * invR5;
+  gradient += 2.0 * invR5 * t - 5.0 * s * invR7 * R;
+  hessian += 35.0 * s * invR9 * RR - 5.0 * invR7 * (2.0 * tR_sym + s * unit) +
+             2.0 * invR5 * theta;
+  return;
+}
+
+std::vector<Eigen::MatrixXd> AOMultipolePotential::FillMoments(
+    const AOShell* shell_row, const AOShell* shell_col,
+    const tools::vec& center) {
+
+  const int lmax_row = shell_row->getLmax();
+  const int lmax_col = shell_col->getLmax();
+  const int nrows = getBlockSize(lmax_row);
+  const int ncols = getBlockSize(lmax_col);
+
+  // exponents of the cartesian functions in the order of Cart::Index
+  std::vector<std::array<int, 3> > powers;
+  for (int l = 0; l <= std::max(lmax_row, lmax_col); l++) {
+    for (int nx = l; nx >= 0; nx--) {
+      for (int ny = l - nx; ny >= 0; ny--) {
+        powers.push_back({{nx, ny, l - nx - ny}});
+      }
+    }
+  }
+
+  std::vector<Eigen::MatrixXd> moments(
+      10,
+      Eigen::MatrixXd::Zero(shell_row->getNumFunc(), shell_col->getNumFunc()));
+
+  const tools::vec& pos_row = shell_row->getPos();
+  const tools::vec& pos_col = shell_col->getPos();
+  const tools::vec diff = pos_row - pos_col;
+  const double distsq = diff * diff;
+
+  for (const AOGaussianPrimitive& gaussian_row : *shell_row) {
+    const double decay_row = gaussian_row.getDecay();
+    for (const AOGaussianPrimitive& gaussian_col : *shell_col) {
+      const double decay_col = gaussian_col.getDecay();
+      const double fak = 0.5 / (decay_row + decay_col);
+      const double fak2 = 2.0 * fak;
+      const double exparg = fak2 * decay_row * decay_col * distsq;
+      if (exparg > 30.0) {
+        continue;
+      }
+      const tools::vec P = (pos_row * decay_row + pos_col * decay_col) * fak2;
+      const tools::vec PmA = P - pos_row;
+      const tools::vec PmB = P - pos_col;
+      const tools::vec BmC = pos_col - center;
+      const double PA[3] = {PmA.getX(), PmA.getY(), PmA.getZ()};
+      const double PB[3] = {PmB.getX(), PmB.getY(), PmB.getZ()};
+      const double BC[3] = {BmC.getX(), BmC.getY(), BmC.getZ()};
+
+      // one dimensional overlaps with the column raised by up to two, which
+      // give the first and second moments via (x-C) = (x-B) + (B-C)
+      std::array<Eigen::MatrixXd, 3> ol;
+      std::array<std::array<Eigen::MatrixXd, 3>, 3> mom;
+      for (int d = 0; d < 3; d++) {
+        Eigen::MatrixXd& S = ol[d];
+        S = Eigen::MatrixXd::Zero(lmax_row + 1, lmax_col + 3);
+        S(0, 0) = 1.0;
+        for (int i = 0; i < lmax_row; i++) {
+          S(i + 1, 0) = PA[d] * S(i, 0);
+          if (i > 0) S(i + 1, 0) += i * fak * S(i - 1, 0);
+        }
+        for (int j = 0; j < lmax_col + 2; j++) {
+          for (int i = 0; i <= lmax_row; i++) {
+            S(i, j + 1) = PB[d] * S(i, j);
+            if (i > 0) S(i, j + 1) += i * fak * S(i - 1, j);
+            if (j > 0) S(i, j + 1) += j * fak * S(i, j - 1);
+          }
+        }
+        const double c = BC[d];
+        const int nj = lmax_col + 1;
+        mom[d][0] = S.leftCols(nj);
+        mom[d][1] = S.middleCols(1, nj) + c * S.leftCols(nj);
+        mom[d][2] = S.middleCols(2, nj) + 2.0 * c * S.middleCols(1, nj) +
+                    c * c * S.leftCols(nj);
+      }
+
+      const double prefactor = std::pow(4.0 * decay_row * decay_col, 0.75) *
+                               std::pow(fak2, 1.5) * std::exp(-exparg);
+      // operators as powers of (x,y,z), in the order of the result
+      const int ops[10][3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1},
+                              {2, 0, 0}, {1, 1, 0}, {1, 0, 1}, {0, 2, 0},
+                              {0, 1, 1}, {0, 0, 2}};
+      const Eigen::MatrixXd trafo_row = getTrafo(gaussian_row);
+      const Eigen::MatrixXd trafo_col = getTrafo(gaussian_col);
+      for (int op = 0; op < 10; op++) {
+        Eigen::MatrixXd cart = Eigen::MatrixXd::Zero(nrows, ncols);
+        for (int i = 0; i < nrows; i++) {
+          for (int j = 0; j < ncols; j++) {
+            cart(i, j) = prefactor *
+                         mom[0][ops[op][0]](powers[i][0], powers[j][0]) *
+                         mom[1][ops[op][1]](powers[i][1], powers[j][1]) *
+                         mom[2][ops[op][2]](powers[i][2], powers[j][2]);
+          }
+        }
+        Eigen::MatrixXd cart_sph = trafo_row.transpose() * cart * trafo_col;
+        moments[op] += cart_sph.block(shell_row->getOffset(),
+                                      shell_col->getOffset(),
+                                      shell_row->getNumFunc(),
+                                      shell_col->getNumFunc());
+      }
+    }
+  }
+  return moments;
+}
+
+}  // namespace xtp
+}  // namespace votca
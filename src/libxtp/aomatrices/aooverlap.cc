@@ -20,29 +20,33 @@
 #include <votca/xtp/aomatrix.h>
 
 #include <votca/xtp/aobasis.h>
+#include <votca/xtp/aokerneltable.h>
 
 #include <vector>
 
 namespace votca {
 namespace xtp {
 
-void AOOverlap::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
-                          const AOShell* shell_row, const AOShell* shell_col) {
+namespace {
+
+template <int LROW, int LCOL>
+struct OverlapKernel {
+  static void Fill(Eigen::Block<Eigen::MatrixXd>& matrix,
+                   const AOShell* shell_row, const AOShell* shell_col);
+};
+
+template <int LROW, int LCOL>
+void OverlapKernel<LROW, LCOL>::Fill(Eigen::Block<Eigen::MatrixXd>& matrix,
+                                     const AOShell* shell_row,
+                                     const AOShell* shell_col) {
 
   // shell info, only lmax tells how far to go
-  int lmax_row = shell_row->getLmax();
-  int lmax_col = shell_col->getLmax();
+  constexpr int lmax_row = LROW;
+  constexpr int lmax_col = LCOL;
 
   // set size of internal block for recursion
-  int nrows = this->getBlockSize(lmax_row);
-  int ncols = this->getBlockSize(lmax_col);
-
-  if (lmax_col > 6 || lmax_row > 6) {
-    std::cerr << "Orbitals higher than i are not yet implemented. This should "
-                 "not have happened!"
-              << std::flush;
-    exit(1);
-  }
+  constexpr int nrows = AOBlockSize(lmax_row);
+  constexpr int ncols = AOBlockSize(lmax_col);
 
   /* FOR CONTRACTED FUNCTIONS, ADD LOOP OVER ALL DECAYS IN CONTRACTION
    * MULTIPLY THE TRANSFORMATION MATRICES BY APPROPRIATE CONTRACTION
@@ -117,7 +121,8 @@ void AOOverlap::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
         continue;
       }
       // initialize local matrix block for unnormalized cartesians
-      Eigen::MatrixXd _ol = Eigen::MatrixXd::Zero(nrows, ncols);
+      Eigen::Matrix<double, nrows, ncols> _ol =
+          Eigen::Matrix<double, nrows, ncols>::Zero();
 
       // Definition of coefficients for recursive overlap formulas
       // A for rows (i). B for columns (j)
@@ -655,8 +660,8 @@ void AOOverlap::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
 
       // cout << "Done with unnormalized matrix " << endl;
 
-      Eigen::MatrixXd _ol_sph =
-          getTrafo(*itr).transpose() * _ol * getTrafo(*itc);
+      Eigen::MatrixXd _ol_sph = AOSuperMatrix::getTrafo(*itr).transpose() *
+                                _ol * AOSuperMatrix::getTrafo(*itc);
       // save to matrix
 
       for (unsigned i = 0; i < matrix.rows(); i++) {
@@ -669,6 +674,23 @@ void AOOverlap::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
   }    // shell_row Gaussians
 }
 
+}  // namespace
+
+void AOOverlap::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
+                          const AOShell* shell_row, const AOShell* shell_col) {
+  int lmax_row = shell_row->getLmax();
+  int lmax_col = shell_col->getLmax();
+  if (lmax_col > 6 || lmax_row > 6) {
+    std::cerr << "Orbitals higher than i are not yet implemented. This should "
+                 "not have happened!"
+              << std::flush;
+    exit(1);
+  }
+  AOKernelTable<OverlapKernel, 6>::get(lmax_row, lmax_col)(matrix, shell_row,
+                                                           shell_col);
+  return;
+}
+
 Eigen::MatrixXd AOOverlap::FillShell(const AOShell* shell) {
   Eigen::MatrixXd block =
       Eigen::MatrixXd::Zero(shell->getNumFunc(), shell->getNumFunc());
@@ -678,6 +700,16 @@ Eigen::MatrixXd AOOverlap::FillShell(const AOShell* shell) {
   return block;
 }
 
+Eigen::MatrixXd AOOverlap::FillShellPair(const AOShell* shell_row,
+                                         const AOShell* shell_col) {
+  Eigen::MatrixXd block =
+      Eigen::MatrixXd::Zero(shell_row->getNumFunc(), shell_col->getNumFunc());
+  Eigen::Block<Eigen::MatrixXd> submatrix =
+      block.block(0, 0, shell_row->getNumFunc(), shell_col->getNumFunc());
+  FillBlock(submatrix, shell_row, shell_col);
+  return block;
+}
+
 Eigen::MatrixXd AOOverlap::Pseudo_InvSqrt(double etol) {
   Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> es(_aomatrix);
   smallestEigenvalue = es.eigenvalues()(0);
@@ -20,6 +20,8 @@
 #include <votca/xtp/aomatrix.h>
 
 #include <votca/xtp/aobasis.h>
+#include <votca/xtp/boysfunction.h>
+#include <votca/xtp/scratcharena.h>
 
 #include <vector>
 
@@ -28,32 +30,20 @@
 namespace votca {
 namespace xtp {
 
-void AOQuadrupole_Potential::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
-                                       const AOShell* shell_row,
-                                       const AOShell* shell_col) {
+void AOQuadrupole_Potential::FillPotential(
+    Eigen::Block<Eigen::MatrixXd>& matrix, const AOShell* shell_row,
+    const AOShell* shell_col, const Multipole& multipole) {
 
   const double pi = boost::math::constants::pi<double>();
 
-  std::vector<double> quadrupole = apolarsite->getQ2();
-  tools::vec position = apolarsite->getPos() * tools::conv::nm2bohr;
-  double nm22bohr2 = tools::conv::nm2bohr * tools::conv::nm2bohr;
-  for (double& entry : quadrupole) {
-    entry *= -nm22bohr2;
-  }
-  // I am not sure the order definition or anything is correct apolarsite object
-  // orders them as Q20, Q21c, Q21s, Q22c, Q22s
-
+  const tools::vec& position = multipole.position;
   // q_01 etc are cartesian tensor multipole moments according to
-  // https://en.wikipedia.org/wiki/Quadrupole so transform apolarsite into
-  // cartesian and then multiply by 2 (difference stone definition/wiki
-  // definition) not sure about unit conversion
-  double q_00 = -quadrupole[0] + sqrt(3) * quadrupole[3];
-  double q_01 = sqrt(3) * quadrupole[4];
-  double q_02 = sqrt(3) * quadrupole[1];
-  double q_12 = sqrt(3) * quadrupole[2];
-  double q_11 =
-      -quadrupole[0] -
-      sqrt(3) * quadrupole[3];  // tensor is traceless, q_22 = - (q_00 + q_11)
+  // https://en.wikipedia.org/wiki/Quadrupole, q_22 = - (q_00 + q_11)
+  double q_00 = 2.0 * multipole.quadrupole(0, 0);
+  double q_01 = 2.0 * multipole.quadrupole(0, 1);
+  double q_02 = 2.0 * multipole.quadrupole(0, 2);
+  double q_12 = 2.0 * multipole.quadrupole(1, 2);
+  double q_11 = 2.0 * multipole.quadrupole(1, 1);
   // shell info, only lmax tells how far to go
   int lmax_row = shell_row->getLmax();
   int lmax_col = shell_col->getLmax();
@@ -161,42 +151,13 @@ void AOQuadrupole_Potential::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
       const double U = zeta * (PmC0 * PmC0 + PmC1 * PmC1 + PmC2 * PmC2);
 
       // +3 quadrupole, +2 dipole, +1 nuclear attraction integrals
-      const std::vector<double> FmU = XIntegrate(lsum + 3, U);
-
-      typedef boost::multi_array<double, 3> ma_type;
-      typedef boost::multi_array<double, 4> ma4_type;  //////////////////
-      ma_type nuc3(boost::extents[nrows][ncols][lsum + 1]);
-      ma4_type dip4(boost::extents[nrows][ncols][3][lsum + 1]);
-      ma4_type quad4(boost::extents[nrows][ncols][5][lsum + 1]);
-      typedef ma_type::index index;
-
-      for (index i = 0; i < nrows; ++i) {
-        for (index j = 0; j < ncols; ++j) {
-          for (index m = 0; m < lsum + 1; ++m) {
-            nuc3[i][j][m] = 0.;
-          }
-        }
-      }
-
-      for (index i = 0; i < nrows; ++i) {
-        for (index j = 0; j < ncols; ++j) {
-          for (index k = 0; k < 3; ++k) {
-            for (index m = 0; m < lsum + 1; ++m) {
-              dip4[i][j][k][m] = 0.;
-            }
-          }
-        }
-      }
+      double FmU[BoysFunction::MaxSize];
+      BoysFunction::Evaluate(lsum + 3, U, FmU);
 
-      for (index i = 0; i < nrows; ++i) {
-        for (index j = 0; j < ncols; ++j) {
-          for (index k = 0; k < 5; ++k) {
-            for (index m = 0; m < lsum + 1; ++m) {
-              quad4[i][j][k][m] = 0.;
-            }
-          }
-        }
-      }
+      ScratchArena::Frame scratch;
+      tensor3d_ref nuc3 = scratch.Tensor3D(nrows, ncols, lsum + 1);
+      tensor4d_ref dip4 = scratch.Tensor4D(nrows, ncols, 3, lsum + 1);
+      tensor4d_ref quad4 = scratch.Tensor4D(nrows, ncols, 5, lsum + 1);
 
       // (s-s element normiert )
       double _prefactor = 4. * sqrt(2. / pi) * pow(decay_row * decay_col, .75) *
@@ -2082,26 +2043,34 @@ void AOQuadrupole_Potential::FillBlock(Eigen::Block<Eigen::MatrixXd>& matrix,
   }    // shell_row Gaussians
 }
 
-void AOQuadrupole_Potential::Fillextpotential(
-    const AOBasis& aobasis,
-    const std::vector<std::shared_ptr<ctp::PolarSeg> >& sites) {
-
-  _externalpotential =
-      Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
-  for (unsigned int i = 0; i < sites.size(); i++) {
-    for (ctp::APolarSite* site : *(sites[i])) {
-
-      if (site->getRank() > 1) {
-        _aomatrix =
-            Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
-        setAPolarSite(site);
-        Fill(aobasis);
-        _externalpotential += _aomatrix;
-      }
-    }
+bool AOQuadrupole_Potential::getMultipole(ctp::APolarSite* site,
+                                          Multipole& multipole) const {
+  if (site->getRank() < 2) {
+    return false;
   }
+  std::vector<double> quadrupole = site->getQ2();
+  double nm22bohr2 = tools::conv::nm2bohr * tools::conv::nm2bohr;
+  for (double& entry : quadrupole) {
+    entry *= -nm22bohr2;
+  }
+  // I am not sure the order definition or anything is correct apolarsite object
+  // orders them as Q20, Q21c, Q21s, Q22c, Q22s
 
-  return;
+  // transform apolarsite into cartesian tensor multipole moments according to
+  // https://en.wikipedia.org/wiki/Quadrupole and then multiply by 2
+  // (difference stone definition/wiki definition) not sure about unit
+  // conversion
+  double q_00 = -quadrupole[0] + sqrt(3) * quadrupole[3];
+  double q_01 = sqrt(3) * quadrupole[4];
+  double q_02 = sqrt(3) * quadrupole[1];
+  double q_12 = sqrt(3) * quadrupole[2];
+  double q_11 = -quadrupole[0] - sqrt(3) * quadrupole[3];
+  // the traceless tensor with R.quadrupole.R = 0.5 * q_ij R_i R_j
+  multipole.quadrupole << q_00, q_01, q_02, q_01, q_11, q_12, q_02, q_12,
+      -(q_00 + q_11);
+  multipole.quadrupole *= 0.5;
+  multipole.position = site->getPos() * tools::conv::nm2bohr;
+  return true;
 }
 
 }  // namespace xtp
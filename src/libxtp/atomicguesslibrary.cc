@@ -0,0 +1,113 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <boost/filesystem.hpp>
+#include <cctype>
+#include <votca/xtp/atomicguesslibrary.h>
+#include <votca/xtp/checkpoint.h>
+
+namespace votca {
+namespace xtp {
+
+namespace bfs = boost::filesystem;
+
+AtomicGuessLibrary& AtomicGuessLibrary::Instance() {
+  static AtomicGuessLibrary library;
+  return library;
+}
+
+std::string AtomicGuessLibrary::Key(const std::string& element,
+                                    const std::string& basis,
+                                    const std::string& ecp,
+                                    const std::string& functional,
+                                    const std::string& grid) {
+  return element + "|" + basis + "|" + ecp + "|" + functional + "|" + grid;
+}
+
+std::string AtomicGuessLibrary::FileName(const std::string& key,
+                                         const std::string& directory) {
+  std::string name = key;
+  for (char& c : name) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' &&
+        c != '+') {
+      c = '_';
+    }
+  }
+  return (bfs::path(directory) / (name + ".hdf5")).string();
+}
+
+int AtomicGuessLibrary::size() {
+  tools::MutexLocker lock(_mutex);
+  return int(_densities.size());
+}
+
+// HDF5 is not thread safe, so files are accessed under the lock as well
+bool AtomicGuessLibrary::Find(const std::string& key,
+                              const std::string& directory,
+                              Eigen::MatrixXd& dmat) {
+  tools::MutexLocker lock(_mutex);
+  std::map<std::string, Eigen::MatrixXd>::const_iterator it =
+      _densities.find(key);
+  if (it != _densities.end()) {
+    dmat = it->second;
+    return true;
+  }
+  if (directory.empty()) {
+    return false;
+  }
+  std::string filename = FileName(key, directory);
+  if (!bfs::exists(filename)) {
+    return false;
+  }
+  CheckpointFile cpf(filename, CheckpointAccessLevel::READ);
+  CheckpointReader r = cpf.getReader("/AtomicGuess");
+  std::string filekey;
+  r(filekey, "key");
+  // different keys may share a file name
+  if (filekey != key) {
+    return false;
+  }
+  r(dmat, "density");
+  _densities[key] = dmat;
+  return true;
+}
+
+void AtomicGuessLibrary::Insert(const std::string& key,
+                                const std::string& directory,
+                                const Eigen::MatrixXd& dmat) {
+  tools::MutexLocker lock(_mutex);
+  _densities[key] = dmat;
+  if (directory.empty()) {
+    return;
+  }
+  bfs::create_directories(directory);
+  bfs::path tmpfile =
+      bfs::path(directory) / bfs::unique_path("%%%%-%%%%-%%%%.tmp");
+  {
+    CheckpointFile cpf(tmpfile.string(), CheckpointAccessLevel::CREATE);
+    CheckpointWriter w = cpf.getWriter("/AtomicGuess");
+    w(key, "key");
+    w(dmat, "density");
+  }
+  bfs::rename(tmpfile, FileName(key, directory));
+  return;
+}
+
+}  // namespace xtp
+}  // namespace votca
@@ -0,0 +1,118 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <boost/math/constants/constants.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <votca/xtp/boysfunction.h>
+
+namespace votca {
+namespace xtp {
+
+constexpr int BoysFunction::MaxSize;
+
+namespace {
+
+// with a grid step of 0.1 the Taylor terms up to dU^7/7! give full double
+// precision, above U=117 exp(-U) is negligible against all F_m, m < MaxSize
+const int taylor_terms = 8;
+const int table_orders = BoysFunction::MaxSize + taylor_terms - 1;
+const double table_step = 0.1;
+const double table_max = 117.0;
+const int table_points = int(table_max / table_step) + 2;
+
+// F_m(U_i) for U_i = i * table_step, m < table_orders
+class BoysTable {
+ public:
+  BoysTable() : _values(table_points * table_orders) {
+    const int mmax = table_orders - 1;
+    for (int i = 0; i < table_points; i++) {
+      const double U = i * table_step;
+      const double expU = std::exp(-U);
+      // series for the highest order, converges for all U
+      double term = 1.0 / (2.0 * mmax + 1.0);
+      double sum = term;
+      for (int k = 1; term > 1e-17 * sum; k++) {
+        term *= 2.0 * U / (2.0 * mmax + 2.0 * k + 1.0);
+        sum += term;
+      }
+      double* F = &_values[i * table_orders];
+      F[mmax] = expU * sum;
+      for (int m = mmax - 1; m >= 0; m--) {
+        F[m] = (2.0 * U * F[m + 1] + expU) / (2.0 * m + 1.0);
+      }
+    }
+  }
+
+  const double* operator[](int i) const { return &_values[i * table_orders]; }
+
+ private:
+  std::vector<double> _values;
+};
+
+const BoysTable& Table() {
+  static const BoysTable table;
+  return table;
+}
+
+}  // namespace
+
+void BoysFunction::Evaluate(int size, double U, double* FmU) {
+  if (size < 1 || size > MaxSize) {
+    throw std::runtime_error("Boys function of order " +
+                             std::to_string(size - 1) + " is not supported");
+  }
+  if (U < 0.0) {
+    throw std::runtime_error("Boys function of negative argument " +
+                             std::to_string(U));
+  }
+  const int mm = size - 1;
+
+  if (U >= table_max) {
+    const double pi = boost::math::constants::pi<double>();
+    FmU[0] = 0.5 * std::sqrt(pi / U);
+    const double inv2U = 0.5 / U;
+    for (int m = 1; m < size; m++) {
+      FmU[m] = (2.0 * m - 1.0) * inv2U * FmU[m - 1];
+    }
+    return;
+  }
+
+  const int i = int(U / table_step + 0.5);
+  const double dU = i * table_step - U;
+  const double* F = Table()[i];
+  // F_m(U_i - dU) = sum_k F_m+k(U_i) dU^k / k!, Horner from the top
+  double fm = F[mm + taylor_terms - 1];
+  for (int k = taylor_terms - 1; k > 0; k--) {
+    fm = F[mm + k - 1] + fm * dU / k;
+  }
+  FmU[mm] = fm;
+  if (mm > 0) {
+    const double expU = std::exp(-U);
+    for (int m = mm - 1; m >= 0; m--) {
+      FmU[m] = (2.0 * U * FmU[m + 1] + expU) / (2.0 * m + 1.0);
+    }
+  }
+  return;
+}
+
+}  // namespace xtp
+}  // namespace votca
@@ -71,6 +71,8 @@ void BSECoupling::Initialize(Property& options) {
       _output_perturbation = true;
     }
   }
+  _matrixfree =
+      options.ifExistsReturnElseReturnDefault<bool>(key + ".matrixfree", false);
 
   _levA = options.get(key + ".moleculeA.states").as<int>();
   _levB = options.get(key + ".moleculeB.states").as<int>();
@@ -334,26 +336,33 @@ void BSECoupling::CalculateCouplings(const Orbitals& orbitalsA,
   int _bseAB_vtotal = _bseAB_vmax - _bseAB_vmin + 1;
   int _bseAB_ctotal = _bseAB_cmax - _bseAB_cmin + 1;
   int _bseAB_size = _bseAB_vtotal * _bseAB_ctotal;
-  // check if electron-hole interaction matrices are stored
-  if (!orbitalsAB.hasEHinteraction_triplet() && _doTriplets) {
-    throw std::runtime_error("BSE EH for triplets not stored ");
-  }
-  if (!orbitalsAB.hasEHinteraction_singlet() && _doSinglets) {
-    throw std::runtime_error("BSE EH for singlets not stored ");
-  }
-  const MatrixXfd& eh_t = orbitalsAB.eh_t();
-  const MatrixXfd& eh_s = orbitalsAB.eh_s();
-  if (_doTriplets) {
+  if (_matrixfree) {
     CTP_LOG(ctp::logDEBUG, *_pLog)
         << ctp::TimeStamp()
-        << "   dimer AB has BSE EH interaction triplet with dimension "
-        << eh_t.rows() << " x " << eh_t.cols() << flush;
-  }
-  if (_doSinglets) {
-    CTP_LOG(ctp::logDEBUG, *_pLog)
-        << ctp::TimeStamp()
-        << "   dimer AB has BSE EH interaction singlet with dimension "
-        << eh_s.rows() << " x " << eh_s.cols() << flush;
+        << "   dimer AB BSE hamiltonian is applied matrix free with dimension "
+        << _bseAB_size << flush;
+  } else {
+    // check if electron-hole interaction matrices are stored
+    if (!orbitalsAB.hasEHinteraction_triplet() && _doTriplets) {
+      throw std::runtime_error("BSE EH for triplets not stored ");
+    }
+    if (!orbitalsAB.hasEHinteraction_singlet() && _doSinglets) {
+      throw std::runtime_error("BSE EH for singlets not stored ");
+    }
+    if (_doTriplets) {
+      CTP_LOG(ctp::logDEBUG, *_pLog)
+          << ctp::TimeStamp()
+          << "   dimer AB has BSE EH interaction triplet with dimension "
+          << orbitalsAB.eh_t().rows() << " x " << orbitalsAB.eh_t().cols()
+          << flush;
+    }
+    if (_doSinglets) {
+      CTP_LOG(ctp::logDEBUG, *_pLog)
+          << ctp::TimeStamp()
+          << "   dimer AB has BSE EH interaction singlet with dimension "
+          << orbitalsAB.eh_s().rows() << " x " << orbitalsAB.eh_s().cols()
+          << flush;
+    }
   }
   // now, two storage assignment matrices for two-particle functions
   Eigen::MatrixXi combAB;
@@ -384,38 +393,15 @@ void BSECoupling::CalculateCouplings(const Orbitals& orbitalsA,
         "No information about number of occupied/unoccupied levels is stored");
   }
 
-  //       | Orbitals_A          0 |      | Overlap_A |
-  //       | 0          Orbitals_B |.T  X   | Overlap_B |  X  ( Orbitals_AB )
-
-  Eigen::MatrixXd psi_AxB =
-      Eigen::MatrixXd::Zero(levelsA + levelsB, basisA + basisB);
-  // constructing merged orbitals
-  psi_AxB.block(0, 0, levelsA, basisA) = orbitalsA.MOCoefficients().block(
-      _bseA_vmin, 0, _bseA_cmax + 1 - _bseA_vmin, basisA);
-  psi_AxB.block(levelsA, basisA, levelsB, basisB) =
-      orbitalsB.MOCoefficients().block(_bseB_vmin, 0,
-                                       _bseB_cmax + 1 - _bseA_vmin, basisB);
-
   // psi_AxB * S_AB * psi_AB
   CTP_LOG(ctp::logDEBUG, *_pLog)
       << ctp::TimeStamp() << "   projecting monomer onto dimer orbitals"
       << flush;
-
-  Eigen::MatrixXd overlapAB;
-  if (orbitalsAB.hasAOOverlap()) {
-    CTP_LOG(ctp::logDEBUG, *_pLog)
-        << "Reading overlap matrix from orbitals" << flush;
-    overlapAB = orbitalsAB.AOOverlap();
-  } else {
-    CTP_LOG(ctp::logDEBUG, *_pLog)
-        << "Calculating overlap matrix for basisset: "
-        << orbitalsAB.getDFTbasisName() << flush;
-    overlapAB = CalculateOverlapMatrix(orbitalsAB);
-  }
-
-  Eigen::MatrixXd psi_AxB_dimer_basis =
-      psi_AxB.transpose() * overlapAB * orbitalsAB.MOCoefficients();
-  overlapAB.resize(0, 0);
+  const DimerProjection& projection =
+      getDimerProjection(orbitalsA, orbitalsB, orbitalsAB);
+  Eigen::MatrixXd psi_AxB_dimer_basis = projection.Project(
+      orbitalsA, orbitalsB, orbitalsAB, _bseA_vmin, levelsA, _bseB_vmin,
+      levelsB);
   int LevelsA = levelsA;
   for (int i = 0; i < psi_AxB_dimer_basis.rows(); i++) {
     double mag = psi_AxB_dimer_basis.row(i).squaredNorm();
@@ -529,13 +515,19 @@ void BSECoupling::CalculateCouplings(const Orbitals& orbitalsA,
   combAB.resize(0, 0);
   combA.resize(0, 0);
   combB.resize(0, 0);
+  TCMatrix_gwbse Mmn;
+  Eigen::MatrixXd Hqp;
+  BSE bse(orbitalsAB, *_pLog, Mmn, Hqp);
+  if (_matrixfree) {
+    bse.configure(SetupDimerInteraction(orbitalsAB, Mmn, Hqp));
+    CTP_LOG(ctp::logDEBUG, *_pLog)
+        << ctp::TimeStamp() << "   Setup screened interaction of dimer"
+        << flush;
+  }
   // now the different spin types
   if (_doSinglets) {
     CTP_LOG(ctp::logDEBUG, *_pLog)
         << ctp::TimeStamp() << "   Evaluating singlets" << flush;
-    Eigen::MatrixXd Hamiltonian_AB = eh_s.cast<double>();
-    CTP_LOG(ctp::logDEBUG, *_pLog)
-        << ctp::TimeStamp() << "   Setup Hamiltonian" << flush;
     const Eigen::MatrixXd bseA_T =
         orbitalsA.BSESingletCoefficients()
             .block(0, 0, orbitalsA.BSESingletCoefficients().rows(), _levA)
@@ -547,7 +539,9 @@ void BSECoupling::CalculateCouplings(const Orbitals& orbitalsA,
             .transpose()
             .cast<double>();
 
-    JAB_singlet = ProjectExcitons(bseA_T, bseB_T, Hamiltonian_AB);
+    JAB_singlet = ProjectExcitons(bseA_T, bseB_T,
+                                  QMStateType(QMStateType::Singlet),
+                                  orbitalsAB, bse);
     CTP_LOG(ctp::logDEBUG, *_pLog)
         << ctp::TimeStamp() << "   calculated singlet couplings " << flush;
   }
@@ -555,9 +549,6 @@ void BSECoupling::CalculateCouplings(const Orbitals& orbitalsA,
   if (_doTriplets) {
     CTP_LOG(ctp::logDEBUG, *_pLog)
         << ctp::TimeStamp() << "   Evaluating triplets" << flush;
-    Eigen::MatrixXd Hamiltonian_AB = eh_s.cast<double>();
-    CTP_LOG(ctp::logDEBUG, *_pLog)
-        << ctp::TimeStamp() << "  Converted Hamiltonian to double" << flush;
     const Eigen::MatrixXd bseA_T =
         orbitalsA.BSETripletCoefficients()
             .block(0, 0, orbitalsA.BSETripletCoefficients().rows(), _levA)
@@ -568,7 +559,9 @@ void BSECoupling::CalculateCouplings(const Orbitals& orbitalsA,
             .block(0, 0, orbitalsB.BSETripletCoefficients().rows(), _levB)
             .transpose()
             .cast<double>();
-    JAB_triplet = ProjectExcitons(bseA_T, bseB_T, Hamiltonian_AB);
+    JAB_triplet = ProjectExcitons(bseA_T, bseB_T,
+                                  QMStateType(QMStateType::Triplet),
+                                  orbitalsAB, bse);
     CTP_LOG(ctp::logDEBUG, *_pLog)
         << ctp::TimeStamp() << "   calculated triplet couplings " << flush;
   }
@@ -578,9 +571,60 @@ void BSECoupling::CalculateCouplings(const Orbitals& orbitalsA,
   return;
 };
 
+/**
+ * \brief recomputes the ingredients of the dimer BSE hamiltonian
+ *
+ * The three-center integrals are rebuilt from the dimer MOs and the QP
+ * hamiltonian from the stored diagonalised QP states, so the hamiltonian
+ * itself does not have to be stored in the orbitals file.
+ */
+BSE::options BSECoupling::SetupDimerInteraction(const Orbitals& orbitalsAB,
+                                                TCMatrix_gwbse& Mmn,
+                                                Eigen::MatrixXd& Hqp) {
+  if (!orbitalsAB.hasQPdiag()) {
+    throw std::runtime_error(
+        "Matrix free BSE coupling requires the diagonalised QP hamiltonian "
+        "(qpdiag) of the dimer");
+  }
+  if (!orbitalsAB.hasAuxbasisName()) {
+    throw std::runtime_error("Dimer orbitals do not contain an auxbasis name");
+  }
+  BasisSet dftbs;
+  dftbs.LoadBasisSet(orbitalsAB.getDFTbasisName());
+  AOBasis dftbasis;
+  dftbasis.AOBasisFill(dftbs, orbitalsAB.QMAtoms());
+  BasisSet auxbs;
+  auxbs.LoadBasisSet(orbitalsAB.getAuxbasisName());
+  AOBasis auxbasis;
+  auxbasis.AOBasisFill(auxbs, orbitalsAB.QMAtoms());
+
+  BSE::options opt;
+  opt.useTDA = true;
+  opt.homo = orbitalsAB.getHomo();
+  opt.rpamin = orbitalsAB.getRPAmin();
+  opt.rpamax = orbitalsAB.getRPAmax();
+  opt.qpmin = orbitalsAB.getGWAmin();
+  opt.vmin = orbitalsAB.getBSEvmin();
+  opt.cmax = orbitalsAB.getBSEcmax();
+  opt.nmax = 0;
+
+  Mmn.Initialize(auxbasis.AOBasisSize(), opt.rpamin, orbitalsAB.getGWAmax(),
+                 opt.rpamin, opt.rpamax);
+  Mmn.Fill(auxbasis, dftbasis, orbitalsAB.MOCoefficients());
+  CTP_LOG(ctp::logDEBUG, *_pLog)
+      << ctp::TimeStamp()
+      << "   Calculated Mmn_beta (3-center-repulsion x orbitals) of dimer"
+      << flush;
+
+  const Eigen::MatrixXd& qpcoeff = orbitalsAB.QPdiagCoefficients();
+  Hqp = qpcoeff * orbitalsAB.QPdiagEnergies().asDiagonal() *
+        qpcoeff.transpose();
+  return opt;
+}
+
 std::vector<Eigen::MatrixXd> BSECoupling::ProjectExcitons(
     const Eigen::MatrixXd& bseA_T, const Eigen::MatrixXd& bseB_T,
-    Eigen::MatrixXd& H) {
+    const QMStateType& type, const Orbitals& orbitalsAB, const BSE& bse) {
 
   // get projection of monomer excitons on dimer product functions
   Eigen::MatrixXd _proj_excA = bseA_T * _kap;
@@ -590,7 +634,7 @@ std::vector<Eigen::MatrixXd> BSECoupling::ProjectExcitons(
   int ctABsize = ctAB.rows();
   int ctBAsize = ctBA.rows();
   _ct = ctABsize + ctBAsize;
-  int nobasisfunc = H.rows();
+  int nobasisfunc = _kap.cols();
 
   Eigen::MatrixXd fe_states = Eigen::MatrixXd::Zero(_bse_exc, nobasisfunc);
   fe_states.block(0, 0, _levA, nobasisfunc) = _proj_excA;
@@ -647,8 +691,20 @@ std::vector<Eigen::MatrixXd> BSECoupling::ProjectExcitons(
 
   // this only works for hermitian/symmetric H so only in TDA
 
-  Eigen::MatrixXd J_dimer = projection * H * projection.transpose();
-  H.resize(0, 0);
+  Eigen::MatrixXd H_projection;
+  if (_matrixfree) {
+    if (type == QMStateType::Singlet) {
+      H_projection = bse.ApplyHs(projection.transpose());
+    } else {
+      H_projection = bse.ApplyHt(projection.transpose());
+    }
+  } else {
+    const MatrixXfd& H =
+        (type == QMStateType::Singlet) ? orbitalsAB.eh_s() : orbitalsAB.eh_t();
+    H_projection = H.cast<double>() * projection.transpose();
+  }
+  Eigen::MatrixXd J_dimer = projection * H_projection;
+  H_projection.resize(0, 0);
 
   CTP_LOG(ctp::logDEBUG, *_pLog)
       << ctp::TimeStamp() << "   Setting up overlap matrix size "
@@ -92,19 +92,19 @@ void KMCLifetime::Initialize(tools::Property* options) {
 
 void KMCLifetime::WriteDecayProbability(string filename) {
 
-  Eigen::VectorXd outrates = Eigen::VectorXd::Zero(_nodes.size());
-  Eigen::VectorXd inrates = Eigen::VectorXd::Zero(_nodes.size());
-  Eigen::VectorXd decayrates = Eigen::VectorXd::Ones(_nodes.size());
-
-  for (unsigned i = 0; i < _nodes.size(); i++) {
-    GNode* node = _nodes[i];
-    if (node->hasdecay) {
-      for (const GLink& event : node->events) {
-        if (event.decayevent) {
-          decayrates[i] = event.rate;
+  const int nnodes = _graph.NumberofNodes();
+  Eigen::VectorXd outrates = Eigen::VectorXd::Zero(nnodes);
+  Eigen::VectorXd inrates = Eigen::VectorXd::Zero(nnodes);
+  Eigen::VectorXd decayrates = Eigen::VectorXd::Ones(nnodes);
+
+  for (int i = 0; i < nnodes; i++) {
+    if (_graph.hasDecay(i)) {
+      for (int k = _graph.EventsBegin(i); k < _graph.EventsEnd(i); k++) {
+        if (_graph.isDecay(k)) {
+          decayrates[i] = _graph.Rate(k);
         } else {
-          inrates[event.destination] += event.rate;
-          outrates[i] += event.rate;
+          inrates[_graph.Destination(k)] += _graph.Rate(k);
+          outrates[i] += _graph.Rate(k);
         }
       }
     }
@@ -115,8 +115,8 @@ void KMCLifetime::WriteDecayProbability(string filename) {
   fstream probs;
   probs.open(filename.c_str(), fstream::out);
   probs << "#SiteID, Relative Prob outgoing, Relative Prob ingoing" << endl;
-  for (unsigned i = 0; i < _nodes.size(); i++) {
-    probs << _nodes[i]->id << " " << outrates[i] << " " << inrates[i] << endl;
+  for (int i = 0; i < nnodes; i++) {
+    probs << i << " " << outrates[i] << " " << inrates[i] << endl;
   }
   probs.close();
   return;
@@ -167,9 +167,9 @@ void KMCLifetime::RunVSSM(ctp::Topology* top) {
   cout << endl
        << "Algorithm: VSSM for Multiple Charges with finite Lifetime" << endl;
   cout << "number of charges: " << _numberofcharges << endl;
-  cout << "number of nodes: " << _nodes.size() << endl;
+  cout << "number of nodes: " << _graph.NumberofNodes() << endl;
 
-  if (_numberofcharges > _nodes.size()) {
+  if (int(_numberofcharges) > _graph.NumberofNodes()) {
     throw runtime_error(
         "ERROR in kmclifetime: specified number of charges is greater than the "
         "number of nodes. This conflicts with single occupation.");
@@ -271,7 +271,7 @@ void KMCLifetime::RunVSSM(ctp::Topology* top) {
     while (secondlevel) {
 
       // determine which carrier will escape
-      GNode* newnode = NULL;
+      int newnode = -1;
       Chargecarrier* affectedcarrier = ChooseAffectedCarrier(cumulated_rate);
 
       if (CheckForbidden(affectedcarrier->getCurrentNodeId(), forbiddennodes)) {
@@ -284,10 +284,10 @@ void KMCLifetime::RunVSSM(ctp::Topology* top) {
       while (true) {
         // LEVEL 2
 
-        newnode = NULL;
-        GLink* event = ChooseHoppingDest(affectedcarrier->getCurrentNode());
+        const int node = affectedcarrier->getCurrentNodeId();
+        int event = ChooseHoppingDest(node);
 
-        if (event->decayevent) {
+        if (_graph.isDecay(event)) {
 
           avlifetime += affectedcarrier->getLifetime();
           meanfreepath += tools::abs(affectedcarrier->dr_travelled);
@@ -315,29 +315,28 @@ void KMCLifetime::RunVSSM(ctp::Topology* top) {
           secondlevel = false;
           break;
         } else {
-          newnode = _nodes[event->destination];
+          newnode = _graph.Destination(event);
         }
 
         // check after the event if this was allowed
-        if (CheckForbidden(newnode->id, forbiddendests)) {
+        if (CheckForbidden(newnode, forbiddendests)) {
           continue;
         }
 
         // if the new segment is unoccupied: jump; if not: add to forbidden list
         // and choose new hopping destination
-        if (newnode->occupied) {
-          if (CheckSurrounded(affectedcarrier->getCurrentNode(),
-                              forbiddendests)) {
+        if (_graph.isOccupied(newnode)) {
+          if (CheckSurrounded(node, forbiddendests)) {
             AddtoForbiddenlist(affectedcarrier->getCurrentNodeId(),
                                forbiddennodes);
             break;  // select new escape node (ends level 2 but without setting
                     // level1step to 1)
           }
-          AddtoForbiddenlist(newnode->id, forbiddendests);
+          AddtoForbiddenlist(newnode, forbiddendests);
           continue;  // select new destination
         } else {
           affectedcarrier->jumpfromCurrentNodetoNode(newnode);
-          affectedcarrier->dr_travelled += event->dr;
+          affectedcarrier->dr_travelled += _graph.dr(event);
           AddtoJumplengthdistro(event, dt);
           secondlevel = false;
 
@@ -367,7 +366,7 @@ void KMCLifetime::RunVSSM(ctp::Topology* top) {
   vector<ctp::Segment*>& seg = top->Segments();
 
   for (unsigned i = 0; i < seg.size(); i++) {
-    double occupationprobability = _nodes[i]->occupationtime / simtime;
+    double occupationprobability = _graph.OccupationTime(i) / simtime;
     seg[i]->setOcc(occupationprobability, _carriertype);
   }
   traj.close();
@@ -392,6 +391,7 @@ bool KMCLifetime::EvaluateFrame(ctp::Topology* top) {
   _RandomVariable.init(rand(), rand(), rand(), rand());
   LoadGraph(top);
   ReadLifetimeFile(_lifetimefile);
+  BuildGraph();
 
   if (_rates == "calculate") {
     cout << "Calculating rates (i.e. rates from state file are not used)."
@@ -17,6 +17,7 @@
 
 #include "kmcmultiple.h"
 #include <boost/format.hpp>
+#include <fstream>
 #include <locale>
 #include <votca/ctp/topology.h>
 #include <votca/tools/constants.h>
@@ -80,15 +81,50 @@ void KMCMultiple::Initialize(tools::Property* options) {
     dolengthdistributon = true;
   }
 
+  // a sweep is run if temperatures and/or field strengths are given
+  std::vector<double> temperatures;
+  std::vector<double> fields;
+  if (options->exists(key + ".sweep.temperatures")) {
+    temperatures =
+        options->get(key + ".sweep.temperatures").as<std::vector<double> >();
+  }
+  if (options->exists(key + ".sweep.fields")) {
+    fields = options->get(key + ".sweep.fields").as<std::vector<double> >();
+  }
+  if (!temperatures.empty() || !fields.empty()) {
+    if (temperatures.empty()) {
+      temperatures.push_back(_temperature);
+    }
+    if (fields.empty()) {
+      fields.push_back(tools::abs(_field) * mtonm);
+    }
+    _sweep_temperatures = temperatures;
+    _sweep_fields = fields;
+    _sweepfile = options->ifExistsReturnElseReturnDefault<std::string>(
+        key + ".sweep.resultfile", "sweep.csv");
+    if (_rates != "calculate") {
+      throw runtime_error(
+          "ERROR in kmcmultiple: a temperature/field sweep requires rates to "
+          "be calculated. Set rates to 'calculate'.");
+    }
+    for (double field : _sweep_fields) {
+      if (field != 0.0 && tools::abs(_field) == 0.0) {
+        throw runtime_error(
+            "ERROR in kmcmultiple: the field direction of the sweep is taken "
+            "from the field option, which is zero.");
+      }
+    }
+  }
+
   return;
 }
 
 void KMCMultiple::RunVSSM(ctp::Topology* top) {
 
   int realtime_start = time(NULL);
-  cout << endl << "Algorithm: VSSM for Multiple Charges" << endl;
-  cout << "number of charges: " << _numberofcharges << endl;
-  cout << "number of nodes: " << _nodes.size() << endl;
+  *_log << endl << "Algorithm: VSSM for Multiple Charges" << endl;
+  *_log << "number of charges: " << _numberofcharges << endl;
+  *_log << "number of nodes: " << _graph.NumberofNodes() << endl;
 
   bool checkifoutput = (_outputtime != 0);
   double nexttrajoutput = 0;
@@ -98,25 +134,25 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
   bool stopontime = false;
 
   if (_runtime > 100) {
-    cout << "stop condition: " << maxsteps << " steps." << endl;
+    *_log << "stop condition: " << maxsteps << " steps." << endl;
 
     if (checkifoutput) {
-      cout << "output frequency: ";
-      cout << "every " << outputstep << " steps." << endl;
+      *_log << "output frequency: ";
+      *_log << "every " << outputstep << " steps." << endl;
     }
   } else {
     stopontime = true;
-    cout << "stop condition: " << _runtime << " seconds runtime." << endl;
+    *_log << "stop condition: " << _runtime << " seconds runtime." << endl;
 
     if (checkifoutput) {
-      cout << "output frequency: ";
-      cout << "every " << _outputtime << " seconds." << endl;
+      *_log << "output frequency: ";
+      *_log << "every " << _outputtime << " seconds." << endl;
     }
   }
-  cout << "(If you specify runtimes larger than 100 kmcmultiple assumes that "
-          "you are specifying the number of steps for both runtime and "
-          "outputtime.)"
-       << endl;
+  *_log << "(If you specify runtimes larger than 100 kmcmultiple assumes that "
+           "you are specifying the number of steps for both runtime and "
+           "outputtime.)"
+        << endl;
 
   if (!stopontime && _outputtime != 0 && floor(_outputtime) != _outputtime) {
     throw runtime_error(
@@ -125,7 +161,7 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
         "both input parameters.");
   }
 
-  if (_numberofcharges > _nodes.size()) {
+  if (int(_numberofcharges) > _graph.NumberofNodes()) {
     throw runtime_error(
         "ERROR in kmcmultiple: specified number of charges is greater than the "
         "number of nodes. This conflicts with single occupation.");
@@ -136,7 +172,7 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
 
   if (checkifoutput) {
 
-    cout << "Writing trajectory to " << _trajectoryfile << "." << endl;
+    *_log << "Writing trajectory to " << _trajectoryfile << "." << endl;
     traj.open(_trajectoryfile.c_str(), fstream::out);
 
     traj << "'time[s]'\t";
@@ -151,8 +187,8 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
     }
     traj << endl;
 
-    cout << "Writing time dependence of energy and mobility to " << _timefile
-         << "." << endl;
+    *_log << "Writing time dependence of energy and mobility to " << _timefile
+          << "." << endl;
     tfile.open(_timefile.c_str(), fstream::out);
     tfile << "time[s]\t "
              "steps\tenergy_per_carrier[eV]\tmobility[nm**2/"
@@ -195,11 +231,11 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
           (!stopontime && step < maxsteps))) {
 
     if ((time(NULL) - realtime_start) > _maxrealtime * 60. * 60.) {
-      cout << endl
-           << "Real time limit of " << _maxrealtime << " hours ("
-           << int(_maxrealtime * 60 * 60 + 0.5)
-           << " seconds) has been reached. Stopping here." << endl
-           << endl;
+      *_log << endl
+            << "Real time limit of " << _maxrealtime << " hours ("
+            << int(_maxrealtime * 60 * 60 + 0.5)
+            << " seconds) has been reached. Stopping here." << endl
+            << endl;
       break;
     }
 
@@ -219,7 +255,7 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
     simtime += dt;
     step++;
     if (tools::globals::verbose) {
-      cout << "simtime += " << dt << endl << endl;
+      *_log << "simtime += " << dt << endl << endl;
     }
 
     for (unsigned int i = 0; i < _numberofcharges; i++) {
@@ -232,7 +268,7 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
 
       // determine which electron will escape
 
-      GNode* newnode = NULL;
+      int newnode = -1;
       Chargecarrier* affectedcarrier = ChooseAffectedCarrier(cumulated_rate);
 
       if (CheckForbidden(affectedcarrier->getCurrentNodeId(), forbiddennodes)) {
@@ -243,26 +279,27 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
       ResetForbiddenlist(forbiddendests);
       while (true) {
         // LEVEL 2
+        const int node = affectedcarrier->getCurrentNodeId();
         if (tools::globals::verbose) {
-          cout << "There are "
-               << affectedcarrier->getCurrentNode()->events.size()
-               << " possible jumps for this charge:";
+          *_log << "There are "
+                << _graph.EventsEnd(node) - _graph.EventsBegin(node)
+                << " possible jumps for this charge:";
         }
 
-        GLink* event = ChooseHoppingDest(affectedcarrier->getCurrentNode());
-        newnode = _nodes[event->destination];
-        if (newnode == affectedcarrier->getCurrentNode()) {
-          cout << event->dr << endl;
+        int event = ChooseHoppingDest(node);
+        newnode = _graph.Destination(event);
+        if (newnode == node) {
+          *_log << _graph.dr(event) << endl;
         }
 
-        if (newnode == NULL) {
+        if (newnode < 0) {
           if (tools::globals::verbose) {
-            cout << endl
-                 << "Node " << affectedcarrier->getCurrentNodeId() + 1
-                 << " is SURROUNDED by forbidden destinations and zero rates. "
-                    "Adding it to the list of forbidden nodes. After that: "
-                    "selection of a new escape node."
-                 << endl;
+            *_log << endl
+                  << "Node " << affectedcarrier->getCurrentNodeId() + 1
+                  << " is SURROUNDED by forbidden destinations and zero rates. "
+                     "Adding it to the list of forbidden nodes. After that: "
+                     "selection of a new escape node."
+                  << endl;
           }
           AddtoForbiddenlist(affectedcarrier->getCurrentNodeId(),
                              forbiddennodes);
@@ -270,30 +307,29 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
                   // level1step to 1)
         }
         if (tools::globals::verbose) {
-          cout << endl << "Selected jump: " << newnode->id + 1 << endl;
+          *_log << endl << "Selected jump: " << newnode + 1 << endl;
         }
 
         // check after the event if this was allowed
-        if (CheckForbidden(newnode->id, forbiddendests)) {
+        if (CheckForbidden(newnode, forbiddendests)) {
           if (tools::globals::verbose) {
-            cout << "Node " << newnode->id + 1
-                 << " is FORBIDDEN. Now selection new hopping destination."
-                 << endl;
+            *_log << "Node " << newnode + 1
+                  << " is FORBIDDEN. Now selection new hopping destination."
+                  << endl;
           }
           continue;
         }
 
         // if the new segment is unoccupied: jump; if not: add to forbidden list
         // and choose new hopping destination
-        if (newnode->occupied) {
-          if (CheckSurrounded(affectedcarrier->getCurrentNode(),
-                              forbiddendests)) {
+        if (_graph.isOccupied(newnode)) {
+          if (CheckSurrounded(node, forbiddendests)) {
             if (tools::globals::verbose) {
-              cout << "Node " << affectedcarrier->getCurrentNodeId() + 1
-                   << " is SURROUNDED by forbidden destinations. "
-                      "Adding it to the list of forbidden nodes. After that: "
-                      "selection of a new escape node."
-                   << endl;
+              *_log << "Node " << affectedcarrier->getCurrentNodeId() + 1
+                    << " is SURROUNDED by forbidden destinations. "
+                       "Adding it to the list of forbidden nodes. After that: "
+                       "selection of a new escape node."
+                    << endl;
             }
             AddtoForbiddenlist(affectedcarrier->getCurrentNodeId(),
                                forbiddennodes);
@@ -301,23 +337,23 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
                     // level1step to 1)
           }
           if (tools::globals::verbose) {
-            cout << "Selected segment: " << newnode->id + 1
-                 << " is already OCCUPIED. Added to forbidden list." << endl
-                 << endl;
+            *_log << "Selected segment: " << newnode + 1
+                  << " is already OCCUPIED. Added to forbidden list." << endl
+                  << endl;
           }
-          AddtoForbiddenlist(newnode->id, forbiddendests);
+          AddtoForbiddenlist(newnode, forbiddendests);
           if (tools::globals::verbose) {
-            cout << "Now choosing different hopping destination." << endl;
+            *_log << "Now choosing different hopping destination." << endl;
           }
           continue;  // select new destination
         } else {
           affectedcarrier->jumpfromCurrentNodetoNode(newnode);
-          affectedcarrier->dr_travelled += event->dr;
+          affectedcarrier->dr_travelled += _graph.dr(event);
           AddtoJumplengthdistro(event, dt);
           level1step = false;
           if (tools::globals::verbose) {
-            cout << "Charge has jumped to segment: " << newnode->id + 1 << "."
-                 << endl;
+            *_log << "Charge has jumped to segment: " << newnode + 1 << "."
+                  << endl;
           }
 
           break;  // this ends LEVEL 2 , so that the time is updated and the
@@ -325,7 +361,7 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
         }
 
         if (tools::globals::verbose) {
-          cout << "." << endl;
+          *_log << "." << endl;
         }
         // END LEVEL 2
       }
@@ -348,25 +384,26 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
         tools::matrix result =
             avgdiffusiontensor /
             (diffusionsteps * 2 * simtime * _numberofcharges);
-        cout << endl
-             << "Step: " << step
-             << " Diffusion tensor averaged over all carriers (nm^2/s):" << endl
-             << result << endl;
+        *_log << endl
+              << "Step: " << step
+              << " Diffusion tensor averaged over all carriers (nm^2/s):"
+              << endl
+              << result << endl;
       } else {
         double average_mobility = 0;
-        cout << endl << "Mobilities (nm^2/Vs): " << endl;
+        *_log << endl << "Mobilities (nm^2/Vs): " << endl;
         for (unsigned int i = 0; i < _numberofcharges; i++) {
           tools::vec velocity = _carriers[i]->dr_travelled / simtime;
-          cout << std::scientific << "    charge " << i + 1 << ": mu="
-               << (velocity * _field) / (absolute_field * absolute_field)
-               << endl;
+          *_log << std::scientific << "    charge " << i + 1 << ": mu="
+                << (velocity * _field) / (absolute_field * absolute_field)
+                << endl;
           average_mobility +=
               (velocity * _field) / (absolute_field * absolute_field);
         }
         average_mobility /= _numberofcharges;
-        cout << std::scientific
-             << "  Overall average mobility in field direction <mu>="
-             << average_mobility << " nm^2/Vs  " << endl;
+        *_log << std::scientific
+              << "  Overall average mobility in field direction <mu>="
+              << average_mobility << " nm^2/Vs  " << endl;
       }
     }
 
@@ -422,87 +459,94 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
     tfile.close();
   }
 
-  vector<ctp::Segment*>& seg = top->Segments();
-  for (unsigned i = 0; i < seg.size(); i++) {
-    double occupationprobability = _nodes[i]->occupationtime / simtime;
-    seg[i]->setOcc(occupationprobability, _carriertype);
+  // sweep points run concurrently and must not write into the topology
+  if (!_is_sweep_worker) {
+    vector<ctp::Segment*>& seg = top->Segments();
+    for (unsigned i = 0; i < seg.size(); i++) {
+      double occupationprobability = _graph.OccupationTime(i) / simtime;
+      seg[i]->setOcc(occupationprobability, _carriertype);
+    }
   }
 
-  cout << endl << "finished KMC simulation after " << step << " steps." << endl;
-  cout << "simulated time " << simtime << " seconds." << endl;
-  cout << "runtime: ";
-  cout << endl << endl;
+  *_log << endl
+        << "finished KMC simulation after " << step << " steps." << endl;
+  *_log << "simulated time " << simtime << " seconds." << endl;
+  *_log << "runtime: ";
+  *_log << endl << endl;
 
   tools::vec avg_dr_travelled = tools::vec(0, 0, 0);
   for (unsigned int i = 0; i < _numberofcharges; i++) {
-    cout << std::scientific << "    charge " << i + 1 << ": "
-         << _carriers[i]->dr_travelled / simtime << endl;
+    *_log << std::scientific << "    charge " << i + 1 << ": "
+          << _carriers[i]->dr_travelled / simtime << endl;
     avg_dr_travelled += _carriers[i]->dr_travelled;
   }
   avg_dr_travelled /= _numberofcharges;
 
   tools::vec avgvelocity = avg_dr_travelled / simtime;
-  cout << std::scientific
-       << "  Overall average velocity (nm/s): " << avgvelocity << endl;
+  _result_velocity = avgvelocity;
+  _result_mobility = 0.0;
+  *_log << std::scientific
+        << "  Overall average velocity (nm/s): " << avgvelocity << endl;
 
-  cout << endl << "Distances travelled (nm): " << endl;
+  *_log << endl << "Distances travelled (nm): " << endl;
   for (unsigned int i = 0; i < _numberofcharges; i++) {
-    cout << std::scientific << "    charge " << i + 1 << ": "
-         << _carriers[i]->dr_travelled << endl;
+    *_log << std::scientific << "    charge " << i + 1 << ": "
+          << _carriers[i]->dr_travelled << endl;
   }
 
   // calculate mobilities
 
   if (absolute_field != 0) {
     double average_mobility = 0;
-    cout << endl << "Mobilities (nm^2/Vs): " << endl;
+    *_log << endl << "Mobilities (nm^2/Vs): " << endl;
     for (unsigned int i = 0; i < _numberofcharges; i++) {
       tools::vec velocity = _carriers[i]->dr_travelled / simtime;
-      cout << std::scientific << "    charge " << i + 1
-           << ": mu=" << (velocity * _field) / (absolute_field * absolute_field)
-           << endl;
+      *_log << std::scientific << "    charge " << i + 1 << ": mu="
+            << (velocity * _field) / (absolute_field * absolute_field) << endl;
       average_mobility +=
           (velocity * _field) / (absolute_field * absolute_field);
     }
     average_mobility /= _numberofcharges;
-    cout << std::scientific
-         << "  Overall average mobility in field direction <mu>="
-         << average_mobility << " nm^2/Vs  " << endl;
+    _result_mobility = average_mobility;
+    *_log << std::scientific
+          << "  Overall average mobility in field direction <mu>="
+          << average_mobility << " nm^2/Vs  " << endl;
   }
-  cout << endl;
+  *_log << endl;
 
   // calculate diffusion tensor
   unsigned long diffusionsteps = step / diffusionresolution;
   avgdiffusiontensor /= (diffusionsteps * 2 * simtime * _numberofcharges);
-  cout << endl
-       << "Diffusion tensor averaged over all carriers (nm^2/s):" << endl
-       << avgdiffusiontensor << endl;
+  *_log << endl
+        << "Diffusion tensor averaged over all carriers (nm^2/s):" << endl
+        << avgdiffusiontensor << endl;
 
   tools::matrix::eigensystem_t diff_tensor_eigensystem;
-  cout << endl << "Eigenvalues: " << endl << endl;
+  *_log << endl << "Eigenvalues: " << endl << endl;
   avgdiffusiontensor.SolveEigensystem(diff_tensor_eigensystem);
   for (int i = 0; i <= 2; i++) {
-    cout << "Eigenvalue: " << diff_tensor_eigensystem.eigenvalues[i] << endl
-         << "Eigenvector: ";
+    *_log << "Eigenvalue: " << diff_tensor_eigensystem.eigenvalues[i] << endl
+          << "Eigenvector: ";
 
-    cout << diff_tensor_eigensystem.eigenvecs[i].x() << "   ";
-    cout << diff_tensor_eigensystem.eigenvecs[i].y() << "   ";
-    cout << diff_tensor_eigensystem.eigenvecs[i].z() << endl << endl;
+    *_log << diff_tensor_eigensystem.eigenvecs[i].x() << "   ";
+    *_log << diff_tensor_eigensystem.eigenvecs[i].y() << "   ";
+    *_log << diff_tensor_eigensystem.eigenvecs[i].z() << endl << endl;
   }
 
   // calculate average mobility from the Einstein relation
   if (absolute_field == 0) {
-    cout << "The following value is calculated using the Einstein relation and "
-            "assuming an isotropic medium"
-         << endl;
+    *_log << "The following value is calculated using the Einstein relation "
+             "and assuming an isotropic medium"
+          << endl;
     double avgD = 1. / 3. *
                   (diff_tensor_eigensystem.eigenvalues[0] +
                    diff_tensor_eigensystem.eigenvalues[1] +
                    diff_tensor_eigensystem.eigenvalues[2]);
     double average_mobility = std::abs(avgD / tools::conv::kB / _temperature);
-    cout << std::scientific
-         << "  Overall average mobility <mu>=" << average_mobility
-         << " nm^2/Vs " << endl;
+    _result_mobility = average_mobility;
+    *_log << std::scientific
+          << "  Overall average mobility <mu>=" << average_mobility
+          << " nm^2/Vs " << endl;
   }
 
   PrintJumplengthdistro();
@@ -510,6 +554,129 @@ void KMCMultiple::RunVSSM(ctp::Topology* top) {
   return;
 }
 
+void KMCMultiple::InitSweepWorker(const KMCMultiple& master) {
+  _is_sweep_worker = true;
+  _carriertype = master._carriertype;
+  _injection_name = master._injection_name;
+  _injectionmethod = master._injectionmethod;
+  _numberofcharges = master._numberofcharges;
+  _rates = master._rates;
+  _seed = master._seed;
+  _runtime = master._runtime;
+  _outputtime = master._outputtime;
+  _maxrealtime = master._maxrealtime;
+  _intermediateoutput_frequency = master._intermediateoutput_frequency;
+  lengthdistribution = master.lengthdistribution;
+  dolengthdistributon = master.dolengthdistributon;
+  lengthresolution = master.lengthresolution;
+  minlength = master.minlength;
+  _ratetable = master._ratetable;
+  _graph = master._graph;
+  return;
+}
+
+void KMCMultiple::ResetSweepWorker() {
+  for (auto& carrier : _carriers) {
+    delete carrier;
+  }
+  _carriers.clear();
+  _graph.ResetOccupation();
+  _jumplengthdistro = std::vector<long unsigned>(lengthdistribution, 0);
+  _jumplengthdistro_weighted = std::vector<double>(lengthdistribution, 0);
+  return;
+}
+
+void KMCMultiple::RunSweep(ctp::Topology* top) {
+  // the graph and the temperature/field independent part of the rates are
+  // set up once, every worker thread gets a copy of the graph and only
+  // updates the cumulative tables of nodes whose rates changed between its
+  // points
+  LoadGraph(top);
+  BuildGraph();
+  BuildRateTable();
+
+  struct SweepPoint {
+    double temperature;
+    double field;
+    int seeds[4];
+    tools::vec velocity;
+    double mobility;
+  };
+
+  std::vector<SweepPoint> points;
+  srand(_seed);
+  for (double temperature : _sweep_temperatures) {
+    for (double field : _sweep_fields) {
+      SweepPoint point;
+      point.temperature = temperature;
+      point.field = field;
+      for (int i = 0; i < 4; i++) {
+        point.seeds[i] = rand();
+      }
+      points.push_back(point);
+    }
+  }
+
+  tools::vec direction = tools::vec(0, 0, 0);
+  if (tools::abs(_field) > 0) {
+    direction = _field / tools::abs(_field);
+  }
+  const double mtonm = 1E9;
+  const int npoints = points.size();
+  const int nworkers = std::max(1, std::min(_nThreads, npoints));
+  cout << "Sweeping " << npoints << " temperature/field points with "
+       << nworkers << " threads. Output of each point is written to "
+       << "kmcmultiple_T<temperature>_F<field>.log" << endl;
+
+#pragma omp parallel num_threads(nworkers)
+  {
+    KMCMultiple worker;
+    worker.InitSweepWorker(*this);
+#pragma omp for schedule(dynamic)
+    for (int p = 0; p < npoints; p++) {
+      SweepPoint& point = points[p];
+      std::string tag =
+          (boost::format("_T%g_F%g") % point.temperature % point.field).str();
+      auto tagged = [&tag](const std::string& filename) {
+        std::size_t dot = filename.find_last_of('.');
+        if (dot == std::string::npos) {
+          return filename + tag;
+        }
+        return filename.substr(0, dot) + tag + filename.substr(dot);
+      };
+      std::ofstream log(("kmcmultiple" + tag + ".log").c_str());
+      worker._log = &log;
+      worker._trajectoryfile = tagged(_trajectoryfile);
+      worker._timefile = tagged(_timefile);
+      worker._temperature = point.temperature;
+      worker._field = direction * (point.field / mtonm);
+      worker.ResetSweepWorker();
+      int rebuilt = worker.UpdateRates(
+          worker.CalculateRates(worker._temperature, worker._field));
+      log << "Updated hopping tables of " << rebuilt << " nodes." << endl;
+      worker._RandomVariable.init(point.seeds[0], point.seeds[1],
+                                  point.seeds[2], point.seeds[3]);
+      worker.RunVSSM(top);
+      point.velocity = worker._result_velocity;
+      point.mobility = worker._result_mobility;
+      worker._log = &std::cout;
+    }
+  }
+
+  cout << "Writing sweep results to " << _sweepfile << endl;
+  std::ofstream sweep(_sweepfile.c_str());
+  sweep << "temperature[K]\tfield[V/m]\tvelocity_x[nm/s]\tvelocity_y[nm/s]\t"
+           "velocity_z[nm/s]\tmobility[nm**2/Vs]"
+        << endl;
+  for (const SweepPoint& point : points) {
+    sweep << std::scientific << point.temperature << "\t" << point.field
+          << "\t" << point.velocity.getX() << "\t" << point.velocity.getY()
+          << "\t" << point.velocity.getZ() << "\t" << point.mobility << endl;
+  }
+  sweep.close();
+  return;
+}
+
 bool KMCMultiple::EvaluateFrame(ctp::Topology* top) {
   std::cout << std::endl;
   std::cout << "-----------------------------------" << std::endl;
@@ -525,7 +692,13 @@ bool KMCMultiple::EvaluateFrame(ctp::Topology* top) {
   _RandomVariable = tools::Random2();
   _RandomVariable.init(rand(), rand(), rand(), rand());
 
+  if (!_sweep_temperatures.empty()) {
+    RunSweep(top);
+    return true;
+  }
+
   LoadGraph(top);
+  BuildGraph();
 
   if (_rates == "calculate") {
     cout << "Calculating rates (i.e. rates from state file are not used)."
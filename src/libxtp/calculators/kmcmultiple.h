@@ -43,12 +43,25 @@ class KMCMultiple : public KMCCalculator {
 
  private:
   void RunVSSM(ctp::Topology *top);
+  void RunSweep(ctp::Topology *top);
+  void InitSweepWorker(const KMCMultiple &master);
+  void ResetSweepWorker();
+
   double _runtime;
   double _outputtime;
   std::string _trajectoryfile;
   std::string _timefile;
   double _maxrealtime;
   int _intermediateoutput_frequency;
+
+  // temperature/field sweep, fields are magnitudes along _field in V/m
+  std::vector<double> _sweep_temperatures;
+  std::vector<double> _sweep_fields;
+  std::string _sweepfile;
+  bool _is_sweep_worker = false;
+
+  tools::vec _result_velocity;
+  double _result_mobility;
 };
 
 }  // namespace xtp
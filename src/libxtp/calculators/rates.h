@@ -23,6 +23,7 @@
 #include <cmath>
 #include <complex>
 #include <votca/ctp/paircalculator.h>
+#include <votca/xtp/eigen.h>
 //#include <boost/math/special_functions/gamma.hpp>
 
 namespace votca {
@@ -37,10 +38,36 @@ class Rates : public ctp::PairCalculator2 {
 
   void Initialize(tools::Property *options);
   void ParseEnergiesXML(ctp::Topology *top, tools::Property *opt);
+  bool EvaluateFrame(ctp::Topology *top);
   void EvaluatePair(ctp::Topology *top, ctp::QMPair *pair);
   void CalculateRate(ctp::Topology *top, ctp::QMPair *pair, int state);
 
  private:
+  // structure of arrays of all pairs of one state, marcus and jortner rates
+  // are evaluated for all of them at once
+  struct PairBatch {
+    int state;
+    std::vector<ctp::QMPair *> pairs;
+    Eigen::ArrayXd reorg12;
+    Eigen::ArrayXd reorg21;
+    Eigen::ArrayXd dG;
+    Eigen::ArrayXd lOut;
+    Eigen::ArrayXd J2;
+    Eigen::ArrayXd rate12;
+    Eigen::ArrayXd rate21;
+  };
+
+  bool isBatched() const {
+    return _rateType == "marcus" || _rateType == "jortner";
+  }
+  void GatherBatch(PairBatch &batch) const;
+  void EvaluateBatch(PairBatch &batch) const;
+  void MarcusRates(PairBatch &batch, int start, int size) const;
+  void JortnerRates(PairBatch &batch, int start, int size) const;
+  void ScatterBatch(const PairBatch &batch) const;
+
+  std::vector<PairBatch> _batches;
+
   std::map<std::string, double> _seg_U_cC_nN_e;
   std::map<std::string, double> _seg_U_nC_nN_e;
   std::map<std::string, double> _seg_U_cN_cC_e;
@@ -328,8 +355,178 @@ void Rates::ParseEnergiesXML(ctp::Topology *top, tools::Property *opt) {
   }
 }
 
+bool Rates::EvaluateFrame(ctp::Topology *top) {
+  _batches.clear();
+  if (isBatched()) {
+    const int states[4] = {-1, +1, +2, +3};
+    for (int state : states) {
+      PairBatch batch;
+      batch.state = state;
+      _batches.push_back(batch);
+    }
+  }
+  // in batched mode EvaluatePair only collects the pairs
+  bool result = ctp::PairCalculator2::EvaluateFrame(top);
+
+  for (PairBatch &batch : _batches) {
+    if (batch.pairs.empty()) {
+      continue;
+    }
+    std::cout << "\r... ... Evaluating " << batch.pairs.size()
+              << " pairs for state " << batch.state << ". " << std::flush;
+    GatherBatch(batch);
+    EvaluateBatch(batch);
+    ScatterBatch(batch);
+  }
+  _batches.clear();
+  return result;
+}
+
+void Rates::GatherBatch(PairBatch &batch) const {
+  const double NM2M = 1.e-9;
+  const int state = batch.state;
+  const int size = batch.pairs.size();
+  batch.reorg12.resize(size);
+  batch.reorg21.resize(size);
+  batch.dG.resize(size);
+  batch.lOut.resize(size);
+  batch.J2.resize(size);
+
+  for (int i = 0; i < size; i++) {
+    ctp::QMPair *qmpair = batch.pairs[i];
+    ctp::Segment *seg1 = qmpair->first;
+    ctp::Segment *seg2 = qmpair->second;
+    double dG_Site = 0;
+    double dG_Field = 0;
+    if (state < 2) {
+      batch.reorg12(i) = seg1->getU_nC_nN(state) + seg2->getU_cN_cC(state);
+      batch.reorg21(i) = seg1->getU_cN_cC(state) + seg2->getU_nC_nN(state);
+      dG_Site = seg2->getU_cC_nN(state) + seg2->getEMpoles(state) -
+                seg1->getU_cC_nN(state) - seg1->getEMpoles(state);
+      dG_Field = -state * _F * qmpair->R() * NM2M;
+    } else {
+      batch.reorg12(i) = seg1->getU_nX_nN(state) + seg2->getU_xN_xX(state);
+      batch.reorg21(i) = seg1->getU_xN_xX(state) + seg2->getU_nX_nN(state);
+      dG_Site = seg2->getU_xX_nN(state) + seg2->getEMpoles(state) -
+                seg1->getU_xX_nN(state) - seg1->getEMpoles(state);
+    }
+    batch.dG(i) = dG_Field + dG_Site;
+    batch.lOut(i) = qmpair->getLambdaO(state);
+    batch.J2(i) = qmpair->getJeff2(state);
+
+    if (_rateType == "jortner" && batch.lOut(i) < 0.) {
+      std::cout << std::endl
+                << "... ... ERROR: Pair " << qmpair->getId()
+                << " has negative "
+                   "outer-sphere reorganization energy. Cannot calculate "
+                   "Jortner rates. "
+                << std::endl;
+      throw std::runtime_error("");
+    } else if (_rateType == "jortner" && batch.lOut(i) < 0.01) {
+      std::cout << std::endl
+                << "... ... WARNING: Pair " << qmpair->getId()
+                << " has small "
+                   "outer-sphere reorganization energy ("
+                << batch.lOut(i)
+                << "eV). Could "
+                   "lead to over-estimated Jortner rates."
+                << std::endl;
+    }
+  }
+  batch.rate12 = Eigen::ArrayXd::Zero(size);
+  batch.rate21 = Eigen::ArrayXd::Zero(size);
+}
+
+void Rates::EvaluateBatch(PairBatch &batch) const {
+  // blocks are small enough to stay in cache and are distributed over threads
+  const int blocksize = 1024;
+  const int size = batch.pairs.size();
+  const int nblocks = (size + blocksize - 1) / blocksize;
+#pragma omp parallel for num_threads(_nThreads) schedule(dynamic)
+  for (int block = 0; block < nblocks; block++) {
+    int start = block * blocksize;
+    int length = std::min(blocksize, size - start);
+    if (_rateType == "jortner") {
+      JortnerRates(batch, start, length);
+    } else {
+      MarcusRates(batch, start, length);
+    }
+  }
+}
+
+void Rates::MarcusRates(PairBatch &batch, int start, int size) const {
+  const double hbar_eV = 6.58211899e-16;
+  const Eigen::ArrayXd J2 = batch.J2.segment(start, size);
+  const Eigen::ArrayXd dG = batch.dG.segment(start, size);
+  const Eigen::ArrayXd reorg12 =
+      batch.reorg12.segment(start, size) + batch.lOut.segment(start, size);
+  const Eigen::ArrayXd reorg21 =
+      batch.reorg21.segment(start, size) + batch.lOut.segment(start, size);
+
+  batch.rate12.segment(start, size) =
+      J2 / hbar_eV * (M_PI / (reorg12 * _kT)).sqrt() *
+      (-(dG + reorg12).square() / (4 * _kT * reorg12)).exp();
+  batch.rate21.segment(start, size) =
+      J2 / hbar_eV * (M_PI / (reorg21 * _kT)).sqrt() *
+      (-(-dG + reorg21).square() / (4 * _kT * reorg21)).exp();
+}
+
+void Rates::JortnerRates(PairBatch &batch, int start, int size) const {
+  const double hbar_eV = 6.58211899e-16;
+  const Eigen::ArrayXd dG = batch.dG.segment(start, size);
+  const Eigen::ArrayXd lOut = batch.lOut.segment(start, size);
+  const Eigen::ArrayXd prefactor = batch.J2.segment(start, size) / hbar_eV *
+                                   (M_PI / (lOut * _kT)).sqrt();
+  const Eigen::ArrayXd huang_rhys12 = batch.reorg12.segment(start, size) /
+                                      _omegaVib;
+  const Eigen::ArrayXd huang_rhys21 = batch.reorg21.segment(start, size) /
+                                      _omegaVib;
+  const Eigen::ArrayXd log_hr12 = huang_rhys12.log();
+  const Eigen::ArrayXd log_hr21 = huang_rhys21.log();
+  const Eigen::ArrayXd denom = 4 * _kT * lOut;
+
+  // the Poisson weights exp(-S) S^n / n! are summed in log space, so that
+  // large nmaxvib neither overflows n! nor S^n
+  Eigen::ArrayXd sum12 = Eigen::ArrayXd::Zero(size);
+  Eigen::ArrayXd sum21 = Eigen::ArrayXd::Zero(size);
+  for (int nvib = 0; nvib <= _nMaxVib; nvib++) {
+    const double logfactorial = std::lgamma(nvib + 1.0);
+    const double vib = nvib * _omegaVib;
+    Eigen::ArrayXd exponent12 =
+        -huang_rhys12 - logfactorial - (dG + vib + lOut).square() / denom;
+    Eigen::ArrayXd exponent21 =
+        -huang_rhys21 - logfactorial - (-dG + vib + lOut).square() / denom;
+    if (nvib > 0) {
+      exponent12 += nvib * log_hr12;
+      exponent21 += nvib * log_hr21;
+    }
+    sum12 += exponent12.exp();
+    sum21 += exponent21.exp();
+  }
+  batch.rate12.segment(start, size) = prefactor * sum12;
+  batch.rate21.segment(start, size) = prefactor * sum21;
+}
+
+void Rates::ScatterBatch(const PairBatch &batch) const {
+  for (unsigned i = 0; i < batch.pairs.size(); i++) {
+    ctp::QMPair *qmpair = batch.pairs[i];
+    qmpair->setRate12(batch.rate12(i), batch.state);
+    qmpair->setRate21(batch.rate21(i), batch.state);
+    qmpair->setIsPathCarrier(true, batch.state);
+  }
+}
+
 void Rates::EvaluatePair(ctp::Topology *top, ctp::QMPair *qmpair) {
 
+  if (!_batches.empty()) {
+    for (PairBatch &batch : _batches) {
+      if (qmpair->isPathCarrier(batch.state)) {
+        batch.pairs.push_back(qmpair);
+      }
+    }
+    return;
+  }
+
   std::cout << "\r... ... Evaluating pair " << qmpair->getId() + 1 << ". "
             << std::flush;
 
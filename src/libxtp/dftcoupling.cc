@@ -17,7 +17,6 @@
  *
  */
 
-#include <votca/xtp/aomatrix.h>
 #include <votca/xtp/dftcoupling.h>
 
 #include <boost/format.hpp>
@@ -179,38 +178,13 @@ void DFTcoupling::CalculateCouplings(const Orbitals& orbitalsA,
         "No information about number of occupied/unoccupied levels is stored");
   }
 
-  //       | Orbitals_A          0 |      | Overlap_A |
-  //       | 0          Orbitals_B |.T  X   | Overlap_B |  X  ( Orbitals_AB )
-
-  Eigen::MatrixXd psi_AxB =
-      Eigen::MatrixXd::Zero(basisA + basisB, levelsA + levelsB);
-
-  CTP_LOG(ctp::logDEBUG, *_pLog)
-      << "Constructing direct product AxB [" << psi_AxB.rows() << "x"
-      << psi_AxB.cols() << "]" << flush;
-
-  // constructing merged orbitals
-  psi_AxB.block(0, 0, basisA, levelsA) = orbitalsA.MOCoefficients().block(
-      0, Range_orbA.first, basisA, Range_orbA.second);
-  psi_AxB.block(basisA, levelsA, basisB, levelsB) =
-      orbitalsB.MOCoefficients().block(0, Range_orbB.first, basisB,
-                                       Range_orbB.second);
-
-  Eigen::MatrixXd overlap;
-  if (orbitalsAB.hasAOOverlap()) {
-    CTP_LOG(ctp::logDEBUG, *_pLog)
-        << "Reading overlap matrix from orbitals" << flush;
-    overlap = orbitalsAB.AOOverlap();
-  } else {
-    CTP_LOG(ctp::logDEBUG, *_pLog)
-        << "Calculating overlap matrix for basisset: "
-        << orbitalsAB.getDFTbasisName() << flush;
-    overlap = CalculateOverlapMatrix(orbitalsAB);
-  }
   CTP_LOG(ctp::logDEBUG, *_pLog)
       << "Projecting dimer onto monomer orbitals" << flush;
+  const DimerProjection& projection =
+      getDimerProjection(orbitalsA, orbitalsB, orbitalsAB);
   Eigen::MatrixXd psi_AxB_dimer_basis =
-      psi_AxB.transpose() * overlap * orbitalsAB.MOCoefficients();
+      projection.Project(orbitalsA, orbitalsB, orbitalsAB, Range_orbA.first,
+                         levelsA, Range_orbB.first, levelsB);
 
   unsigned int LevelsA = levelsA;
   for (unsigned i = 0; i < psi_AxB_dimer_basis.rows(); i++) {
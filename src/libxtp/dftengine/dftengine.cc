@@ -22,13 +22,17 @@
 #include "votca/xtp/qminterface.h"
 #include <votca/xtp/dftengine.h>
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <boost/math/constants/constants.hpp>
+#include <cmath>
 #include <votca/ctp/xinteractor.h>
 #include <votca/tools/constants.h>
 #include <votca/tools/elements.h>
+#include <votca/tools/tokenizer.h>
 #include <votca/xtp/aomatrix.h>
+#include <votca/xtp/atomicguesslibrary.h>
 #include <votca/xtp/orbitals.h>
 #include <votca/xtp/qmpackagefactory.h>
 
@@ -40,6 +44,38 @@ using namespace votca::tools;
 namespace votca {
 namespace xtp {
 
+namespace {
+
+// sets up the grid of the next ladder level while the SCF iterates. The SCF
+// keeps all its threads, so the setup runs on a few threads of its own.
+class GridSetupThread : public tools::Thread {
+ public:
+  GridSetupThread(NumericalIntegration& grid, const string& grid_name,
+                  const std::vector<QMAtom*>& atoms, const AOBasis& basis,
+                  int threads)
+      : _grid(grid),
+        _grid_name(grid_name),
+        _atoms(atoms),
+        _basis(basis),
+        _threads(threads) {}
+
+  void Run() {
+#ifdef _OPENMP
+    omp_set_num_threads(_threads);
+#endif
+    _grid.GridSetup(_grid_name, _atoms, _basis);
+  }
+
+ private:
+  NumericalIntegration& _grid;
+  string _grid_name;
+  const std::vector<QMAtom*>& _atoms;
+  const AOBasis& _basis;
+  int _threads;
+};
+
+}  // namespace
+
 void DFTEngine::Initialize(Property& options) {
 
   string key = "package";
@@ -69,6 +105,14 @@ void DFTEngine::Initialize(Property& options) {
         key + ".screening_eps", 1e-9);
   }
 
+  _farfield_accuracy = options.ifExistsReturnElseReturnDefault<double>(
+      key + ".farfield_accuracy", 0.0);
+
+  _mixed_precision = options.ifExistsReturnElseReturnDefault<bool>(
+      key + ".mixed_precision", false);
+  _mixed_precision_error = options.ifExistsReturnElseReturnDefault<double>(
+      key + ".mixed_precision_error", 1e-3);
+
   if (options.exists(key + ".ecp")) {
     _ecp_name = options.get(key + ".ecp").as<string>();
     _with_ecp = true;
@@ -79,12 +123,24 @@ void DFTEngine::Initialize(Property& options) {
       options.ifExistsReturnElseReturnDefault<bool>(key + ".read_guess", false);
   _initial_guess = options.ifExistsReturnElseReturnDefault<string>(
       key + ".initial_guess", "atom");
+  _atomic_guess_cache = options.ifExistsReturnElseReturnDefault<string>(
+      key + ".atomic_guess_cache", "");
 
   _grid_name = options.ifExistsReturnElseReturnDefault<string>(
       key + ".integration_grid", "medium");
-  _use_small_grid = options.ifExistsReturnElseReturnDefault<bool>(
-      key + ".integration_grid_small", true);
-  _grid_name_small = ReturnSmallGrid(_grid_name);
+  if (options.ifExistsReturnElseReturnDefault<bool>(
+          key + ".integration_grid_small", true)) {
+    _grid_ladder =
+        ReturnGridLadder(options.ifExistsReturnElseReturnDefault<string>(
+            key + ".integration_grid_ladder", ""));
+  } else {
+    _grid_ladder = {_grid_name};
+  }
+  _grid_switch_error = options.ifExistsReturnElseReturnDefault<double>(
+      key + ".integration_grid_switch_error", 1e-3);
+  _grid_setup_threads = std::max(
+      1, options.ifExistsReturnElseReturnDefault<int>(
+             key + ".integration_grid_setup_threads", 1));
   _xc_functional_name = options.ifExistsReturnElseThrowRuntimeError<string>(
       key + ".xc_functional");
 
@@ -169,9 +225,9 @@ void DFTEngine::CalcElDipole(Orbitals& orbitals) const {
 }
 
 bool DFTEngine::Evaluate(Orbitals& orbitals) {
-  // set the parallelization
+  // set the parallelization, 0 keeps the threads of the caller
 #ifdef _OPENMP
-  omp_set_num_threads(_openmp_threads);
+  if (_openmp_threads > 0) omp_set_num_threads(_openmp_threads);
 #endif
 
   Eigen::VectorXd& MOEnergies = orbitals.MOEnergies();
@@ -243,16 +299,10 @@ bool DFTEngine::Evaluate(Orbitals& orbitals) {
       _dftAOdmat = AtomicGuess(orbitals);
       CalculateERIs(_dftbasis, _dftAOdmat);
 
-      if (_use_small_grid) {
-        orbitals.AOVxc() = _gridIntegration_small.IntegrateVXC(_dftAOdmat);
-        CTP_LOG(ctp::logDEBUG, *_pLog)
-            << ctp::TimeStamp() << " Filled approximate DFT Vxc matrix "
-            << flush;
-      } else {
-        orbitals.AOVxc() = _gridIntegration.IntegrateVXC(_dftAOdmat);
-        CTP_LOG(ctp::logDEBUG, *_pLog)
-            << ctp::TimeStamp() << " Filled DFT Vxc matrix " << flush;
-      }
+      orbitals.AOVxc() = GridLevel(_grid_level).IntegrateVXC(_dftAOdmat);
+      CTP_LOG(ctp::logDEBUG, *_pLog)
+          << ctp::TimeStamp() << " Filled DFT Vxc matrix on grid "
+          << _grid_ladder[_grid_level] << flush;
       Eigen::MatrixXd H = H0 + _ERIs.getERIs() + orbitals.AOVxc();
       if (_ScaHFX > 0) {
         if (_with_RI) {
@@ -289,17 +339,23 @@ bool DFTEngine::Evaluate(Orbitals& orbitals) {
 
     CTP_LOG(ctp::logDEBUG, *_pLog)
         << ctp::TimeStamp() << " Filled DFT Electron repulsion matrix" << flush;
-    double vxcenergy = 0.0;
-    if (_use_small_grid && _conv_accelerator.getDIIsError() > 1e-3) {
-      orbitals.AOVxc() = _gridIntegration_small.IntegrateVXC(_dftAOdmat);
-      vxcenergy = _gridIntegration_small.getTotEcontribution();
-      CTP_LOG(ctp::logDEBUG, *_pLog)
-          << ctp::TimeStamp() << " Filled approximate DFT Vxc matrix " << flush;
-    } else {
-      orbitals.AOVxc() = _gridIntegration.IntegrateVXC(_dftAOdmat);
-      vxcenergy = _gridIntegration.getTotEcontribution();
+    // the density of the coarser grid is the starting point on the finer one
+    if (_grid_level + 1 < _grid_ladder.size() &&
+        _conv_accelerator.getDIIsError() < GridSwitchError()) {
+      SwitchGridLevel();
+    }
+    NumericalIntegration& gridIntegration = GridLevel(_grid_level);
+    orbitals.AOVxc() = gridIntegration.IntegrateVXC(_dftAOdmat);
+    double vxcenergy = gridIntegration.getTotEcontribution();
+    CTP_LOG(ctp::logDEBUG, *_pLog)
+        << ctp::TimeStamp() << " Filled DFT Vxc matrix on grid "
+        << _grid_ladder[_grid_level] << flush;
+    if (_with_RI && _ERIs.isSinglePrecision() &&
+        _conv_accelerator.getDIIsError() < _mixed_precision_error) {
+      _ERIs.SwitchToDoublePrecision();
       CTP_LOG(ctp::logDEBUG, *_pLog)
-          << ctp::TimeStamp() << " Filled DFT Vxc matrix " << flush;
+          << ctp::TimeStamp()
+          << " Recomputed RI integrals in double precision" << flush;
     }
     CalculateERIs(_dftbasis, _dftAOdmat);
     Eigen::MatrixXd H = H0 + _ERIs.getERIs() + orbitals.AOVxc();
@@ -358,7 +414,10 @@ bool DFTEngine::Evaluate(Orbitals& orbitals) {
         << MOEnergies(_numofelectrons / 2) - MOEnergies(_numofelectrons / 2 - 1)
         << flush;
 
-    if (_conv_accelerator.isConverged()) {
+    // the final energy always comes from double precision integrals and the
+    // finest grid
+    if (_conv_accelerator.isConverged() && !_ERIs.isSinglePrecision() &&
+        _grid_level + 1 == _grid_ladder.size()) {
       CTP_LOG(ctp::logDEBUG, *_pLog)
           << ctp::TimeStamp() << " Total Energy has converged to "
           << std::setprecision(9) << _conv_accelerator.getDeltaE()
@@ -379,6 +438,7 @@ bool DFTEngine::Evaluate(Orbitals& orbitals) {
         << _dftAOdmat.cwiseProduct(_dftAOoverlap.Matrix()).sum()
         << " electrons." << flush;
   }
+  WaitGridSetup();
   return true;
 }
 
@@ -397,19 +457,22 @@ void DFTEngine::SetupInvariantMatrices() {
       << ctp::TimeStamp() << " Filled DFT nuclear potential matrix." << flush;
 
   if (_addexternalsites) {
+    _dftAOESP.setFarFieldAccuracy(_farfield_accuracy);
+    _dftAODipole_Potential.setFarFieldAccuracy(_farfield_accuracy);
+    _dftAOQuadrupole_Potential.setFarFieldAccuracy(_farfield_accuracy);
     _dftAOESP.Fillextpotential(_dftbasis, _externalsites);
     CTP_LOG(ctp::logDEBUG, *_pLog)
         << ctp::TimeStamp()
         << " Filled DFT external pointcharge potential matrix" << flush;
 
     _dftAODipole_Potential.Fillextpotential(_dftbasis, _externalsites);
-    if (_dftAODipole_Potential.Dimension() > 0) {
+    if (!_dftAODipole_Potential.getExternalpotential().isZero(0.0)) {
       CTP_LOG(ctp::logDEBUG, *_pLog)
           << ctp::TimeStamp() << " Filled DFT external dipole potential matrix"
           << flush;
     }
     _dftAOQuadrupole_Potential.Fillextpotential(_dftbasis, _externalsites);
-    if (_dftAOQuadrupole_Potential.Dimension()) {
+    if (!_dftAOQuadrupole_Potential.getExternalpotential().isZero(0.0)) {
       CTP_LOG(ctp::logDEBUG, *_pLog)
           << ctp::TimeStamp()
           << " Filled DFT external quadrupole potential matrix." << flush;
@@ -463,6 +526,7 @@ void DFTEngine::SetupInvariantMatrices() {
 
   if (_with_RI) {
     // prepare invariant part of electron repulsion integrals
+    _ERIs.setSinglePrecision(_mixed_precision);
     _ERIs.Initialize(_dftbasis, _auxbasis);
     CTP_LOG(ctp::logDEBUG, *_pLog)
         << ctp::TimeStamp() << " Inverted AUX Coulomb matrix, removed "
@@ -493,7 +557,8 @@ void DFTEngine::SetupInvariantMatrices() {
   return;
 }
 
-Eigen::MatrixXd DFTEngine::RunAtomicDFT_unrestricted(QMAtom* uniqueAtom) {
+Eigen::MatrixXd DFTEngine::RunAtomicDFT_unrestricted(QMAtom* uniqueAtom,
+                                                     ctp::Logger* pLog) {
   bool with_ecp = _with_ecp;
   if (uniqueAtom->getType() == "H" || uniqueAtom->getType() == "He") {
     with_ecp = false;
@@ -629,7 +694,7 @@ Eigen::MatrixXd DFTEngine::RunAtomicDFT_unrestricted(QMAtom* uniqueAtom) {
         dftAOdmat_beta, H_beta, MOEnergies_beta, MOCoeff_beta, E_beta);
 
     if (tools::globals::verbose) {
-      CTP_LOG(ctp::logDEBUG, *_pLog)
+      CTP_LOG(ctp::logDEBUG, *pLog)
           << ctp::TimeStamp() << " Iter " << this_iter << " of " << maxiter
           << " Etot " << totenergy << " diise_a "
           << Convergence_alpha.getDIIsError() << " diise_b "
@@ -646,11 +711,11 @@ Eigen::MatrixXd DFTEngine::RunAtomicDFT_unrestricted(QMAtom* uniqueAtom) {
     if (converged || this_iter == maxiter - 1) {
 
       if (converged) {
-        CTP_LOG(ctp::logDEBUG, *_pLog)
+        CTP_LOG(ctp::logDEBUG, *pLog)
             << ctp::TimeStamp() << " Converged after " << this_iter + 1
             << " iterations" << flush;
       } else {
-        CTP_LOG(ctp::logDEBUG, *_pLog)
+        CTP_LOG(ctp::logDEBUG, *pLog)
             << ctp::TimeStamp() << " Not converged after " << this_iter + 1
             << " iterations. Unconverged density.\n\t\t\t"
             << " DIIsError_alpha=" << Convergence_alpha.getDIIsError()
@@ -661,7 +726,7 @@ Eigen::MatrixXd DFTEngine::RunAtomicDFT_unrestricted(QMAtom* uniqueAtom) {
   }
   Eigen::MatrixXd avgmatrix =
       SphericalAverageShells(dftAOdmat_alpha + dftAOdmat_beta, dftbasis);
-  CTP_LOG(ctp::logDEBUG, *_pLog)
+  CTP_LOG(ctp::logDEBUG, *pLog)
       << ctp::TimeStamp() << " Atomic density Matrix for "
       << uniqueAtom->getType() << " gives N=" << std::setprecision(9)
       << avgmatrix.cwiseProduct(dftAOoverlap.Matrix()).sum() << " electrons."
@@ -696,13 +761,45 @@ Eigen::MatrixXd DFTEngine::AtomicGuess(Orbitals& orbitals) {
   CTP_LOG(ctp::logDEBUG, *_pLog)
       << ctp::TimeStamp() << " " << uniqueelements.size()
       << " unique elements found" << flush;
-  std::vector<Eigen::MatrixXd> uniqueatom_guesses;
-  for (QMAtom* unique_atom : uniqueelements) {
-    CTP_LOG(ctp::logDEBUG, *_pLog)
+  AtomicGuessLibrary& library = AtomicGuessLibrary::Instance();
+  std::vector<std::string> keys;
+  std::vector<Eigen::MatrixXd> uniqueatom_guesses(uniqueelements.size());
+  std::vector<unsigned> missing;
+  for (unsigned i = 0; i < uniqueelements.size(); i++) {
+    const string& element = uniqueelements[i]->getType();
+    bool with_ecp = _with_ecp && element != "H" && element != "He";
+    keys.push_back(AtomicGuessLibrary::Key(element, _dftbasis_name,
+                                           with_ecp ? _ecp_name : "",
+                                           _xc_functional_name, _grid_name));
+    if (library.Find(keys[i], _atomic_guess_cache, uniqueatom_guesses[i])) {
+      CTP_LOG(ctp::logDEBUG, *_pLog)
+          << ctp::TimeStamp() << " Took atom density for " << element
+          << " from library" << flush;
+    } else {
+      missing.push_back(i);
+    }
+  }
+
+  // the atoms are independent, their output is collected per atom
+  std::vector<std::unique_ptr<ctp::Logger> > atomlogs;
+  for (unsigned j = 0; j < missing.size(); j++) {
+    atomlogs.push_back(std::unique_ptr<ctp::Logger>(new ctp::Logger()));
+    atomlogs.back()->setReportLevel(ctp::logDEBUG);
+    atomlogs.back()->setMultithreading(true);
+  }
+#pragma omp parallel for schedule(dynamic) if (missing.size() > 1)
+  for (unsigned j = 0; j < missing.size(); j++) {
+    QMAtom* unique_atom = uniqueelements[missing[j]];
+    CTP_LOG(ctp::logDEBUG, *atomlogs[j])
         << ctp::TimeStamp() << " Calculating atom density for "
         << unique_atom->getType() << flush;
-    Eigen::MatrixXd dmat_unrestricted = RunAtomicDFT_unrestricted(unique_atom);
-    uniqueatom_guesses.push_back(dmat_unrestricted);
+    uniqueatom_guesses[missing[j]] =
+        RunAtomicDFT_unrestricted(unique_atom, atomlogs[j].get());
+  }
+  for (unsigned j = 0; j < missing.size(); j++) {
+    CTP_LOG(ctp::logDEBUG, *_pLog) << *atomlogs[j] << flush;
+    library.Insert(keys[missing[j]], _atomic_guess_cache,
+                   uniqueatom_guesses[missing[j]]);
   }
 
   Eigen::MatrixXd guess =
@@ -785,9 +882,11 @@ void DFTEngine::ConfigOrbfile(Orbitals& orbitals) {
 }
 
 void DFTEngine::Prepare(Orbitals& orbitals) {
+  // a previous Prepare may still set up a grid on the old basis
+  WaitGridSetup();
 #ifdef _OPENMP
 
-  omp_set_num_threads(_openmp_threads);
+  if (_openmp_threads > 0) omp_set_num_threads(_openmp_threads);
   CTP_LOG(ctp::logDEBUG, *_pLog)
       << ctp::TimeStamp() << " Using " << omp_get_max_threads() << " threads"
       << flush;
@@ -845,7 +944,6 @@ void DFTEngine::Prepare(Orbitals& orbitals) {
         << _ecp.getNumofShells() << flush;
   }
 
-  _gridIntegration.GridSetup(_grid_name, _atoms, _dftbasis);
   _gridIntegration.setXCfunctional(_xc_functional_name);
 
   _ScaHFX = _gridIntegration.getExactExchange(_xc_functional_name);
@@ -855,26 +953,29 @@ void DFTEngine::Prepare(Orbitals& orbitals) {
         << flush;
   }
 
+  _grid_level = 0;
+  _gridIntegration_ladder.clear();
+  for (unsigned i = 1; i < _grid_ladder.size(); i++) {
+    _gridIntegration_ladder.push_back(
+        std::unique_ptr<NumericalIntegration>(new NumericalIntegration()));
+    _gridIntegration_ladder.back()->setXCfunctional(_xc_functional_name);
+  }
+  NumericalIntegration& gridIntegration = GridLevel(0);
+  gridIntegration.GridSetup(_grid_ladder[0], _atoms, _dftbasis);
   CTP_LOG(ctp::logDEBUG, *_pLog)
-      << ctp::TimeStamp() << " Setup numerical integration grid " << _grid_name
-      << " for vxc functional " << _xc_functional_name << flush;
+      << ctp::TimeStamp() << " Setup numerical integration grid "
+      << _grid_ladder[0] << " for vxc functional " << _xc_functional_name
+      << flush;
   CTP_LOG(ctp::logDEBUG, *_pLog)
       << "\t\t "
-      << " with " << _gridIntegration.getGridSize() << " points"
-      << " divided into " << _gridIntegration.getBoxesSize() << " boxes"
+      << " with " << gridIntegration.getGridSize() << " points"
+      << " divided into " << gridIntegration.getBoxesSize() << " boxes"
       << flush;
-  if (_use_small_grid) {
-    _gridIntegration_small.GridSetup(_grid_name_small, _atoms, _dftbasis);
-    _gridIntegration_small.setXCfunctional(_xc_functional_name);
-    CTP_LOG(ctp::logDEBUG, *_pLog)
-        << ctp::TimeStamp() << " Setup small numerical integration grid "
-        << _grid_name_small << " for vxc functional " << _xc_functional_name
-        << flush;
+  if (_grid_ladder.size() > 1) {
     CTP_LOG(ctp::logDEBUG, *_pLog)
-        << "\t\t "
-        << " with " << _gridIntegration_small.getGridSize() << " points"
-        << " divided into " << _gridIntegration_small.getBoxesSize() << " boxes"
-        << flush;
+        << ctp::TimeStamp() << " Setting up numerical integration grid "
+        << _grid_ladder[1] << " in the background" << flush;
+    StartGridSetup(1);
   }
 
   if (_do_externalfield) {
@@ -968,6 +1069,8 @@ double DFTEngine::ExternalGridRepulsion(
   return E_ext;
 }
 
+// grids below medium give too poor a density to start the finer grids from,
+// so medium and coarser grids return themselves
 string DFTEngine::ReturnSmallGrid(const string& largegrid) {
   string smallgrid;
 
@@ -976,13 +1079,10 @@ string DFTEngine::ReturnSmallGrid(const string& largegrid) {
   } else if (largegrid == "fine") {
     smallgrid = "medium";
   } else if (largegrid == "medium") {
-    _use_small_grid = false;
     smallgrid = "medium";
   } else if (largegrid == "coarse") {
-    _use_small_grid = false;
     smallgrid = "coarse";
   } else if (largegrid == "xcoarse") {
-    _use_small_grid = false;
     smallgrid = "xcoarse";
   } else {
     throw runtime_error("Grid name for Vxc integration not known.");
@@ -990,6 +1090,92 @@ string DFTEngine::ReturnSmallGrid(const string& largegrid) {
   return smallgrid;
 }
 
+// grids the SCF iterates on from coarse to fine, ending with _grid_name.
+// Without explicit smallgrids each grid is preceded by its ReturnSmallGrid.
+std::vector<string> DFTEngine::ReturnGridLadder(const string& smallgrids) {
+  std::vector<string> ladder;
+  if (smallgrids.empty()) {
+    ladder.push_back(_grid_name);
+    string smallgrid = ReturnSmallGrid(_grid_name);
+    while (smallgrid != ladder.front()) {
+      ladder.insert(ladder.begin(), smallgrid);
+      smallgrid = ReturnSmallGrid(smallgrid);
+    }
+    return ladder;
+  }
+
+  Tokenizer tok(smallgrids, " ,\n\t");
+  tok.ToVector(ladder);
+  ladder.push_back(_grid_name);
+  const std::vector<string> quality = {"xcoarse", "coarse", "medium", "fine",
+                                       "xfine"};
+  std::vector<int> rank;
+  for (const string& grid : ladder) {
+    auto it = std::find(quality.begin(), quality.end(), grid);
+    if (it == quality.end()) {
+      throw runtime_error("Grid name for Vxc integration not known.");
+    }
+    rank.push_back(it - quality.begin());
+  }
+  for (unsigned i = 1; i < rank.size(); i++) {
+    if (rank[i - 1] >= rank[i]) {
+      throw runtime_error(
+          "Grid ladder for Vxc integration has to go from coarse to fine "
+          "grids.");
+    }
+  }
+  return ladder;
+}
+
+NumericalIntegration& DFTEngine::GridLevel(unsigned level) {
+  if (level + 1 == _grid_ladder.size()) {
+    return _gridIntegration;
+  }
+  return *_gridIntegration_ladder[level];
+}
+
+// coarser levels are left at larger DIIS errors, each grid by a factor of 10
+double DFTEngine::GridSwitchError() const {
+  int steps = int(_grid_ladder.size()) - 2 - int(_grid_level);
+  return _grid_switch_error * std::pow(10.0, steps);
+}
+
+void DFTEngine::StartGridSetup(unsigned level) {
+  _grid_setup.reset(new GridSetupThread(GridLevel(level), _grid_ladder[level],
+                                        _atoms, _dftbasis,
+                                        _grid_setup_threads));
+  _grid_setup->Start();
+  return;
+}
+
+void DFTEngine::WaitGridSetup() {
+  if (_grid_setup) {
+    _grid_setup->WaitDone();
+    _grid_setup.reset();
+  }
+  return;
+}
+
+void DFTEngine::SwitchGridLevel() {
+  WaitGridSetup();
+  _gridIntegration_ladder[_grid_level].reset();
+  _grid_level++;
+  NumericalIntegration& gridIntegration = GridLevel(_grid_level);
+  CTP_LOG(ctp::logDEBUG, *_pLog)
+      << ctp::TimeStamp() << " Switched to numerical integration grid "
+      << _grid_ladder[_grid_level] << " at DIIS error "
+      << _conv_accelerator.getDIIsError() << flush;
+  CTP_LOG(ctp::logDEBUG, *_pLog)
+      << "\t\t "
+      << " with " << gridIntegration.getGridSize() << " points"
+      << " divided into " << gridIntegration.getBoxesSize() << " boxes"
+      << flush;
+  if (_grid_level + 1 < _grid_ladder.size()) {
+    StartGridSetup(_grid_level + 1);
+  }
+  return;
+}
+
 // average atom densities matrices, for SP and other combined shells average
 // each subshell separately.
 Eigen::MatrixXd DFTEngine::SphericalAverageShells(const Eigen::MatrixXd& dmat,
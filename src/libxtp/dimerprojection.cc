@@ -0,0 +1,181 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/xtp/aomatrix.h>
+#include <votca/xtp/basisset.h>
+#include <votca/xtp/dimerprojection.h>
+
+namespace votca {
+namespace xtp {
+
+Eigen::MatrixXd DimerProjection::MergeMOs(const Eigen::MatrixXd& mosA,
+                                          const Eigen::MatrixXd& mosB) {
+  Eigen::MatrixXd merged = Eigen::MatrixXd::Zero(
+      mosA.rows() + mosB.rows(), mosA.cols() + mosB.cols());
+  merged.topLeftCorner(mosA.rows(), mosA.cols()) = mosA;
+  merged.bottomRightCorner(mosB.rows(), mosB.cols()) = mosB;
+  return merged;
+}
+
+void DimerProjection::Initialize(const Orbitals& orbitalsA,
+                                 const Orbitals& orbitalsB,
+                                 const Orbitals& orbitalsAB) {
+  _basisA = orbitalsA.getBasisSetSize();
+  _basisB = orbitalsB.getBasisSetSize();
+  if ((_basisA == 0) || (_basisB == 0)) {
+    throw std::runtime_error("Basis set size is not stored in monomers");
+  }
+  _basisL = orbitalsAB.getBasisSetSize() - _basisA - _basisB;
+  if (_basisL < 0) {
+    throw std::runtime_error(
+        "Dimer basis is smaller than the basis of the monomers");
+  }
+  int startB = _basisA;
+  int startL = _basisA + _basisB;
+
+  if (orbitalsAB.hasAOOverlap()) {
+    const Eigen::MatrixXd& overlap = orbitalsAB.AOOverlap();
+    _projectorA = orbitalsA.MOCoefficients().transpose() *
+                  overlap.topLeftCorner(_basisA, _basisA);
+    _projectorB = orbitalsB.MOCoefficients().transpose() *
+                  overlap.block(startB, startB, _basisB, _basisB);
+    _overlapAB = overlap.block(0, startB, _basisA, _basisB);
+    _overlapAL = overlap.block(0, startL, _basisA, _basisL);
+    _overlapBL = overlap.block(startB, startL, _basisB, _basisL);
+  } else {
+    BasisSet basisset;
+    basisset.LoadBasisSet(orbitalsAB.getDFTbasisName());
+    AOBasis basis;
+    // AOBasisFill sets the nuclear charges of the atoms, which are the same
+    // in the dimer anyway
+    std::vector<QMAtom*> atoms = orbitalsAB.QMAtoms();
+    basis.AOBasisFill(basisset, atoms);
+    if (basis.AOBasisSize() != orbitalsAB.getBasisSetSize()) {
+      throw std::runtime_error(
+          "Basis set size of the dimer does not match its basisset " +
+          orbitalsAB.getDFTbasisName());
+    }
+    SetupProjector(orbitalsA.MOCoefficients(), basis, 0, _projectorA, _luA);
+    SetupProjector(orbitalsB.MOCoefficients(), basis, startB, _projectorB,
+                   _luB);
+    _overlapAB = OverlapBlock(basis, 0, _basisA, startB, _basisB);
+    _overlapAL = OverlapBlock(basis, 0, _basisA, startL, _basisL);
+    _overlapBL = OverlapBlock(basis, startB, _basisB, startL, _basisL);
+  }
+  _initialized = true;
+  return;
+}
+
+// overlap of the functions row_start..row_start+row_size with
+// col_start..col_start+col_size, shells do not cross monomer boundaries
+Eigen::MatrixXd DimerProjection::OverlapBlock(const AOBasis& basis,
+                                              int row_start, int row_size,
+                                              int col_start,
+                                              int col_size) const {
+  Eigen::MatrixXd block = Eigen::MatrixXd::Zero(row_size, col_size);
+  if (row_size == 0 || col_size == 0) return block;
+  std::vector<const AOShell*> rows;
+  std::vector<const AOShell*> cols;
+  for (const AOShell* shell : basis) {
+    int start = shell->getStartIndex();
+    if (start >= row_start && start < row_start + row_size) {
+      rows.push_back(shell);
+    }
+    if (start >= col_start && start < col_start + col_size) {
+      cols.push_back(shell);
+    }
+  }
+#pragma omp parallel for schedule(guided)
+  for (unsigned i = 0; i < rows.size(); i++) {
+    AOOverlap overlap;
+    const AOShell* shell_row = rows[i];
+    for (const AOShell* shell_col : cols) {
+      block.block(shell_row->getStartIndex() - row_start,
+                  shell_col->getStartIndex() - col_start,
+                  shell_row->getNumFunc(), shell_col->getNumFunc()) =
+          overlap.FillShellPair(shell_row, shell_col);
+    }
+  }
+  return block;
+}
+
+void DimerProjection::SetupProjector(
+    const Eigen::MatrixXd& mos, const AOBasis& basis, int start,
+    Eigen::MatrixXd& projector,
+    Eigen::PartialPivLU<Eigen::MatrixXd>& lu) const {
+  if (mos.rows() == mos.cols()) {
+    // C^T S C = 1, so C^T S = C^-1 and no integrals are needed
+    lu.compute(mos.transpose());
+    projector.resize(0, 0);
+  } else {
+    projector =
+        mos.transpose() * OverlapBlock(basis, start, int(mos.rows()), start,
+                                       int(mos.rows()));
+  }
+  return;
+}
+
+Eigen::MatrixXd DimerProjection::ProjectorRows(
+    const Eigen::MatrixXd& projector,
+    const Eigen::PartialPivLU<Eigen::MatrixXd>& lu, int min, int n) {
+  if (projector.size() > 0) {
+    return projector.middleRows(min, n);
+  }
+  // rows of C^-1 are the columns of C^-T
+  Eigen::MatrixXd unit = Eigen::MatrixXd::Zero(lu.rows(), n);
+  unit.block(min, 0, n, n) = Eigen::MatrixXd::Identity(n, n);
+  return lu.solve(unit).transpose();
+}
+
+Eigen::MatrixXd DimerProjection::Project(const Orbitals& orbitalsA,
+                                         const Orbitals& orbitalsB,
+                                         const Orbitals& orbitalsAB, int minA,
+                                         int nA, int minB, int nB) const {
+  if (!_initialized) {
+    throw std::runtime_error("DimerProjection is not initialized");
+  }
+  const Eigen::MatrixXd& mosAB = orbitalsAB.MOCoefficients();
+  if (mosAB.rows() != _basisA + _basisB + _basisL) {
+    throw std::runtime_error(
+        "Dimer orbitals do not match the basis of the projection");
+  }
+  int startB = _basisA;
+  Eigen::MatrixXd mosA = orbitalsA.MOCoefficients().middleCols(minA, nA);
+  Eigen::MatrixXd mosB = orbitalsB.MOCoefficients().middleCols(minB, nB);
+
+  Eigen::MatrixXd projection(nA + nB, mosAB.cols());
+  // C_A^T S_AA C_AB,A + C_A^T S_AB C_AB,B + C_A^T S_AL C_AB,L
+  projection.topRows(nA) =
+      ProjectorRows(_projectorA, _luA, minA, nA) * mosAB.topRows(_basisA) +
+      (mosA.transpose() * _overlapAB) * mosAB.middleRows(startB, _basisB);
+  projection.bottomRows(nB) =
+      ProjectorRows(_projectorB, _luB, minB, nB) *
+          mosAB.middleRows(startB, _basisB) +
+      (mosB.transpose() * _overlapAB.transpose()) * mosAB.topRows(_basisA);
+  if (_basisL > 0) {
+    projection.topRows(nA) +=
+        (mosA.transpose() * _overlapAL) * mosAB.bottomRows(_basisL);
+    projection.bottomRows(nB) +=
+        (mosB.transpose() * _overlapBL) * mosAB.bottomRows(_basisL);
+  }
+  return projection;
+}
+
+}  // namespace xtp
+}  // namespace votca
@@ -17,8 +17,12 @@
  *
  */
 
+#include <boost/filesystem.hpp>
 #include <boost/format.hpp>
+#include <memory>
 #include <votca/xtp/forces.h>
+#include <votca/xtp/nestedteams.h>
+#include <votca/xtp/qmpackage.h>
 
 #include "votca/xtp/statefilter.h"
 
@@ -45,6 +49,13 @@ void Forces::Initialize(tools::Property& options) {
       options.ifExistsAndinListReturnElseThrowRuntimeError<std::string>(
           ".removal", choices);
   if (_force_removal == "total") _remove_total_force = true;
+
+  _tasks = options.ifExistsReturnElseReturnDefault<int>(".tasks", 1);
+  if (_tasks < 1) {
+    throw std::runtime_error("Forces: number of tasks has to be at least 1");
+  }
+  _warm_start =
+      options.ifExistsReturnElseReturnDefault<bool>(".warm_start", true);
   return;
 }
 
@@ -57,24 +68,131 @@ void Forces::Calculate(const Orbitals& orbitals) {
   if (!tools::globals::verbose) {
     _pLog->setReportLevel(ctp::logERROR);  // go silent for force calculations
   }
+  std::vector<Displacement> displacements;
   for (int atom_index = 0; atom_index < natoms; atom_index++) {
-    if (tools::globals::verbose) {
-      CTP_LOG(ctp::logINFO, *_pLog)
-          << "FORCES--DEBUG working on atom " << atom_index << flush;
+    for (int i_cart = 0; i_cart < 3; i_cart++) {
+      displacements.push_back({atom_index, i_cart, _displacement, 0.0});
+      if (_force_method == "central") {
+        displacements.push_back({atom_index, i_cart, -_displacement, 0.0});
+      }
+    }
+  }
+  RunDisplacements(orbitals, displacements);
+
+  if (_force_method == "forward") {
+    Orbitals reference = orbitals;
+    double energy_center =
+        reference.getTotalStateEnergy(_filter.CalcState(reference));
+    for (const Displacement& disp : displacements) {
+      _forces(disp.atom, disp.cart) =
+          (energy_center - disp.energy) / _displacement;
+    }
+  } else if (_force_method == "central") {
+    for (unsigned i = 0; i < displacements.size(); i += 2) {
+      const Displacement& plus = displacements[i];
+      const Displacement& minus = displacements[i + 1];
+      _forces(plus.atom, plus.cart) =
+          0.5 * (minus.energy - plus.energy) / _displacement;
     }
-    Eigen::Vector3d atom_force = Eigen::Vector3d::Zero();
-    // Calculate Force on this atom
-    if (_force_method == "forward")
-      atom_force = NumForceForward(orbitals, atom_index);
-    if (_force_method == "central")
-      atom_force = NumForceCentral(orbitals, atom_index);
-    _forces.row(atom_index) = atom_force.transpose();
   }
   _pLog->setReportLevel(ReportLevel);  //
   if (_remove_total_force) RemoveTotalForce();
   return;
 }
 
+void Forces::RunDisplacements(const Orbitals& orbitals,
+                              std::vector<Displacement>& displacements) {
+  const int ndisplacements = displacements.size();
+  const int tasks = std::max(1, std::min(_tasks, ndisplacements));
+  int threads_per_task = 1;
+#ifdef _OPENMP
+  threads_per_task = std::max(1, omp_get_max_threads() / tasks);
+#endif
+  NestedTeams nested(tasks > 1);
+  const bool guess = _warm_start && orbitals.hasMOCoefficients();
+  CTP_LOG(ctp::logINFO, *_pLog)
+      << (boost::format("Forces: %1% displacements in %2% tasks with %3% "
+                        "threads each") %
+          ndisplacements % tasks % threads_per_task)
+             .str()
+      << flush;
+
+  // every task runs its own copy of the qmpackage, with more than one task
+  // each in its own folder, so that input and output files do not collide
+  QMPackage* qmpackage = _gwbse_engine.getQMPackage();
+  std::vector<std::unique_ptr<QMPackage> > packages;
+  std::vector<std::unique_ptr<ctp::Logger> > loggers;
+  std::vector<GWBSEEngine> engines;
+  for (int task = 0; task < tasks; task++) {
+    packages.push_back(std::unique_ptr<QMPackage>(qmpackage->Clone()));
+    QMPackage* package = packages.back().get();
+    package->setUseGuess(package->GuessRequested() || guess);
+    engines.push_back(_gwbse_engine);
+    GWBSEEngine& engine = engines.back();
+    engine.setQMPackage(package);
+    if (tasks > 1) {
+      std::string run_dir =
+          (boost::format("%1%/forces_task%2%") % qmpackage->getRunDir() % task)
+              .str();
+      boost::filesystem::create_directories(run_dir);
+      package->setRunDir(run_dir);
+      package->setThreads(threads_per_task);
+      engine.setLoggerFile(run_dir + "/gwbse.log");
+      loggers.push_back(std::unique_ptr<ctp::Logger>(
+          new ctp::Logger(_pLog->getReportLevel())));
+      loggers.back()->setMultithreading(false);
+      engine.setLog(loggers.back().get());
+    }
+  }
+
+  std::string error;
+#pragma omp parallel for schedule(dynamic) num_threads(tasks)
+  for (int i = 0; i < ndisplacements; i++) {
+    int task = 0;
+#ifdef _OPENMP
+    task = omp_get_thread_num();
+    if (tasks > 1) {
+      omp_set_num_threads(threads_per_task);
+    }
+#endif
+    try {
+      displacements[i].energy =
+          DisplacedEnergy(engines[task], orbitals, displacements[i]);
+    } catch (std::exception& e) {
+#pragma omp critical
+      { error = e.what(); }
+    }
+  }
+  if (!error.empty()) {
+    throw std::runtime_error("Forces: displaced calculation failed: " + error);
+  }
+  return;
+}
+
+double Forces::DisplacedEnergy(GWBSEEngine& engine, const Orbitals& orbitals,
+                               const Displacement& displacement) const {
+  if (tools::globals::verbose) {
+#pragma omp critical
+    {
+      CTP_LOG(ctp::logINFO, *_pLog)
+          << "FORCES--DEBUG working on atom " << displacement.atom
+          << " Cartesian component " << displacement.cart << flush;
+    }
+  }
+  // the copy carries the MOs of the reference geometry as guess
+  Orbitals displaced = orbitals;
+  QMAtom* atom = displaced.QMAtoms()[displacement.atom];
+  tools::vec pos_displaced = atom->getPos();
+  pos_displaced[displacement.cart] += displacement.delta;
+  atom->setPos(pos_displaced);
+  engine.ExcitationEnergies(displaced);
+  double energy = 0.0;
+  // the state filter is shared between all tasks
+#pragma omp critical
+  { energy = displaced.getTotalStateEnergy(_filter.CalcState(displaced)); }
+  return energy;
+}
+
 void Forces::Report() const {
 
   CTP_LOG(ctp::logINFO, *_pLog)
@@ -100,60 +218,6 @@ void Forces::Report() const {
   return;
 }
 
-Eigen::Vector3d Forces::NumForceForward(Orbitals orbitals, int atom_index) {
-  Eigen::Vector3d force = Eigen::Vector3d::Zero();
-  // get this atoms's current coordinates
-  double energy_center =
-      orbitals.getTotalStateEnergy(_filter.CalcState(orbitals));
-  const tools::vec current_pos = orbitals.QMAtoms()[atom_index]->getPos();
-
-  for (unsigned i_cart = 0; i_cart < 3; i_cart++) {
-    tools::vec displacement_vec(0, 0, 0);
-    displacement_vec[i_cart] = _displacement;
-    // update the coordinate
-    tools::vec pos_displaced = current_pos + displacement_vec;
-    orbitals.QMAtoms()[atom_index]->setPos(pos_displaced);
-    _gwbse_engine.ExcitationEnergies(orbitals);
-    double energy_displaced =
-        orbitals.getTotalStateEnergy(_filter.CalcState(orbitals));
-    force(i_cart) = (energy_center - energy_displaced) / _displacement;
-    orbitals.QMAtoms()[atom_index]->setPos(
-        current_pos);  // restore original coordinate into segment
-  }                    // Cartesian directions
-  return force;
-}
-
-Eigen::Vector3d Forces::NumForceCentral(Orbitals orbitals, int atom_index) {
-
-  const tools::vec current_pos = orbitals.QMAtoms()[atom_index]->getPos();
-  Eigen::Vector3d force = Eigen::Vector3d::Zero();
-  for (unsigned i_cart = 0; i_cart < 3; i_cart++) {
-    if (tools::globals::verbose) {
-      CTP_LOG(ctp::logINFO, *_pLog)
-          << "FORCES--DEBUG           Cartesian component " << i_cart << flush;
-    }
-    tools::vec displacement_vec(0, 0, 0);
-    displacement_vec[i_cart] = _displacement;
-    // update the coordinate
-    tools::vec pos_displaced = current_pos + displacement_vec;
-    orbitals.QMAtoms()[atom_index]->setPos(pos_displaced);
-    _gwbse_engine.ExcitationEnergies(orbitals);
-    double energy_displaced_plus =
-        orbitals.getTotalStateEnergy(_filter.CalcState(orbitals));
-    // update the coordinate
-    pos_displaced = current_pos - displacement_vec;
-    orbitals.QMAtoms()[atom_index]->setPos(pos_displaced);
-    _gwbse_engine.ExcitationEnergies(orbitals);
-    double energy_displaced_minus =
-        orbitals.getTotalStateEnergy(_filter.CalcState(orbitals));
-    force(i_cart) =
-        0.5 * (energy_displaced_minus - energy_displaced_plus) / _displacement;
-    orbitals.QMAtoms()[atom_index]->setPos(
-        current_pos);  // restore original coordinate into orbital
-  }
-  return force;
-}
-
 void Forces::RemoveTotalForce() {
   Eigen::Vector3d avgtotal_force =
       _forces.colwise().sum() / double(_forces.rows());
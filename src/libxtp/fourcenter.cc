@@ -18,12 +18,12 @@
  */
 
 #include <votca/xtp/fourcenter.h>
+#include <votca/xtp/scratcharena.h>
 
 namespace votca {
 namespace xtp {
 
 void FCMatrix::Fill_4c_small_molecule(const AOBasis& dftbasis) {
-  tensor4d::extent_gen extents;
   int dftBasisSize = dftbasis.AOBasisSize();
   int vectorSize = (dftBasisSize * (dftBasisSize + 1)) / 2;
 
@@ -56,17 +56,9 @@ void FCMatrix::Fill_4c_small_molecule(const AOBasis& dftbasis) {
           int start_2 = _shell_2->getStartIndex();
           int NumFunc_2 = _shell_2->getNumFunc();
 
-          tensor4d block(extents[range(0, NumFunc_1)][range(0, NumFunc_2)]
-                                [range(0, NumFunc_3)][range(0, NumFunc_4)]);
-          for (int i = 0; i < _shell_1->getNumFunc(); ++i) {
-            for (int j = 0; j < _shell_2->getNumFunc(); ++j) {
-              for (int k = 0; k < _shell_3->getNumFunc(); ++k) {
-                for (int l = 0; l < _shell_4->getNumFunc(); ++l) {
-                  block[i][j][k][l] = 0.0;
-                }
-              }
-            }
-          }
+          ScratchArena::Frame scratch;
+          tensor4d_ref block =
+              scratch.Tensor4D(NumFunc_1, NumFunc_2, NumFunc_3, NumFunc_4);
           bool nonzero = FillFourCenterRepBlock(block, _shell_1, _shell_2,
                                                 _shell_3, _shell_4);
 
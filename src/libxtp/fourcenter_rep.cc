@@ -20,6 +20,8 @@
 // Overload of uBLAS prod function with MKL/GSL implementations
 
 #include <votca/xtp/fourcenter.h>
+#include <votca/xtp/boysfunction.h>
+#include <votca/xtp/scratcharena.h>
 
 namespace votca {
 namespace xtp {
@@ -38,7 +40,8 @@ namespace xtp {
  *
  */
 
-bool FCMatrix::FillFourCenterRepBlock(tensor4d& block, const AOShell* shell_1,
+bool FCMatrix::FillFourCenterRepBlock(tensor4d_ref& block,
+                                      const AOShell* shell_1,
                                       const AOShell* shell_2,
                                       const AOShell* shell_3,
                                       const AOShell* shell_4) {
@@ -234,9 +237,6 @@ bool FCMatrix::FillFourCenterRepBlock(tensor4d& block, const AOShell* shell_1,
   int _ncombined_ab = AOSuperMatrix::getBlockSize(lmax_alpha + lmax_beta);
   int ncombined_cd = AOSuperMatrix::getBlockSize(lmax_gamma + lmax_delta);
 
-  tensor3d::extent_gen extents;
-  tensor4d::extent_gen extents4;
-
   double _dist_AB = (pos_alpha - pos_beta) * (pos_alpha - pos_beta);
   double _dist_CD = (pos_gamma - pos_delta) * (pos_gamma - pos_delta);
 
@@ -322,34 +322,15 @@ bool FCMatrix::FillFourCenterRepBlock(tensor4d& block, const AOShell* shell_1,
           double wmq1 = wmq.getY();
           double wmq2 = wmq.getZ();
 
-          tensor3d R_temp;
-          R_temp.resize(extents[range(0, _ncombined_ab)][range(0, ncombined_cd)]
-                               [range(0, mmax + 1)]);
-          // initialize to zero
-          for (index3d i = 0; i != _ncombined_ab; ++i) {
-            for (index3d j = 0; j != ncombined_cd; ++j) {
-              for (index3d k = 0; k != mmax + 1; ++k) {
-
-                R_temp[i][j][k] = 0.0;
-              }
-            }
-          }
-
-          tensor3d R;
-          R.resize(extents[range(0, _ncombined_ab)][range(0, _nbeta)]
-                          [range(0, ncombined_cd)]);
-          // initialize to zero
-          for (index3d i = 0; i != _ncombined_ab; ++i) {
-            for (index3d j = 0; j != _nbeta; ++j) {
-              for (index3d k = 0; k != ncombined_cd; ++k) {
-
-                R[i][j][k] = 0.0;
-              }
-            }
-          }
+          // zero initialised, released at the end of this primitive quartet
+          ScratchArena::Frame scratch;
+          tensor3d_ref R_temp =
+              scratch.Tensor3D(_ncombined_ab, ncombined_cd, mmax + 1);
+          tensor3d_ref R =
+              scratch.Tensor3D(_ncombined_ab, _nbeta, ncombined_cd);
 
-          const std::vector<double> FmT =
-              AOMatrix<double>::XIntegrate(mmax + 1, U);
+          double FmT[BoysFunction::MaxSize];
+          BoysFunction::Evaluate(mmax + 1, U, FmT);
 
           double exp_AB =
               exp(-2. * decay_alpha * decay_beta * rzeta * _dist_AB);
@@ -985,8 +966,8 @@ bool FCMatrix::FillFourCenterRepBlock(tensor4d& block, const AOShell* shell_1,
           const Eigen::MatrixXd trafo_alpha = AOSuperMatrix::getTrafo(*italpha);
           const Eigen::MatrixXd trafo_beta = AOSuperMatrix::getTrafo(*itbeta);
 
-          tensor3d R3_ab_sph;
-          R3_ab_sph.resize(extents[ntrafo_alpha][ntrafo_beta][ncombined_cd]);
+          tensor3d_ref R3_ab_sph =
+              scratch.Tensor3D(ntrafo_alpha, ntrafo_beta, ncombined_cd);
 
           for (int i_beta = 0; i_beta < ntrafo_beta; i_beta++) {
             for (int i_alpha = 0; i_alpha < ntrafo_alpha; i_alpha++) {
@@ -1011,11 +992,8 @@ bool FCMatrix::FillFourCenterRepBlock(tensor4d& block, const AOShell* shell_1,
           }
 
           // copy into new 4D array.
-          tensor4d R4_ab_sph;
-          R4_ab_sph.resize(
-              extents4[ntrafo_alpha][ntrafo_beta][ncombined_cd][_ndelta]);
-          // ma4_type R4_ab_sph(boost::extents[ _ntrafo_alpha ][ _ntrafo_beta ][
-          // _ncombined_cd ][ _ndelta ]);
+          tensor4d_ref R4_ab_sph = scratch.Tensor4D(ntrafo_alpha, ntrafo_beta,
+                                                    ncombined_cd, _ndelta);
 
           for (index3d j = 0; j < ntrafo_alpha; ++j) {
             for (index3d k = 0; k < ntrafo_beta; ++k) {
@@ -1177,9 +1155,8 @@ bool FCMatrix::FillFourCenterRepBlock(tensor4d& block, const AOShell* shell_1,
           const Eigen::MatrixXd trafo_gamma = AOSuperMatrix::getTrafo(*itgamma);
           const Eigen::MatrixXd trafo_delta = AOSuperMatrix::getTrafo(*itdelta);
 
-          tensor4d R4_sph;
-          R4_sph.resize(
-              extents4[ntrafo_alpha][ntrafo_beta][ntrafo_gamma][ntrafo_delta]);
+          tensor4d_ref R4_sph = scratch.Tensor4D(ntrafo_alpha, ntrafo_beta,
+                                                 ntrafo_gamma, ntrafo_delta);
 
           for (int j = 0; j < ntrafo_alpha; j++) {
             for (int k = 0; k < ntrafo_beta; k++) {
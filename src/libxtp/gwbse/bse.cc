@@ -225,84 +225,177 @@ void BSE::Add_Hqp(Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& H) {
   return;
 }
 
+// rows vc2index(v,c) hold the auxiliary vectors M_vc of the transitions
+MatrixXfd BSE::StackTransitions() const {
+  int auxsize = _Mmn.auxsize();
+  const int vmin = _opt.vmin - _opt.rpamin;
+  const int cmin = _bse_cmin - _opt.rpamin;
+  MatrixXfd B(_bse_size, auxsize);
+#pragma omp parallel for
+  for (int v = 0; v < _bse_vtotal; v++) {
+    B.middleRows(v * _bse_ctotal, _bse_ctotal) =
+        _Mmn[v + vmin].block(cmin, 0, _bse_ctotal, auxsize);
+  }
+  return B;
+}
+
 template <typename T>
 void BSE::Add_Hd(Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& H) {
   int auxsize = _Mmn.auxsize();
-  vc2index vc = vc2index(0, 0, _bse_ctotal);
   const int vmin = _opt.vmin - _opt.rpamin;
   const int cmin = _bse_cmin - _opt.rpamin;
+  // rows v1*vtotal+v2 hold eps^-1 M_v1v2 for all v1, so that one GEMM per c1
+  // covers all columns vc(v1,c1)
+  MatrixXfd Mvv(_bse_vtotal * _bse_vtotal, auxsize);
 #pragma omp parallel for
   for (int v1 = 0; v1 < _bse_vtotal; v1++) {
-    const MatrixXfd Mmn1T =
-        (_Mmn[v1 + vmin].block(vmin, 0, _bse_vtotal, auxsize) *
-         _epsilon_0_inv.asDiagonal())
-            .transpose();
-    for (int c1 = 0; c1 < _bse_ctotal; c1++) {
-      const MatrixXfd& Mmn2 = _Mmn[c1 + cmin];
-      const MatrixXfd Mmn2xMmn1T =
-          Mmn2.block(cmin, 0, _bse_ctotal, auxsize) * Mmn1T;
-      int i1 = vc.I(v1, c1);
+    Mvv.middleRows(v1 * _bse_vtotal, _bse_vtotal) =
+        _Mmn[v1 + vmin].block(vmin, 0, _bse_vtotal, auxsize) *
+        _epsilon_0_inv.asDiagonal();
+  }
+#pragma omp parallel for
+  for (int c1 = 0; c1 < _bse_ctotal; c1++) {
+    const MatrixXfd Mmn2xMvvT =
+        _Mmn[c1 + cmin].block(cmin, 0, _bse_ctotal, auxsize) *
+        Mvv.transpose();
+    for (int v1 = 0; v1 < _bse_vtotal; v1++) {
+      int i1 = v1 * _bse_ctotal + c1;
       for (int v2 = 0; v2 < _bse_vtotal; v2++) {
-        for (int c2 = 0; c2 < _bse_ctotal; c2++) {
-          int i2 = vc.I(v2, c2);
-          H(i2, i1) -= Mmn2xMmn1T(c2, v2);
-        }
+        H.col(i1).segment(v2 * _bse_ctotal, _bse_ctotal) -=
+            Mmn2xMvvT.col(v1 * _bse_vtotal + v2).cast<T>();
       }
     }
   }
-
   return;
 }
 
 template <typename T, int factor>
 void BSE::Add_Hd2(Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& H) {
   int auxsize = _Mmn.auxsize();
-  vc2index vc = vc2index(0, 0, _bse_ctotal);
   const int vmin = _opt.vmin - _opt.rpamin;
   const int cmin = _bse_cmin - _opt.rpamin;
+  const MatrixXfd B = StackTransitions();
 #pragma omp parallel for
   for (int c1 = 0; c1 < _bse_ctotal; c1++) {
-    const MatrixXfd Mmn2T =
-        factor * (_Mmn[c1 + cmin].block(vmin, 0, _bse_vtotal, auxsize) *
-                  _epsilon_0_inv.asDiagonal())
-                     .transpose();
+    const MatrixXfd Mmn2 =
+        real_gwbse(factor) *
+        (_Mmn[c1 + cmin].block(vmin, 0, _bse_vtotal, auxsize) *
+         _epsilon_0_inv.asDiagonal());
+    // rows vc(v1,c2), columns v2
+    const MatrixXfd BxMmn2T = B * Mmn2.transpose();
     for (int v1 = 0; v1 < _bse_vtotal; v1++) {
-      const MatrixXfd& Mmn1 = _Mmn[v1 + vmin];
-      MatrixXfd Mmn1xMmn2T = Mmn1.block(cmin, 0, _bse_ctotal, auxsize) * Mmn2T;
-      int i1 = vc.I(v1, c1);
+      int i1 = v1 * _bse_ctotal + c1;
       for (int v2 = 0; v2 < _bse_vtotal; v2++) {
-        for (int c2 = 0; c2 < _bse_ctotal; c2++) {
-          int i2 = vc.I(v2, c2);
-          H(i2, i1) -= Mmn1xMmn2T(c2, v2);
-        }
+        H.col(i1).segment(v2 * _bse_ctotal, _bse_ctotal) -=
+            BxMmn2T.col(v2).segment(v1 * _bse_ctotal, _bse_ctotal).cast<T>();
       }
     }
   }
   return;
 }
 
+// H += factor * B * B^T as a SYRK, split into column blocks of the lower
+// triangle which are mirrored to the upper one, so it stays parallel and does
+// not rely on H being symmetric already
 template <typename T, int factor>
 void BSE::Add_Hx(Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& H) {
+  const MatrixXfd B = StackTransitions();
+#pragma omp parallel for schedule(dynamic)
+  for (int v1 = 0; v1 < _bse_vtotal; v1++) {
+    const int start = v1 * _bse_ctotal;
+    const int rows = _bse_size - start;
+    const MatrixXfd BxB1T =
+        real_gwbse(factor) *
+        (B.bottomRows(rows) * B.middleRows(start, _bse_ctotal).transpose());
+    H.block(start, start, rows, _bse_ctotal) += BxB1T.cast<T>();
+    H.block(start, start + _bse_ctotal, _bse_ctotal, rows - _bse_ctotal) +=
+        BxB1T.bottomRows(rows - _bse_ctotal).transpose().cast<T>();
+  }
+  return;
+}
+
+Eigen::MatrixXd BSE::ApplyHs(const Eigen::MatrixXd& X) const {
+  if (X.rows() != _bse_size) {
+    throw std::runtime_error("BSE::ApplyHs: vectors do not have BSE size");
+  }
+  const MatrixXfd Xf = X.cast<real_gwbse>();
+  MatrixXfd HX = MatrixXfd::Zero(_bse_size, X.cols());
+  Apply_Hd(Xf, HX);
+  Apply_Hqp(Xf, HX);
+  Apply_Hx<2>(Xf, HX);
+  return HX.cast<double>();
+}
+
+Eigen::MatrixXd BSE::ApplyHt(const Eigen::MatrixXd& X) const {
+  if (X.rows() != _bse_size) {
+    throw std::runtime_error("BSE::ApplyHt: vectors do not have BSE size");
+  }
+  const MatrixXfd Xf = X.cast<real_gwbse>();
+  MatrixXfd HX = MatrixXfd::Zero(_bse_size, X.cols());
+  Apply_Hd(Xf, HX);
+  Apply_Hqp(Xf, HX);
+  return HX.cast<double>();
+}
+
+// a column of X viewed as ctotal x vtotal matrix x(c,v), see vc2index
+void BSE::Apply_Hqp(const MatrixXfd& X, MatrixXfd& HX) const {
+  int offset = _opt.vmin - _opt.qpmin;
+  const MatrixXfd Hvv =
+      _Hqp.block(offset, offset, _bse_vtotal, _bse_vtotal).cast<real_gwbse>();
+  const MatrixXfd Hcc = _Hqp
+                            .block(_bse_vtotal + offset, _bse_vtotal + offset,
+                                   _bse_ctotal, _bse_ctotal)
+                            .cast<real_gwbse>();
+#pragma omp parallel for
+  for (int i = 0; i < X.cols(); i++) {
+    Eigen::Map<const MatrixXfd> x(X.col(i).data(), _bse_ctotal, _bse_vtotal);
+    Eigen::Map<MatrixXfd> hx(HX.col(i).data(), _bse_ctotal, _bse_vtotal);
+    hx.noalias() += Hcc * x;
+    hx.noalias() -= x * Hvv.transpose();
+  }
+  return;
+}
+
+template <int factor>
+void BSE::Apply_Hx(const MatrixXfd& X, MatrixXfd& HX) const {
   int auxsize = _Mmn.auxsize();
-  vc2index vc = vc2index(0, 0, _bse_ctotal);
   const int vmin = _opt.vmin - _opt.rpamin;
   const int cmin = _bse_cmin - _opt.rpamin;
-#pragma omp parallel for
+  // contract with the auxiliary functions first, Y(a,i)=sum_vc M_vc^a X_vc,i
+  MatrixXfd Y = MatrixXfd::Zero(auxsize, X.cols());
   for (int v1 = 0; v1 < _bse_vtotal; v1++) {
-    const MatrixXfd Mmn1 =
-        factor *
-        (_Mmn[v1 + vmin].block(cmin, 0, _bse_ctotal, auxsize)).transpose();
-    for (int c1 = 0; c1 < _bse_ctotal; c1++) {
-      int i1 = vc.I(v1, c1);
-      for (int v2 = 0; v2 < _bse_vtotal; v2++) {
-        const MatrixXfd& Mmn2 = _Mmn[v2 + vmin];
-        const VectorXfd Mmnx2 =
-            Mmn2.block(cmin, 0, _bse_ctotal, auxsize) * Mmn1.col(c1);
-        for (int c2 = 0; c2 < _bse_ctotal; c2++) {
-          int i2 = vc.I(v2, c2);
-          H(i2, i1) += Mmnx2(c2);
-        }
+    _Mmn.Prefetch(v1 + vmin + 1);
+    Y.noalias() +=
+        _Mmn[v1 + vmin].block(cmin, 0, _bse_ctotal, auxsize).transpose() *
+        X.middleRows(v1 * _bse_ctotal, _bse_ctotal);
+  }
+  Y *= real_gwbse(factor);
+#pragma omp parallel for
+  for (int v2 = 0; v2 < _bse_vtotal; v2++) {
+    HX.middleRows(v2 * _bse_ctotal, _bse_ctotal).noalias() +=
+        _Mmn[v2 + vmin].block(cmin, 0, _bse_ctotal, auxsize) * Y;
+  }
+  return;
+}
+
+void BSE::Apply_Hd(const MatrixXfd& X, MatrixXfd& HX) const {
+  int auxsize = _Mmn.auxsize();
+  const int vmin = _opt.vmin - _opt.rpamin;
+  const int cmin = _bse_cmin - _opt.rpamin;
+#pragma omp parallel for
+  for (int i = 0; i < X.cols(); i++) {
+    Eigen::Map<const MatrixXfd> x(X.col(i).data(), _bse_ctotal, _bse_vtotal);
+    Eigen::Map<MatrixXfd> hx(HX.col(i).data(), _bse_ctotal, _bse_vtotal);
+    MatrixXfd W = MatrixXfd::Zero(_bse_ctotal, auxsize);
+    for (int v1 = 0; v1 < _bse_vtotal; v1++) {
+      // W(c2,a)=sum_c1 M_c1c2^a x(c1,v1)
+      W.setZero();
+      for (int c1 = 0; c1 < _bse_ctotal; c1++) {
+        W += x(c1, v1) * _Mmn[c1 + cmin].block(cmin, 0, _bse_ctotal, auxsize);
       }
+      hx.noalias() -=
+          W * _epsilon_0_inv.asDiagonal() *
+          _Mmn[v1 + vmin].block(vmin, 0, _bse_vtotal, auxsize).transpose();
     }
   }
   return;
@@ -192,6 +192,18 @@ void GWBSE::Initialize(tools::Property& options) {
 
   _gwopt.reset_3c = options.ifExistsReturnElseReturnDefault<int>(
       key + ".rebuild_threecenter_freq", _gwopt.reset_3c);
+  _aux_compression = options.ifExistsReturnElseReturnDefault<double>(
+      key + ".aux_compression", 0.0);
+  _max_memory_3c = options.ifExistsReturnElseReturnDefault<int>(
+      key + ".max_memory_threecenter", 0);
+  if (_max_memory_3c < 0) {
+    throw std::runtime_error(
+        (boost::format("max_memory_threecenter must be >= 0 MB, is %i") %
+         _max_memory_3c)
+            .str());
+  }
+  _scratch_directory = options.ifExistsReturnElseReturnDefault<std::string>(
+      key + ".scratch_directory", ".");
 
   _bseopt.nmax = options.ifExistsReturnElseReturnDefault<int>(key + ".exctotal",
                                                               _bseopt.nmax);
@@ -529,6 +541,13 @@ bool GWBSE::Evaluate() {
   }
 #endif
 
+  PrepareIntegrals();
+  SolveGWBSE();
+  return true;
+}
+
+void GWBSE::PrepareIntegrals() {
+
   if (tools::globals::VOTCA_MKL) {
     CTP_LOG(ctp::logDEBUG, *_pLog)
         << ctp::TimeStamp() << " Using MKL overload for Eigen " << flush;
@@ -557,54 +576,80 @@ bool GWBSE::Evaluate() {
       << ctp::TimeStamp() << " DFT data was created by " << dft_package
       << flush;
 
-  BasisSet dftbs;
-  dftbs.LoadBasisSet(_dftbasis_name);
-
-  CTP_LOG(ctp::logDEBUG, *_pLog) << ctp::TimeStamp() << " Loaded DFT Basis Set "
-                                 << _dftbasis_name << flush;
+  // basis sets shared by an ensemble are parsed only once
+  BasisSet dftbs_own;
+  const BasisSet* dftbs = _dftbasisset;
+  if (dftbs == NULL) {
+    dftbs_own.LoadBasisSet(_dftbasis_name);
+    dftbs = &dftbs_own;
+    CTP_LOG(ctp::logDEBUG, *_pLog)
+        << ctp::TimeStamp() << " Loaded DFT Basis Set " << _dftbasis_name
+        << flush;
+  }
 
   // fill DFT AO basis by going through all atoms
-  AOBasis dftbasis;
-  dftbasis.AOBasisFill(dftbs, _orbitals.QMAtoms(), _fragA);
+  _dftbasis.AOBasisFill(*dftbs, _orbitals.QMAtoms(), _fragA);
   CTP_LOG(ctp::logDEBUG, *_pLog)
       << ctp::TimeStamp() << " Filled DFT Basis of size "
-      << dftbasis.AOBasisSize() << flush;
-  if (dftbasis.getAOBasisFragB() > 0 && dftbasis.getAOBasisFragA() > 0) {
+      << _dftbasis.AOBasisSize() << flush;
+  if (_dftbasis.getAOBasisFragB() > 0 && _dftbasis.getAOBasisFragA() > 0) {
     CTP_LOG(ctp::logDEBUG, *_pLog) << ctp::TimeStamp() << " FragmentA size "
-                                   << dftbasis.getAOBasisFragA() << flush;
+                                   << _dftbasis.getAOBasisFragA() << flush;
     CTP_LOG(ctp::logDEBUG, *_pLog) << ctp::TimeStamp() << " FragmentB size "
-                                   << dftbasis.getAOBasisFragB() << flush;
+                                   << _dftbasis.getAOBasisFragB() << flush;
   }
 
   // load auxiliary basis set (element-wise information) from xml file
-  BasisSet auxbs;
-  auxbs.LoadBasisSet(_auxbasis_name);
-  CTP_LOG(ctp::logDEBUG, *_pLog)
-      << ctp::TimeStamp() << " Loaded Auxbasis Set " << _auxbasis_name << flush;
+  BasisSet auxbs_own;
+  const BasisSet* auxbs = _auxbasisset;
+  if (auxbs == NULL) {
+    auxbs_own.LoadBasisSet(_auxbasis_name);
+    auxbs = &auxbs_own;
+    CTP_LOG(ctp::logDEBUG, *_pLog)
+        << ctp::TimeStamp() << " Loaded Auxbasis Set " << _auxbasis_name
+        << flush;
+  }
 
   // fill auxiliary AO basis by going through all atoms
-  AOBasis auxbasis;
-  auxbasis.AOBasisFill(auxbs, _orbitals.QMAtoms());
+  _auxbasis.AOBasisFill(*auxbs, _orbitals.QMAtoms());
   _orbitals.setAuxbasisName(_auxbasis_name);
   CTP_LOG(ctp::logDEBUG, *_pLog)
       << ctp::TimeStamp() << " Filled Auxbasis of size "
-      << auxbasis.AOBasisSize() << flush;
+      << _auxbasis.AOBasisSize() << flush;
 
-  Eigen::MatrixXd vxc = CalculateVXC(dftbasis);
+  _vxc = CalculateVXC(_dftbasis);
 
-  TCMatrix_gwbse Mmn;
   // rpamin here, because RPA needs till rpamin
-  Mmn.Initialize(auxbasis.AOBasisSize(), _gwopt.rpamin, _gwopt.qpmax,
-                 _gwopt.rpamin, _gwopt.rpamax);
-  Mmn.Fill(auxbasis, dftbasis, _orbitals.MOCoefficients());
+  _Mmn.setOutOfCore(std::size_t(_max_memory_3c) << 20, _scratch_directory);
+  _Mmn.Initialize(_auxbasis.AOBasisSize(), _gwopt.rpamin, _gwopt.qpmax,
+                  _gwopt.rpamin, _gwopt.rpamax);
+  _Mmn.setCompression(_aux_compression);
+  if (_Mmn.isOutOfCore()) {
+    CTP_LOG(ctp::logDEBUG, *_pLog)
+        << ctp::TimeStamp() << " Storing 3c integrals in a scratch file in "
+        << _scratch_directory << " with a memory limit of "
+        << _max_memory_3c << " MB, filled in one pass over the aux shells"
+        << flush;
+  }
+  _Mmn.Fill(_auxbasis, _dftbasis, _orbitals.MOCoefficients());
   CTP_LOG(ctp::logDEBUG, *_pLog)
-      << ctp::TimeStamp() << " Removed " << Mmn.Removedfunctions()
+      << ctp::TimeStamp() << " Removed " << _Mmn.Removedfunctions()
       << " functions from Aux Coulomb matrix to avoid near linear dependencies"
       << flush;
+  if (_aux_compression > 0.0) {
+    CTP_LOG(ctp::logDEBUG, *_pLog)
+        << ctp::TimeStamp() << " Compressed aux space by "
+        << _Mmn.Compressedfunctions() << " functions to " << _Mmn.auxsize()
+        << " with tolerance " << _aux_compression << flush;
+  }
   CTP_LOG(ctp::logDEBUG, *_pLog)
       << ctp::TimeStamp()
       << " Calculated Mmn_beta (3-center-repulsion x orbitals)  " << flush;
-  GW gw = GW(*_pLog, Mmn, vxc, _orbitals.MOEnergies());
+  return;
+}
+
+void GWBSE::SolveGWBSE() {
+  GW gw = GW(*_pLog, _Mmn, _vxc, _orbitals.MOEnergies());
   gw.configure(_gwopt);
   gw.CalculateGWPerturbation();
 
@@ -640,13 +685,13 @@ bool GWBSE::Evaluate() {
 
     // proceed only if BSE requested
     if (_do_bse_singlets || _do_bse_triplets) {
-      BSE bse = BSE(_orbitals, *_pLog, Mmn, Hqp);
+      BSE bse = BSE(_orbitals, *_pLog, _Mmn, Hqp);
       bse.configure(_bseopt);
       if (_do_bse_triplets && _do_bse_diag) {
         bse.Solve_triplets();
         CTP_LOG(ctp::logDEBUG, *_pLog)
             << ctp::TimeStamp() << " Solved BSE for triplets " << flush;
-        bse.Analyze_triplets(dftbasis);
+        bse.Analyze_triplets(_dftbasis);
         if (!_store_bse_triplets) {
           bse.FreeTriplets();
         }
@@ -656,7 +701,7 @@ bool GWBSE::Evaluate() {
         bse.Solve_singlets();
         CTP_LOG(ctp::logDEBUG, *_pLog)
             << ctp::TimeStamp() << " Solved BSE for singlets " << flush;
-        bse.Analyze_singlets(dftbasis);
+        bse.Analyze_singlets(_dftbasis);
         if (!_store_bse_singlets) {
           bse.FreeSinglets();
         }
@@ -673,7 +718,7 @@ bool GWBSE::Evaluate() {
   }
   CTP_LOG(ctp::logDEBUG, *_pLog)
       << ctp::TimeStamp() << " GWBSE calculation finished " << flush;
-  return true;
+  return;
 }
 }  // namespace xtp
 };  // namespace votca
@@ -52,6 +52,7 @@ Eigen::MatrixXd RPA::calculate_epsilon(double frequency) const {
   const double eta2 = _eta * _eta;
 #pragma omp parallel for
   for (int m_level = 0; m_level < n_occ; m_level++) {
+    _Mmn.Prefetch(m_level + 1);
     const double qp_energy_m = _energies(m_level);
 
 #if (GWBSE_DOUBLE)
@@ -35,9 +35,9 @@ Eigen::MatrixXd Sigma_base::CalcExchange() const {
   int qpmin = _opt.qpmin - _opt.rpamin;
 #pragma omp parallel for schedule(dynamic)
   for (int gw_level1 = 0; gw_level1 < _qptotal; gw_level1++) {
-    const MatrixXfd& Mmn1 = _Mmn[gw_level1 + qpmin];
+    const Eigen::Map<const MatrixXfd> Mmn1 = _Mmn[gw_level1 + qpmin];
     for (int gw_level2 = gw_level1; gw_level2 < _qptotal; gw_level2++) {
-      const MatrixXfd& Mmn2 = _Mmn[gw_level2 + qpmin];
+      const Eigen::Map<const MatrixXfd> Mmn2 = _Mmn[gw_level2 + qpmin];
       double sigma_x = -(Mmn1.block(0, 0, occlevel, gwsize)
                              .cwiseProduct(Mmn2.block(0, 0, occlevel, gwsize)))
                             .sum();
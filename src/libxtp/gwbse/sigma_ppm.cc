@@ -43,6 +43,7 @@ Eigen::VectorXd Sigma_PPM::CalcCorrelationDiag(
   // loop over all GW levels
 #pragma omp parallel for
   for (int gw_level = 0; gw_level < _qptotal; gw_level++) {
+    _Mmn.Prefetch(gw_level + qpmin_offset + 1);
     const double qpmin = frequencies(gw_level);
     double sigma_c = 0.0;
     // loop over all functions in GW basis
@@ -101,10 +102,10 @@ Eigen::MatrixXd Sigma_PPM::CalcCorrelationOffDiag(
     const Eigen::VectorXd rpaenergies_thread = _rpa.getRPAInputEnergies();
 #pragma omp for schedule(dynamic)
     for (int gw_level1 = 0; gw_level1 < _qptotal; gw_level1++) {
-      const MatrixXfd& Mmn1 = _Mmn[gw_level1 + qpmin_offset];
+      const Eigen::Map<const MatrixXfd> Mmn1 = _Mmn[gw_level1 + qpmin_offset];
       const double qpmin1 = frequencies(gw_level1);
       for (int gw_level2 = gw_level1 + 1; gw_level2 < _qptotal; gw_level2++) {
-        const MatrixXfd& Mmn2 = _Mmn[gw_level2 + qpmin_offset];
+        const Eigen::Map<const MatrixXfd> Mmn2 = _Mmn[gw_level2 + qpmin_offset];
         const double qpmin2 = frequencies(gw_level2);
         double sigma_c = 0;
         for (int i_gw = 0; i_gw < gwsize; i_gw++) {
@@ -20,6 +20,7 @@
 #include <boost/format.hpp>
 #include <votca/xtp/jobapplication.h>
 #include <votca/xtp/jobcalculatorfactory.h>
+#include <votca/xtp/jobstorecalc.h>
 #include <votca/xtp/version.h>
 
 namespace votca {
@@ -44,6 +45,8 @@ void JobApplication::Initialize(void) {
                       "  number of threads to create");
   AddProgramOptions()("save,s", propt::value<int>()->default_value(1),
                       "  whether or not to save changes to state file");
+  AddProgramOptions()("snapshot,b", propt::value<int>()->default_value(0),
+                      "  read frames from a binary topology snapshot");
   AddProgramOptions()("restart,r", propt::value<string>()->default_value(""),
                       "  restart pattern: 'host(pc1:234) stat(FAILED)'");
   AddProgramOptions()("cache,c", propt::value<int>()->default_value(8),
@@ -52,6 +55,8 @@ void JobApplication::Initialize(void) {
                       "  task(s) to perform: input, run, import");
   AddProgramOptions()("maxjobs,m", propt::value<int>()->default_value(-1),
                       "  maximum number of jobs to process (-1 = inf)");
+  AddProgramOptions()("jobstore,q", propt::value<int>()->default_value(0),
+                      "  claim jobs from an sqlite job store <job_file>.sql");
 }
 
 bool JobApplication::EvaluateOptions(void) {
@@ -87,6 +92,7 @@ void JobApplication::Run() {
   // STATESAVER & PROGRESS OBSERVER
   string statefile = OptionsMap()["file"].as<string>();
   StateSaverSQLite statsav;
+  statsav.UseSnapshot(OptionsMap()["snapshot"].as<int>() == 1);
   statsav.Open(_top, statefile);
 
   ctp::ProgObserver<std::vector<ctp::Job*>, ctp::Job*, ctp::Job::JobResult>
@@ -134,6 +140,12 @@ void JobApplication::BeginEvaluate(
     calculator->setnThreads(nThreads);
     calculator->setProgObserver(obs);
     calculator->Initialize(&_options);
+    JobStoreCalc* storecalc = dynamic_cast<JobStoreCalc*>(calculator);
+    if (storecalc != NULL && OptionsMap()["jobstore"].as<int>() == 1) {
+      storecalc->UseJobStore(OptionsMap()["cache"].as<int>(),
+                             OptionsMap()["maxjobs"].as<int>(),
+                             OptionsMap()["restart"].as<string>());
+    }
     cout << endl;
   }
 }
@@ -141,9 +153,17 @@ void JobApplication::BeginEvaluate(
 bool JobApplication::EvaluateFrame() {
   for (ctp::JobCalculator* calculator : _calculators) {
     cout << "... " << calculator->Identify() << " " << flush;
-    if (_generate_input) calculator->WriteJobFile(&_top);
+    JobStoreCalc* storecalc = dynamic_cast<JobStoreCalc*>(calculator);
+    bool use_store = (storecalc != NULL && storecalc->UsesJobStore());
+    if (_generate_input) {
+      calculator->WriteJobFile(&_top);
+      if (use_store) storecalc->ImportJobFile(&_top);
+    }
     if (_run) calculator->EvaluateFrame(&_top);
-    if (_import) calculator->ReadJobFile(&_top);
+    if (_import) {
+      if (use_store) storecalc->ExportJobFile();
+      calculator->ReadJobFile(&_top);
+    }
     cout << endl;
   }
   return true;
@@ -81,6 +81,20 @@ void EQM::ParseOptionsXML(Property* options) {
   }
 }
 
+// DFT scales roughly with the cube of the number of basis functions of the
+// segment, GW-BSE with the fourth power
+double EQM::JobCost(ctp::Topology* top, ctp::Job* job) {
+  Property job_input = job->getInput();
+  int segId = job_input.get("segment").getAttribute<int>("id");
+  std::vector<ctp::Segment*> segments = {top->getSegment(segId)};
+  std::string basisname =
+      _package_options.ifExistsReturnElseReturnDefault<std::string>(
+          "package.basisset", "");
+  double nfuncs = CountBasisFunctions(segments, basisname);
+  int power = _do_gwbse ? 4 : 3;
+  return std::pow(nfuncs, power);
+}
+
 void EQM::WriteJobFile(ctp::Topology* top) {
 
   cout << endl << "... ... Writing job file: " << flush;
@@ -145,6 +159,8 @@ ctp::Job::JobResult EQM::EvalJob(ctp::Topology* top, ctp::Job* job,
   orbitals.QMAtoms() = interface.Convert(segments);
 
   ctp::Logger* pLog = opThread->getLogger();
+  // threads the job store allocated to this job, 0 without the job store
+  const int job_threads = JobThreads(opThread);
 
   CTP_LOG(ctp::logINFO, *pLog)
       << ctp::TimeStamp() << " Evaluating site " << seg->getId() << flush;
@@ -180,6 +196,7 @@ ctp::Job::JobResult EQM::EvalJob(ctp::Topology* top, ctp::Job* job,
     qmpackage->setLog(&dft_logger);
     qmpackage->setRunDir(work_dir);
     qmpackage->Initialize(_package_options);
+    if (job_threads > 0) qmpackage->setThreads(job_threads);
 
     // create input for DFT
     if (_do_dft_input) {
@@ -243,6 +260,7 @@ ctp::Job::JobResult EQM::EvalJob(ctp::Topology* top, ctp::Job* job,
       gwbse_logger.setPreface(ctp::logDEBUG, (format("\nGWBSE DBG ...")).str());
       gwbse.setLogger(&gwbse_logger);
       gwbse.Initialize(_gwbse_options);
+      if (job_threads > 0) gwbse.setNumofThreads(job_threads);
       gwbse.Evaluate();
       gwbse.addoutput(segment_summary);
       WriteLoggerToFile(work_dir + "/gwbse.log", gwbse_logger);
@@ -20,9 +20,9 @@
 #ifndef _CALC_XTP_EQM_H
 #define _CALC_XTP_EQM_H
 
-#include <votca/ctp/parallelxjobcalc.h>
 #include <votca/ctp/segment.h>
 #include <votca/xtp/gwbse.h>  // including GWBSE functionality
+#include <votca/xtp/jobstorecalc.h>
 #include <votca/xtp/qmpackagefactory.h>
 
 namespace votca {
@@ -37,8 +37,7 @@ namespace xtp {
  * Callname: eqm
  */
 
-class EQM : public ctp::ParallelXJobCalc<vector<ctp::Job *>, ctp::Job *,
-                                         ctp::Job::JobResult> {
+class EQM : public JobStoreCalc {
  public:
   void WriteLoggerToFile(const std::string &logfile, ctp::Logger &logger);
   std::string Identify() { return "eqm"; }
@@ -49,6 +48,9 @@ class EQM : public ctp::ParallelXJobCalc<vector<ctp::Job *>, ctp::Job *,
   void CleanUp() { ; }
   void WriteJobFile(ctp::Topology *top);
 
+ protected:
+  double JobCost(ctp::Topology *top, ctp::Job *job);
+
  private:
   void SetJobToFailed(ctp::Job::JobResult &jres, ctp::Logger *pLog,
                       const string &errormessage);
@@ -25,7 +25,7 @@
 #include <votca/tools/propertyiomanipulator.h>
 
 #include <votca/ctp/logger.h>
-#include <votca/ctp/xinteractor.h>
+#include <votca/xtp/multipolesoa.h>
 
 using namespace boost::filesystem;
 using namespace votca::tools;
@@ -37,6 +37,15 @@ namespace xtp {
 // IEXCITON MEMBER FUNCTIONS         //
 // +++++++++++++++++++++++++++++ //
 
+IEXCITON::~IEXCITON() {
+  for (auto& mps : _mps_cache) {
+    for (ctp::APolarSite* site : mps.second) {
+      delete site;
+    }
+  }
+  _mps_cache.clear();
+}
+
 void IEXCITON::Initialize(tools::Property* options) {
 
   cout << endl
@@ -119,6 +128,26 @@ void IEXCITON::PreProcess(ctp::Topology* top) {
   _mps_mapper.GenerateMap(_xml_file, _emp_file, top);
 }
 
+const std::vector<ctp::APolarSite*>& IEXCITON::GetMpsTemplate(
+    const std::string& mps_file, ctp::QMThread* opThread) {
+  // a few mps files are shared by all pairs, so each is parsed only once
+  _mps_cache_mutex.Lock();
+  auto it = _mps_cache.find(mps_file);
+  if (it == _mps_cache.end()) {
+    try {
+      it = _mps_cache
+               .insert(std::make_pair(mps_file,
+                                      ctp::APS_FROM_MPS(mps_file, 0, opThread)))
+               .first;
+    } catch (...) {
+      _mps_cache_mutex.Unlock();
+      throw;
+    }
+  }
+  _mps_cache_mutex.Unlock();
+  return it->second;
+}
+
 ctp::Job::JobResult IEXCITON::EvalJob(ctp::Topology* top, ctp::Job* job,
                                       ctp::QMThread* opThread) {
 
@@ -146,24 +175,15 @@ ctp::Job::JobResult IEXCITON::EvalJob(ctp::Topology* top, ctp::Job* job,
       << ctp::TimeStamp() << " Evaluating pair " << job_ID << " [" << ID_A
       << ":" << ID_B << "]" << flush;
 
-  vector<ctp::APolarSite*> seg_A_raw =
-      ctp::APS_FROM_MPS(mps_fileA, 0, opThread);
-  vector<ctp::APolarSite*> seg_B_raw =
-      ctp::APS_FROM_MPS(mps_fileB, 0, opThread);
-
-  ctp::PolarSeg seg_A_polar = *(_mps_mapper.MapPolSitesToSeg(seg_A_raw, seg_A));
-  ctp::PolarSeg seg_B_polar = *(_mps_mapper.MapPolSitesToSeg(seg_B_raw, seg_B));
+  ctp::PolarSeg* seg_A_polar =
+      _mps_mapper.MapPolSitesToSeg(GetMpsTemplate(mps_fileA, opThread), seg_A);
+  ctp::PolarSeg* seg_B_polar =
+      _mps_mapper.MapPolSitesToSeg(GetMpsTemplate(mps_fileB, opThread), seg_B);
 
-  double JAB = EvaluatePair(top, &seg_A_polar, &seg_B_polar, pLog);
+  double JAB = EvaluatePair(top, seg_A_polar, seg_B_polar, pLog);
 
-  for (ctp::APolarSite* site : seg_A_raw) {
-    delete site;
-  }
-  seg_A_raw.clear();
-  for (ctp::APolarSite* site : seg_B_raw) {
-    delete site;
-  }
-  seg_B_raw.clear();
+  delete seg_A_polar;
+  delete seg_B_polar;
 
   Property job_summary;
   Property& job_output = job_summary.add("output", "");
@@ -202,22 +222,15 @@ QMState IEXCITON::GetElementFromMap(const std::string& elementname) const {
 double IEXCITON::EvaluatePair(ctp::Topology* top, ctp::PolarSeg* Seg1,
                               ctp::PolarSeg* Seg2, ctp::Logger* pLog) {
 
-  ctp::XInteractor actor;
-  actor.ResetEnergy();
   Seg1->CalcPos();
   Seg2->CalcPos();
   vec s = top->PbShortestConnect(Seg1->getPos(), Seg2->getPos()) +
           Seg1->getPos() - Seg2->getPos();
 
-  double E = 0.0;
-  for (ctp::APolarSite* site1 : *Seg1) {
-    for (ctp::APolarSite* site2 : *Seg2) {
-      actor.BiasIndu(*site1, *site2, s);
-      site1->Depolarize();
-      site2->Depolarize();
-      E += actor.E_f(*site1, *site2);
-    }
-  }
+  // static multipoles only, same as XInteractor::E_f over all site pairs
+  MultipoleSoA sites1(*Seg1);
+  MultipoleSoA sites2(*Seg2);
+  double E = sites1.InteractionEnergy(sites2, s);
 
   if (_cutoff >= 0) {
     if (abs(s) > _cutoff) {
@@ -24,9 +24,10 @@
 
 #include <boost/filesystem.hpp>
 #include <sys/stat.h>
-#include <votca/ctp/parallelxjobcalc.h>
 #include <votca/ctp/xjob.h>
 #include <votca/ctp/xmapper.h>
+#include <votca/tools/mutex.h>
+#include <votca/xtp/jobstorecalc.h>
 #include <votca/xtp/qmstate.h>
 
 namespace votca {
@@ -41,11 +42,12 @@ namespace xtp {
  * Callname: iexcitoncl
  */
 
-class IEXCITON : public ctp::ParallelXJobCalc<vector<ctp::Job *>, ctp::Job *,
-                                              ctp::Job::JobResult> {
+class IEXCITON : public JobStoreCalc {
  public:
   void Initialize(tools::Property *options);
 
+  ~IEXCITON();
+
   string Identify() { return "iexcitoncl"; }
 
   ctp::Job::JobResult EvalJob(ctp::Topology *top, ctp::Job *job,
@@ -64,6 +66,11 @@ class IEXCITON : public ctp::ParallelXJobCalc<vector<ctp::Job *>, ctp::Job *,
   std::map<std::string, QMState> _statemap;
   string _emp_file;
   string _xml_file;
+  // parsed mps files, shared read-only by all threads once parsed
+  std::map<std::string, std::vector<ctp::APolarSite *> > _mps_cache;
+  tools::Mutex _mps_cache_mutex;
+  const std::vector<ctp::APolarSite *> &GetMpsTemplate(
+      const std::string &mps_file, ctp::QMThread *opThread);
   void PreProcess(ctp::Topology *top);
   double EvaluatePair(ctp::Topology *top, ctp::PolarSeg *Seg1,
                       ctp::PolarSeg *Seg2, ctp::Logger *pLog);
@@ -128,6 +128,9 @@ void IQM::ParseOptionsXML(votca::tools::Property& opt) {
   // job file specification
   key = "options." + Identify();
 
+  _monomer_orbitals.setCapacity(
+      opt.ifExistsReturnElseReturnDefault<int>(key + ".monomer_cache", 16));
+
   if (opt.exists(key + ".job_file")) {
     _jobfile = opt.get(key + ".job_file").as<string>();
   } else {
@@ -182,6 +185,24 @@ bool IQM::isLinker(const std::string& name) {
           _linker_names.end());
 }
 
+// DFT scales roughly with the cube of the number of basis functions of the
+// pair, GW-BSE with the fourth power
+double IQM::JobCost(ctp::Topology* top, ctp::Job* job) {
+  Property job_input = job->getInput();
+  std::vector<ctp::Segment*> segments;
+  for (Property* segment : job_input.Select("segment")) {
+    segments.push_back(top->getSegment(segment->getAttribute<int>("id")));
+  }
+  if (_linker_names.size() > 0 && segments.size() == 2) {
+    addLinkers(segments, top);
+  }
+  std::string basisname = _dftpackage_options.ifExistsReturnElseReturnDefault<
+      std::string>("package.basisset", "");
+  double nfuncs = CountBasisFunctions(segments, basisname);
+  int power = (_do_gwbse || _do_bsecoupling) ? 4 : 3;
+  return std::pow(nfuncs, power);
+}
+
 void IQM::WriteCoordinatesToOrbitalsPBC(ctp::QMPair& pair, Orbitals& orbitals) {
 
   ctp::Segment* seg1 = pair.Seg1();
@@ -217,6 +238,28 @@ void IQM::SetJobToFailed(ctp::Job::JobResult& jres, ctp::Logger* pLog,
   jres.setStatus(ctp::Job::FAILED);
 }
 
+bool IQM::LoadMonomerOrbitals(const string& orbFileA, const string& orbFileB,
+                              std::shared_ptr<const Orbitals>& orbitalsA,
+                              std::shared_ptr<const Orbitals>& orbitalsB,
+                              ctp::Job::JobResult& jres, ctp::Logger* pLog) {
+  if (orbitalsA && orbitalsB) return true;
+  try {
+    orbitalsA = _monomer_orbitals.Get(orbFileA);
+  } catch (std::runtime_error& error) {
+    SetJobToFailed(jres, pLog,
+                   "Do input: failed loading orbitals from " + orbFileA);
+    return false;
+  }
+  try {
+    orbitalsB = _monomer_orbitals.Get(orbFileB);
+  } catch (std::runtime_error& error) {
+    SetJobToFailed(jres, pLog,
+                   "Do input: failed loading orbitals from " + orbFileB);
+    return false;
+  }
+  return true;
+}
+
 void IQM::WriteLoggerToFile(const string& logfile, ctp::Logger& logger) {
   std::ofstream ofs;
   ofs.open(logfile.c_str(), std::ofstream::out);
@@ -239,6 +282,8 @@ ctp::Job::JobResult IQM::EvalJob(ctp::Topology* top, ctp::Job* job,
       "frame_" + boost::lexical_cast<string>(top->getDatabaseId());
 
   ctp::Logger* pLog = opThread->getLogger();
+  // threads the job store allocated to this job, 0 without the job store
+  const int job_threads = JobThreads(opThread);
 
   // get the information about the job executed by the thread
   int job_ID = job->getId();
@@ -301,6 +346,10 @@ ctp::Job::JobResult IQM::EvalJob(ctp::Topology* top, ctp::Job* job,
     WriteCoordinatesToOrbitalsPBC(*pair, orbitalsAB);
   }
 
+  // read once per job from the cache, only if needed
+  std::shared_ptr<const Orbitals> orbitalsA;
+  std::shared_ptr<const Orbitals> orbitalsB;
+
   if (_do_dft_input || _do_dft_run || _do_dft_parse) {
     string qmpackage_work_dir =
         (arg_path / iqm_work_dir / package_append / frame_dir / pair_dir)
@@ -317,6 +366,7 @@ ctp::Job::JobResult IQM::EvalJob(ctp::Topology* top, ctp::Job* job,
     qmpackage->setLog(&dft_logger);
     qmpackage->setRunDir(qmpackage_work_dir);
     qmpackage->Initialize(_dftpackage_options);
+    if (job_threads > 0) qmpackage->setThreads(job_threads);
 
     // if asked, prepare the input files
     if (_do_dft_input) {
@@ -352,40 +402,38 @@ ctp::Job::JobResult IQM::EvalJob(ctp::Topology* top, ctp::Job* job,
               gbwFileB, gbwFileB_workdir,
               boost::filesystem::copy_option::overwrite_if_exists);
         } else {
-          Orbitals orbitalsB;
-          Orbitals orbitalsA;
-
-          try {
-            orbitalsA.ReadFromCpt(orbFileA);
-          } catch (std::runtime_error& error) {
-            SetJobToFailed(
-                jres, pLog,
-                "Do input: failed loading orbitals from " + orbFileA);
-            delete qmpackage;
-            return jres;
-          }
-
-          try {
-            orbitalsB.ReadFromCpt(orbFileB);
-          } catch (std::runtime_error& error) {
-            SetJobToFailed(
-                jres, pLog,
-                "Do input: failed loading orbitals from " + orbFileB);
+          if (!LoadMonomerOrbitals(orbFileA, orbFileB, orbitalsA, orbitalsB,
+                                   jres, pLog)) {
             delete qmpackage;
             return jres;
           }
           CTP_LOG(ctp::logDEBUG, *pLog)
               << "Constructing the guess for dimer orbitals" << flush;
-          orbitalsAB.PrepareDimerGuess(orbitalsA, orbitalsB);
+          orbitalsAB.PrepareDimerGuess(*orbitalsA, *orbitalsB);
         }
       } else {
         CTP_LOG(ctp::logINFO, *pLog)
             << "No Guess requested, starting from DFT starting Guess" << flush;
       }
+    }
+
+    // the internal engine runs on orbitalsAB directly, without input,
+    // log and checkpoint files
+    bool in_memory = _do_dft_input && _do_dft_run && _do_dft_parse &&
+                     qmpackage->SupportsInMemory();
+    if (in_memory) {
+      CTP_LOG(ctp::logDEBUG, *pLog) << "Running DFT in memory" << flush;
+      bool run_dft_status = qmpackage->RunInMemory(orbitalsAB);
+      if (!run_dft_status) {
+        SetJobToFailed(jres, pLog, qmpackage->getPackageName() + " run failed");
+        delete qmpackage;
+        return jres;
+      }
+    } else if (_do_dft_input) {
       qmpackage->WriteInputFile(orbitalsAB);
     }
 
-    if (_do_dft_run) {
+    if (_do_dft_run && !in_memory) {
       CTP_LOG(ctp::logDEBUG, *pLog) << "Running DFT" << flush;
       bool _run_dft_status = qmpackage->Run();
       if (!_run_dft_status) {
@@ -395,7 +443,7 @@ ctp::Job::JobResult IQM::EvalJob(ctp::Topology* top, ctp::Job* job,
       }
     }
 
-    if (_do_dft_parse) {
+    if (_do_dft_parse && !in_memory) {
       bool parse_log_status = qmpackage->ParseLogFile(orbitalsAB);
       if (!parse_log_status) {
         SetJobToFailed(jres, pLog, "LOG parsing failed");
@@ -426,31 +474,21 @@ ctp::Job::JobResult IQM::EvalJob(ctp::Topology* top, ctp::Job* job,
   }
   Property _job_summary;
   Property& job_output = _job_summary.add("output", "");
+  // the overlap of monomer and dimer basis is set up once for both couplings
+  std::shared_ptr<DimerProjection> projection =
+      std::make_shared<DimerProjection>();
   if (_do_dftcoupling) {
     DFTcoupling dftcoupling;
     dftcoupling.setLogger(pLog);
+    dftcoupling.setDimerProjection(projection);
     dftcoupling.Initialize(_dftcoupling_options);
-    Orbitals orbitalsB;
-    Orbitals orbitalsA;
-
-    try {
-      orbitalsA.ReadFromCpt(orbFileA);
-    } catch (std::runtime_error& error) {
-      SetJobToFailed(jres, pLog,
-                     "Do input: failed loading orbitals from " + orbFileA);
-      return jres;
-    }
-
-    try {
-      orbitalsB.ReadFromCpt(orbFileB);
-    } catch (std::runtime_error& error) {
-      SetJobToFailed(jres, pLog,
-                     "Do input: failed loading orbitals from " + orbFileB);
+    if (!LoadMonomerOrbitals(orbFileA, orbFileB, orbitalsA, orbitalsB, jres,
+                             pLog)) {
       return jres;
     }
     try {
-      dftcoupling.CalculateCouplings(orbitalsA, orbitalsB, orbitalsAB);
-      dftcoupling.Addoutput(job_output, orbitalsA, orbitalsB);
+      dftcoupling.CalculateCouplings(*orbitalsA, *orbitalsB, orbitalsAB);
+      dftcoupling.Addoutput(job_output, *orbitalsA, *orbitalsB);
     } catch (std::runtime_error& error) {
       std::string errormessage(error.what());
       SetJobToFailed(jres, pLog, errormessage);
@@ -472,6 +510,7 @@ ctp::Job::JobResult IQM::EvalJob(ctp::Topology* top, ctp::Job* job,
       GWBSE gwbse = GWBSE(orbitalsAB);
       gwbse.setLogger(&gwbse_logger);
       gwbse.Initialize(_gwbse_options);
+      if (job_threads > 0) gwbse.setNumofThreads(job_threads);
       gwbse.Evaluate();
       WriteLoggerToFile(work_dir + "/gwbse.log", gwbse_logger);
     } catch (std::runtime_error& error) {
@@ -498,22 +537,8 @@ ctp::Job::JobResult IQM::EvalJob(ctp::Topology* top, ctp::Job* job,
       }
     }
 
-    Orbitals orbitalsB;
-    Orbitals orbitalsA;
-
-    try {
-      orbitalsA.ReadFromCpt(orbFileA);
-    } catch (std::runtime_error& error) {
-      SetJobToFailed(jres, pLog,
-                     "Do input: failed loading orbitals from " + orbFileA);
-      return jres;
-    }
-
-    try {
-      orbitalsB.ReadFromCpt(orbFileB);
-    } catch (std::runtime_error& error) {
-      SetJobToFailed(jres, pLog,
-                     "Do input: failed loading orbitals from " + orbFileB);
+    if (!LoadMonomerOrbitals(orbFileA, orbFileB, orbitalsA, orbitalsB, jres,
+                             pLog)) {
       return jres;
     }
 
@@ -529,9 +554,11 @@ ctp::Job::JobResult IQM::EvalJob(ctp::Topology* top, ctp::Job* job,
       bsecoupling_logger.setPreface(ctp::logDEBUG,
                                     (format("\nGWBSE DBG ...")).str());
       bsecoupling.setLogger(&bsecoupling_logger);
+      bsecoupling.setDimerProjection(projection);
       bsecoupling.Initialize(_bsecoupling_options);
-      bsecoupling.CalculateCouplings(orbitalsA, orbitalsB, orbitalsAB);
-      bsecoupling.Addoutput(job_output, orbitalsA, orbitalsB);
+      if (job_threads > 0) bsecoupling.setNumofThreads(job_threads);
+      bsecoupling.CalculateCouplings(*orbitalsA, *orbitalsB, orbitalsAB);
+      bsecoupling.Addoutput(job_output, *orbitalsA, *orbitalsB);
       WriteLoggerToFile(work_dir + "/bsecoupling.log", bsecoupling_logger);
     } catch (std::runtime_error& error) {
       std::string errormessage(error.what());
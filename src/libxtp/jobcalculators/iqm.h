@@ -24,11 +24,12 @@
 
 #include <boost/filesystem.hpp>
 #include <sys/stat.h>
-#include <votca/ctp/parallelxjobcalc.h>
 #include <votca/xtp/bsecoupling.h>
 #include <votca/xtp/dftcoupling.h>
 #include <votca/xtp/gwbse.h>
+#include <votca/xtp/jobstorecalc.h>
 #include <votca/xtp/orbitals.h>
+#include <votca/xtp/orbitalscache.h>
 
 namespace votca {
 namespace xtp {
@@ -43,8 +44,7 @@ namespace xtp {
  * Callname: iqm
  */
 
-class IQM : public ctp::ParallelXJobCalc<vector<ctp::Job*>, ctp::Job*,
-                                         ctp::Job::JobResult> {
+class IQM : public JobStoreCalc {
  public:
   void Initialize(tools::Property* options);
   string Identify() { return "iqm"; }
@@ -53,6 +53,9 @@ class IQM : public ctp::ParallelXJobCalc<vector<ctp::Job*>, ctp::Job*,
   void WriteJobFile(ctp::Topology* top);
   void ReadJobFile(ctp::Topology* top);
 
+ protected:
+  double JobCost(ctp::Topology* top, ctp::Job* job);
+
  private:
   double GetBSECouplingFromProp(tools::Property& bseprop, const QMState& stateA,
                                 const QMState& stateB);
@@ -61,6 +64,10 @@ class IQM : public ctp::ParallelXJobCalc<vector<ctp::Job*>, ctp::Job*,
   void SetJobToFailed(ctp::Job::JobResult& jres, ctp::Logger* pLog,
                       const string& errormessage);
   void WriteLoggerToFile(const string& logfile, ctp::Logger& logger);
+  bool LoadMonomerOrbitals(const string& orbFileA, const string& orbFileB,
+                           std::shared_ptr<const Orbitals>& orbitalsA,
+                           std::shared_ptr<const Orbitals>& orbitalsB,
+                           ctp::Job::JobResult& jres, ctp::Logger* pLog);
   void addLinkers(std::vector<ctp::Segment*>& segments, ctp::Topology* top);
   bool isLinker(const std::string& name);
   void WriteCoordinatesToOrbitalsPBC(ctp::QMPair& pair, Orbitals& orbitals);
@@ -86,6 +93,9 @@ class IQM : public ctp::ParallelXJobCalc<vector<ctp::Job*>, ctp::Job*,
 
   std::vector<std::string> _linker_names;
 
+  // monomer orbitals shared by the pair jobs of all threads
+  OrbitalsCache _monomer_orbitals;
+
   // what to write in the storage
   bool _store_dft;
   bool _store_singlets;
@@ -21,13 +21,13 @@
 #define VOTCA_XTP_QMAPECALC_H
 
 #include <boost/format.hpp>
-#include <votca/ctp/parallelxjobcalc.h>
 #include <votca/ctp/pewald3d.h>
 #include <votca/ctp/xinductor.h>
 #include <votca/ctp/xinteractor.h>
 #include <votca/ctp/xjob.h>
 #include <votca/ctp/xmapper.h>
 #include <votca/xtp/gwbse.h>
+#include <votca/xtp/jobstorecalc.h>
 #include <votca/xtp/qmapemachine.h>
 
 using boost::format;
@@ -35,8 +35,7 @@ using boost::format;
 namespace votca {
 namespace xtp {
 
-class QMAPE : public ctp::ParallelXJobCalc<vector<ctp::Job *>, ctp::Job *,
-                                           ctp::Job::JobResult> {
+class QMAPE : public JobStoreCalc {
 
  public:
   QMAPE(){};
@@ -20,20 +20,19 @@
 #define __QMMMCALC__H
 
 #include <boost/format.hpp>
-#include <votca/ctp/parallelxjobcalc.h>
 #include <votca/ctp/xinductor.h>
 #include <votca/ctp/xinteractor.h>
 #include <votca/ctp/xjob.h>
 #include <votca/ctp/xmapper.h>
 #include <votca/xtp/gwbse.h>
+#include <votca/xtp/jobstorecalc.h>
 #include <votca/xtp/qmmachine.h>
 
 namespace votca {
 namespace xtp {
 using boost::format;
 
-class QMMM : public ctp::ParallelXJobCalc<vector<ctp::Job *>, ctp::Job *,
-                                          ctp::Job::JobResult> {
+class QMMM : public JobStoreCalc {
 
  public:
   QMMM(){};
@@ -264,10 +263,14 @@ ctp::Job::JobResult QMMM::EvalJob(ctp::Topology *top, ctp::Job *job,
   QMPackage *qmpack = QMPackages().Create(_package);
   qmpack->Initialize(_qmpack_opt);
   qmpack->setLog(&qlog);
+  // threads the job store allocated to this job, 0 without the job store
+  const int job_threads = JobThreads(thread);
+  if (job_threads > 0) qmpack->setThreads(job_threads);
 
   QMMachine machine =
       QMMachine(&xjob, &xind, qmpack, &_options, "options." + Identify());
   machine.setLog(thread->getLogger());
+  machine.setThreads(job_threads);
 
   // EVALUATE: ITERATE UNTIL CONVERGED
   int error = machine.Evaluate(&xjob);
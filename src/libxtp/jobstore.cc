@@ -0,0 +1,371 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <boost/algorithm/string.hpp>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <votca/tools/statement.h>
+#include <votca/xtp/jobstore.h>
+
+namespace votca {
+namespace xtp {
+
+namespace {
+// rolls an open write transaction back unless it was committed, so an
+// exception does not keep the other processes locked out of the database
+class WriteTransaction {
+ public:
+  explicit WriteTransaction(tools::Database& db) : _db(db) {
+    _db.Exec("BEGIN IMMEDIATE");
+  }
+  ~WriteTransaction() {
+    if (_committed) return;
+    try {
+      _db.Exec("ROLLBACK");
+    } catch (std::exception&) {
+      // sqlite has already rolled back after some errors
+    }
+  }
+  void Commit() {
+    _db.Exec("COMMIT");
+    _committed = true;
+  }
+
+ private:
+  WriteTransaction(const WriteTransaction&) = delete;
+  WriteTransaction& operator=(const WriteTransaction&) = delete;
+  tools::Database& _db;
+  bool _committed = false;
+};
+}  // namespace
+
+void JobDatabase::onCreate() {
+  Exec(
+      "CREATE TABLE jobs ("
+      "id     INTEGER PRIMARY KEY,"
+      "tag    TEXT NOT NULL,"
+      "input  TEXT NOT NULL,"
+      "status TEXT NOT NULL,"
+      "host   TEXT NOT NULL DEFAULT '',"
+      "time   TEXT NOT NULL DEFAULT '',"
+      "output TEXT NOT NULL DEFAULT '',"
+      "error  TEXT NOT NULL DEFAULT '',"
+      "cost   REAL NOT NULL DEFAULT 1.0)");
+  // claiming the most expensive available jobs is an index lookup
+  Exec("CREATE INDEX jobs_status ON jobs (status, cost DESC, id)");
+}
+
+void JobStore::Open(const std::string& file) {
+  tools::MutexLocker lock(_mutex);
+  _db.OpenHelper(file.c_str());
+  // other processes hold the write lock only for single claims and reports
+  _db.Exec("PRAGMA busy_timeout = 600000");
+  return;
+}
+
+int JobStore::ImportJobs(const std::string& xmlfile,
+                         const std::function<double(ctp::Job*)>& cost) {
+  std::vector<ctp::Job*> jobs = ctp::LOAD_JOBS(xmlfile);
+  tools::MutexLocker lock(_mutex);
+  _db.BeginTransaction();
+  tools::Statement* stmt = _db.Prepare(
+      "INSERT OR REPLACE INTO jobs "
+      "(id, tag, input, status, host, time, output, error, cost) "
+      "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)");
+  for (ctp::Job* job : jobs) {
+    tools::Property output;
+    if (job->hasOutput()) output = job->getOutput();
+    stmt->Bind(1, job->getId());
+    stmt->Bind(2, job->getTag());
+    stmt->Bind(3, EncodeProperty(job->getInput()));
+    stmt->Bind(4, job->getStatusStr());
+    stmt->Bind(5, job->hasHost() ? job->getHost() : std::string(""));
+    stmt->Bind(6, job->hasTime() ? job->getTime() : std::string(""));
+    stmt->Bind(7, job->hasOutput() ? EncodeProperty(output) : std::string(""));
+    stmt->Bind(8, job->hasError() ? job->getError() : std::string(""));
+    stmt->Bind(9, cost ? cost(job) : 1.0);
+    stmt->InsertStep();
+    stmt->Reset();
+  }
+  delete stmt;
+  _db.EndTransaction();
+
+  int njobs = int(jobs.size());
+  for (ctp::Job* job : jobs) {
+    delete job;
+  }
+  return njobs;
+}
+
+void JobStore::ExportJobs(const std::string& xmlfile) {
+  tools::MutexLocker lock(_mutex);
+  std::ofstream ofs;
+  ofs.open(xmlfile.c_str(), std::ofstream::out);
+  if (!ofs.is_open()) {
+    throw std::runtime_error("Bad file handle: " + xmlfile);
+  }
+  ofs << "<jobs>" << std::endl;
+  tools::Statement* stmt = _db.Prepare(
+      "SELECT id, tag, input, status, host, time, output, error "
+      "FROM jobs ORDER BY id");
+  while (stmt->Step() != SQLITE_DONE) {
+    tools::Property wrapper;
+    tools::Property& prop = wrapper.add("job", "");
+    prop.add("id", std::to_string(stmt->Column<int>(0)));
+    prop.add("tag", stmt->Column<std::string>(1));
+    DecodeProperty(stmt->Column<std::string>(2), prop);
+    prop.add("status", stmt->Column<std::string>(3));
+    const std::string host = stmt->Column<std::string>(4);
+    const std::string time = stmt->Column<std::string>(5);
+    const std::string output = stmt->Column<std::string>(6);
+    const std::string error = stmt->Column<std::string>(7);
+    if (host != "") prop.add("host", host);
+    if (time != "") prop.add("time", time);
+    if (output != "") DecodeProperty(output, prop);
+    if (error != "") prop.add("error", error);
+    ctp::Job job(&prop);
+    job.ToStream(ofs, "xml");
+  }
+  delete stmt;
+  ofs << "</jobs>" << std::endl;
+  ofs.close();
+  return;
+}
+
+int JobStore::CountJobs(const std::string& status) {
+  tools::MutexLocker lock(_mutex);
+  tools::Statement* stmt =
+      _db.Prepare("SELECT COUNT(*) FROM jobs WHERE status = ?");
+  stmt->Bind(1, status);
+  stmt->Step();
+  int count = stmt->Column<int>(0);
+  delete stmt;
+  return count;
+}
+
+void JobStore::ResetJobs(const std::string& restart_pattern) {
+  // same syntax as the restart option of the xml job file,
+  // e.g. "host(pckr124:1234,pckr125:1235) stat(FAILED)"
+  std::set<std::string> hosts;
+  std::set<std::string> stats;
+  std::vector<std::string> patterns;
+  boost::split(patterns, restart_pattern, boost::is_any_of(" "),
+               boost::token_compress_on);
+  for (const std::string& pattern : patterns) {
+    std::vector<std::string> split;
+    boost::split(split, pattern, boost::is_any_of("(,)"),
+                 boost::token_compress_on);
+    if (split.size() < 2) continue;
+    for (unsigned i = 1; i < split.size(); i++) {
+      if (split[i] == "") continue;
+      if (split[0] == "host") {
+        hosts.insert(split[i]);
+      } else if (split[0] == "stat") {
+        stats.insert(split[i]);
+      } else {
+        throw std::runtime_error("Restart pattern " + pattern +
+                                 " not understood");
+      }
+    }
+  }
+
+  tools::MutexLocker lock(_mutex);
+  _db.BeginTransaction();
+  tools::Statement* stmt = _db.Prepare(
+      "UPDATE jobs SET status = 'AVAILABLE', host = '', time = '', "
+      "output = '', error = '' WHERE status = ?");
+  for (const std::string& stat : stats) {
+    stmt->Bind(1, stat);
+    stmt->InsertStep();
+    stmt->Reset();
+  }
+  delete stmt;
+  stmt = _db.Prepare(
+      "UPDATE jobs SET status = 'AVAILABLE', host = '', time = '', "
+      "output = '', error = '' WHERE host = ? AND status != 'COMPLETE'");
+  for (const std::string& host : hosts) {
+    stmt->Bind(1, host);
+    stmt->InsertStep();
+    stmt->Reset();
+  }
+  delete stmt;
+  _db.EndTransaction();
+  return;
+}
+
+double JobStore::MeanCost(const std::string& status) {
+  tools::MutexLocker lock(_mutex);
+  tools::Statement* stmt =
+      _db.Prepare("SELECT AVG(cost) FROM jobs WHERE status = ?");
+  stmt->Bind(1, status);
+  stmt->Step();
+  double mean = stmt->Column<double>(0);
+  delete stmt;
+  return (mean > 0.0) ? mean : 1.0;
+}
+
+std::vector<ctp::Job*> JobStore::ClaimJobs(int n, const std::string& host,
+                                           std::vector<double>* costs) {
+  std::vector<ctp::Job*> jobs;
+  const std::string time = CurrentTime();
+  tools::MutexLocker lock(_mutex);
+  // take the write lock before reading, so no other process claims the same
+  WriteTransaction transaction(_db);
+  tools::Statement* stmt = _db.Prepare(
+      "SELECT id, tag, input, cost FROM jobs WHERE status = 'AVAILABLE' "
+      "ORDER BY cost DESC, id LIMIT ?");
+  stmt->Bind(1, n);
+  while (stmt->Step() != SQLITE_DONE) {
+    tools::Property wrapper;
+    tools::Property& prop = wrapper.add("job", "");
+    prop.add("id", std::to_string(stmt->Column<int>(0)));
+    prop.add("tag", stmt->Column<std::string>(1));
+    DecodeProperty(stmt->Column<std::string>(2), prop);
+    prop.add("status", "ASSIGNED");
+    prop.add("host", host);
+    prop.add("time", time);
+    jobs.push_back(new ctp::Job(&prop));
+    if (costs != NULL) costs->push_back(stmt->Column<double>(3));
+  }
+  delete stmt;
+  // rows are not updated while the select still walks the status index
+  stmt = _db.Prepare(
+      "UPDATE jobs SET status = 'ASSIGNED', host = ?, time = ? WHERE id = ?");
+  for (ctp::Job* job : jobs) {
+    stmt->Bind(1, host);
+    stmt->Bind(2, time);
+    stmt->Bind(3, job->getId());
+    stmt->InsertStep();
+    stmt->Reset();
+  }
+  delete stmt;
+  transaction.Commit();
+  return jobs;
+}
+
+void JobStore::ReportJob(ctp::Job& job, ctp::Job::JobResult& result,
+                         const std::string& host) {
+  job.SaveResults(&result);
+  tools::Property output;
+  if (job.hasOutput()) output = job.getOutput();
+  const std::string code = job.hasOutput() ? EncodeProperty(output) : "";
+  const std::string error = job.hasError() ? job.getError() : "";
+  const std::string time = CurrentTime();
+
+  tools::MutexLocker lock(_mutex);
+  tools::Statement* stmt = _db.Prepare(
+      "UPDATE jobs SET status = ?, host = ?, time = ?, output = ?, error = ? "
+      "WHERE id = ?");
+  stmt->Bind(1, job.getStatusStr());
+  stmt->Bind(2, host);
+  stmt->Bind(3, time);
+  stmt->Bind(4, code);
+  stmt->Bind(5, error);
+  stmt->Bind(6, job.getId());
+  stmt->InsertStep();
+  delete stmt;
+  return;
+}
+
+std::string JobStore::CurrentTime() {
+  char buffer[64];
+  std::time_t now = std::time(nullptr);
+  std::strftime(buffer, sizeof(buffer), "%Y-%b-%d %H:%M:%S",
+                std::localtime(&now));
+  return std::string(buffer);
+}
+
+// Properties are stored as nested length prefixed strings
+// "<name><value><nattributes>{<key><value>}<nchildren>{<child>}"
+// with every string written as "<length>:<characters>", so values may contain
+// any character, including xml markup
+void JobStore::EncodeString(const std::string& value, std::string& code) {
+  code += std::to_string(value.size());
+  code += ':';
+  code += value;
+  return;
+}
+
+std::string JobStore::EncodeProperty(tools::Property& prop) {
+  std::string code;
+  EncodeString(prop.name(), code);
+  EncodeString(prop.value(), code);
+  std::vector<std::pair<std::string, std::string> > attributes;
+  for (tools::Property::AttributeIterator it = prop.firstAttribute();
+       it != prop.lastAttribute(); ++it) {
+    attributes.push_back(std::make_pair(it->first, it->second));
+  }
+  EncodeString(std::to_string(attributes.size()), code);
+  for (const auto& attribute : attributes) {
+    EncodeString(attribute.first, code);
+    EncodeString(attribute.second, code);
+  }
+  int nchildren = 0;
+  std::string children;
+  for (tools::Property::iterator it = prop.begin(); it != prop.end(); ++it) {
+    children += EncodeProperty(*it);
+    nchildren++;
+  }
+  EncodeString(std::to_string(nchildren), code);
+  code += children;
+  return code;
+}
+
+std::string JobStore::DecodeString(const std::string& code, size_t& pos) {
+  size_t colon = code.find(':', pos);
+  if (colon == std::string::npos) {
+    throw std::runtime_error("Corrupt property in job store");
+  }
+  size_t length = std::stoul(code.substr(pos, colon - pos));
+  if (colon + 1 + length > code.size()) {
+    throw std::runtime_error("Corrupt property in job store");
+  }
+  std::string value = code.substr(colon + 1, length);
+  pos = colon + 1 + length;
+  return value;
+}
+
+void JobStore::DecodeNode(const std::string& code, size_t& pos,
+                          tools::Property& parent) {
+  std::string name = DecodeString(code, pos);
+  std::string value = DecodeString(code, pos);
+  tools::Property& prop = parent.add(name, value);
+  int nattributes = std::stoi(DecodeString(code, pos));
+  for (int i = 0; i < nattributes; i++) {
+    std::string key = DecodeString(code, pos);
+    prop.setAttribute(key, DecodeString(code, pos));
+  }
+  int nchildren = std::stoi(DecodeString(code, pos));
+  for (int i = 0; i < nchildren; i++) {
+    DecodeNode(code, pos, prop);
+  }
+  return;
+}
+
+void JobStore::DecodeProperty(const std::string& code,
+                              tools::Property& parent) {
+  size_t pos = 0;
+  DecodeNode(code, pos, parent);
+  return;
+}
+
+}  // namespace xtp
+}  // namespace votca
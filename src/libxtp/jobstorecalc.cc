@@ -0,0 +1,224 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <unistd.h>
+#include <votca/xtp/basisset.h>
+#include <votca/xtp/jobstorecalc.h>
+#include <votca/xtp/votca_config.h>
+
+namespace votca {
+namespace xtp {
+
+class JobStoreCalc::JobStoreOperator : public ctp::QMThread {
+ public:
+  JobStoreOperator(int id, ctp::Topology* top, JobStoreCalc* master)
+      : _top(top), _master(master), _threads(0) {
+    setId(id);
+  }
+
+  int getJobThreads() const { return _threads; }
+
+  void Run() {
+    double cost = 1.0;
+    while (ctp::Job* job = _master->NextJob(cost)) {
+      _threads = _master->AllocateThreads(cost);
+#ifdef _OPENMP
+      omp_set_num_threads(_threads);
+#endif
+      ctp::Job::JobResult result = _master->EvalJob(_top, job, this);
+      _master->ReleaseThreads(_threads);
+      _threads = 0;
+      _master->_store.ReportJob(*job, result, _master->_host);
+      delete job;
+    }
+    return;
+  }
+
+ private:
+  ctp::Topology* _top;
+  JobStoreCalc* _master;
+  int _threads;
+};
+
+void JobStoreCalc::UseJobStore(int cache, int maxjobs,
+                               const std::string& restart) {
+  _use_store = true;
+  _cache = std::max(cache, 1);
+  _maxjobs = maxjobs;
+  _restart = restart;
+  return;
+}
+
+void JobStoreCalc::ImportJobFile(ctp::Topology* top) {
+  JobStore store;
+  store.Open(JobStoreFile());
+  int njobs = store.ImportJobs(
+      _jobfile, [this, top](ctp::Job* job) { return JobCost(top, job); });
+  store.Close();
+  std::cout << std::endl
+            << "... ... Imported " << njobs << " jobs into "
+            << JobStoreFile() << std::flush;
+  return;
+}
+
+void JobStoreCalc::ExportJobFile() {
+  if (!boost::filesystem::exists(JobStoreFile())) return;
+  JobStore store;
+  store.Open(JobStoreFile());
+  store.ExportJobs(_jobfile);
+  store.Close();
+  return;
+}
+
+std::string JobStoreCalc::GenerateHost() {
+  char host[128];
+  ::gethostname(host, sizeof(host));
+  host[sizeof(host) - 1] = '\0';
+  return std::string(host) + ":" + std::to_string(::getpid());
+}
+
+// jobs are claimed from the store in blocks of _cache for the whole process
+// and handed to the threads one by one, so the threads also run the block
+// largest first
+ctp::Job* JobStoreCalc::NextJob(double& cost) {
+  tools::MutexLocker lock(_claim_mutex);
+  if (_queue.empty()) {
+    int njobs = _cache;
+    if (_maxjobs >= 0) njobs = std::min(njobs, _maxjobs - _jobs_claimed);
+    if (njobs <= 0) return NULL;
+    std::vector<double> costs;
+    std::vector<ctp::Job*> jobs = _store.ClaimJobs(njobs, _host, &costs);
+    _jobs_claimed += jobs.size();
+    for (unsigned i = 0; i < jobs.size(); i++) {
+      _queue.push_back(std::make_pair(jobs[i], costs[i]));
+    }
+  }
+  if (_queue.empty()) return NULL;
+  ctp::Job* job = _queue.front().first;
+  cost = _queue.front().second;
+  _queue.pop_front();
+  return job;
+}
+
+// a job of mean cost gets its fair share of cores, larger jobs more,
+// limited by the cores not used by the other threads
+int JobStoreCalc::AllocateThreads(double cost) {
+  tools::MutexLocker lock(_core_mutex);
+  double share = double(_core_budget) / double(_nThreads);
+  int threads = int(std::round(share * cost / _mean_cost));
+  threads = std::max(1, std::min(threads, _free_cores));
+  _free_cores -= threads;
+  return threads;
+}
+
+void JobStoreCalc::ReleaseThreads(int threads) {
+  tools::MutexLocker lock(_core_mutex);
+  _free_cores += threads;
+  return;
+}
+
+int JobStoreCalc::JobThreads(ctp::QMThread* thread) const {
+  JobStoreOperator* op = dynamic_cast<JobStoreOperator*>(thread);
+  return (op == NULL) ? 0 : op->getJobThreads();
+}
+
+int JobStoreCalc::CountBasisFunctions(
+    const std::vector<ctp::Segment*>& segments, const std::string& basisname) {
+  if (_funcs_per_element.empty() && basisname != "") {
+    try {
+      BasisSet basis;
+      basis.LoadBasisSet(basisname);
+      for (const auto& element : basis) {
+        int nfuncs = 0;
+        for (const Shell& shell : *element.second) {
+          nfuncs += shell.getnumofFunc();
+        }
+        _funcs_per_element[element.first] = nfuncs;
+      }
+    } catch (std::exception& e) {
+      _funcs_per_element.clear();
+    }
+  }
+  int nfuncs = 0;
+  for (ctp::Segment* segment : segments) {
+    for (ctp::Atom* atom : segment->Atoms()) {
+      if (!atom->HasQMPart()) continue;
+      std::map<std::string, int>::const_iterator it =
+          _funcs_per_element.find(atom->getElement());
+      nfuncs += (it != _funcs_per_element.end()) ? it->second : 1;
+    }
+  }
+  return nfuncs;
+}
+
+bool JobStoreCalc::EvaluateFrame(ctp::Topology* top) {
+  if (!_use_store) {
+    return ctp::ParallelXJobCalc<std::vector<ctp::Job*>, ctp::Job*,
+                                 ctp::Job::JobResult>::EvaluateFrame(top);
+  }
+
+  if (!boost::filesystem::exists(JobStoreFile())) ImportJobFile(top);
+  _host = GenerateHost();
+  _jobs_claimed = 0;
+  _store.Open(JobStoreFile());
+  if (_restart != "") _store.ResetJobs(_restart);
+  std::cout << std::endl
+            << "... ... " << _store.CountJobs("AVAILABLE")
+            << " jobs available in " << JobStoreFile() << std::flush;
+
+  _mean_cost = _store.MeanCost("AVAILABLE");
+  _core_budget = 1;
+#ifdef _OPENMP
+  _core_budget = omp_get_max_threads();
+#endif
+  _core_budget = std::max(_core_budget, _nThreads);
+  _free_cores = _core_budget;
+
+  std::vector<JobStoreOperator*> operators;
+  for (int id = 0; id < _nThreads; id++) {
+    operators.push_back(new JobStoreOperator(id, top, this));
+    CustomizeLogger(operators.back());
+  }
+  for (JobStoreOperator* op : operators) {
+    op->Start();
+  }
+  for (JobStoreOperator* op : operators) {
+    op->WaitDone();
+  }
+  if (!_maverick) {
+    for (JobStoreOperator* op : operators) {
+      std::cout << std::endl << *(op->getLogger()) << std::flush;
+    }
+  }
+  for (JobStoreOperator* op : operators) {
+    delete op;
+  }
+
+  std::cout << std::endl
+            << "... ... " << _store.CountJobs("COMPLETE") << " complete, "
+            << _store.CountJobs("FAILED") << " failed" << std::flush;
+  _store.Close();
+  return true;
+}
+
+}  // namespace xtp
+}  // namespace votca
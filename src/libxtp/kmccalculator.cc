@@ -111,11 +111,17 @@ void KMCCalculator::LoadGraph(ctp::Topology* top) {
   cout << "spatial density: " << _numberofcharges / top->BoxVolume() << " nm^-3"
        << endl;
 
+  return;
+}
+
+void KMCCalculator::BuildGraph() {
+  _graph = KMCGraph(_nodes);
   for (auto* node : _nodes) {
-    node->InitEscapeRate();
-    node->MakeHuffTree();
+    delete node;
   }
-
+  _nodes.clear();
+  cout << "Flattened graph: " << _graph.NumberofNodes() << " nodes, "
+       << _graph.NumberofEvents() << " events" << endl;
   return;
 }
 
@@ -145,13 +151,13 @@ bool KMCCalculator::CheckForbidden(int id,
   return forbidden;
 }
 
-bool KMCCalculator::CheckSurrounded(GNode* node,
+bool KMCCalculator::CheckSurrounded(int node,
                                     const std::vector<int>& forbiddendests) {
   bool surrounded = true;
-  for (unsigned i = 0; i < node->events.size(); i++) {
+  for (int i = _graph.EventsBegin(node); i < _graph.EventsEnd(node); i++) {
     bool thisevent_possible = true;
     for (unsigned int j = 0; j < forbiddendests.size(); j++) {
-      if (node->events[i].destination == forbiddendests[j]) {
+      if (_graph.Destination(i) == forbiddendests[j]) {
         thisevent_possible = false;
         break;
       }
@@ -218,14 +224,14 @@ int KMCCalculator::StringtoCarriertype(std::string name) {
 
 void KMCCalculator::RandomlyCreateCharges() {
 
-  cout << "looking for injectable nodes..." << endl;
+  *_log << "looking for injectable nodes..." << endl;
   for (unsigned int i = 0; i < _numberofcharges; i++) {
-    Chargecarrier* newCharge = new Chargecarrier;
+    Chargecarrier* newCharge = new Chargecarrier(&_graph);
     newCharge->id = i;
     RandomlyAssignCarriertoSite(newCharge);
 
-    cout << "starting position for charge " << i + 1 << ": segment "
-         << newCharge->getCurrentNodeId() + 1 << endl;
+    *_log << "starting position for charge " << i + 1 << ": segment "
+          << newCharge->getCurrentNodeId() + 1 << endl;
     _carriers.push_back(newCharge);
   }
   return;
@@ -234,100 +240,142 @@ void KMCCalculator::RandomlyCreateCharges() {
 void KMCCalculator::RandomlyAssignCarriertoSite(Chargecarrier* Charge) {
   int nodeId_guess = -1;
   do {
-    nodeId_guess = _RandomVariable.rand_uniform_int(_nodes.size());
-  } while (_nodes[nodeId_guess]->occupied ||
-           _nodes[nodeId_guess]->injectable ==
+    nodeId_guess = _RandomVariable.rand_uniform_int(_graph.NumberofNodes());
+  } while (_graph.isOccupied(nodeId_guess) ||
+           _graph.isInjectable(nodeId_guess) ==
                false);  // maybe already occupied? or maybe not injectable?
   if (Charge->hasNode()) {
-    Charge->jumpfromCurrentNodetoNode(_nodes[nodeId_guess]);
+    Charge->jumpfromCurrentNodetoNode(nodeId_guess);
   } else {
-    Charge->settoNote(_nodes[nodeId_guess]);
+    Charge->settoNote(nodeId_guess);
   }
   return;
 }
 
-void KMCCalculator::InitialRates() {
+void KMCCalculator::BuildRateTable() {
+  std::vector<int> node;
+  std::vector<int> event;
+  for (int i = 0; i < _graph.NumberofNodes(); i++) {
+    for (int j = _graph.EventsBegin(i); j < _graph.EventsEnd(i); j++) {
+      // decay events keep the rate they were read in with
+      if (!_graph.isDecay(j)) {
+        node.push_back(i);
+        event.push_back(j);
+      }
+    }
+  }
 
-  cout << endl << "Calculating initial Marcus rates." << endl;
-  cout << "    Temperature T = " << _temperature << " K." << endl;
+  const unsigned size = node.size();
+  _ratetable.node = node;
+  _ratetable.event = event;
+  _ratetable.reorg.resize(size);
+  _ratetable.dG_Site.resize(size);
+  _ratetable.J2.resize(size);
+  _ratetable.drx.resize(size);
+  _ratetable.dry.resize(size);
+  _ratetable.drz.resize(size);
+  for (unsigned k = 0; k < size; k++) {
+    const int origin = node[k];
+    const int dest = _graph.Destination(event[k]);
+    double reorg = _graph.ReorgIntOrig(origin) + _graph.ReorgIntDest(dest) +
+                   _graph.ReorgOut(event[k]);
+    if (std::abs(reorg) < 1e-12) {
+      throw std::runtime_error(
+          "Reorganisation energy for a pair is extremly close to zero,\n"
+          " you probably forgot to import reorganisation energies into your "
+          "sql file.");
+    }
+    _ratetable.reorg(k) = reorg;
+    _ratetable.dG_Site(k) = _graph.SiteEnergy(dest) - _graph.SiteEnergy(origin);
+    _ratetable.J2(k) = _graph.Jeff2(event[k]);
+    const tools::vec& dr = _graph.dr(event[k]);
+    _ratetable.drx(k) = dr.getX();
+    _ratetable.dry(k) = dr.getY();
+    _ratetable.drz(k) = dr.getZ();
+  }
+  return;
+}
 
-  cout << "    carriertype: " << CarrierInttoLongString(_carriertype) << endl;
-  unsigned numberofsites = _nodes.size();
-  cout << "    Rates for " << numberofsites << " sites are computed." << endl;
+Eigen::ArrayXd KMCCalculator::CalculateRates(double temperature,
+                                             const tools::vec& field) const {
   double charge = 0.0;
   if (_carriertype == -1) {
     charge = -1.0;
   } else if (_carriertype == 1) {
     charge = 1.0;
   }
-  cout << "electric field =" << _field << " V/nm" << endl;
+  const double kT = tools::conv::kB * temperature;
+  const Eigen::ArrayXd& reorg = _ratetable.reorg;
+  Eigen::ArrayXd dG = _ratetable.dG_Site;
+  if (charge != 0.0) {
+    dG -= charge * (_ratetable.drx * field.getX() +
+                    _ratetable.dry * field.getY() +
+                    _ratetable.drz * field.getZ());
+  }
+  Eigen::ArrayXd rates = 2 * tools::conv::Pi / tools::conv::hbar *
+                         _ratetable.J2 /
+                         (4 * tools::conv::Pi * reorg * kT).sqrt() *
+                         (-(dG + reorg).square() / (4 * reorg * kT)).exp();
+  return rates;
+}
 
-  double maxreldiff = 0;
-  double maxrate = 0;
-  double minrate = std::numeric_limits<double>::max();
-  int totalnumberofrates = 0;
-  for (unsigned int i = 0; i < numberofsites; i++) {
-    unsigned numberofneighbours = _nodes[i]->events.size();
-    for (unsigned int j = 0; j < numberofneighbours; j++) {
-      if (_nodes[i]->events[j].decayevent) {
-        // if event is a decay event there is no point in calculating its rate,
-        // because it already has that from the reading in.
-        continue;
-      }
+int KMCCalculator::UpdateRates(const Eigen::ArrayXd& rates) {
+  std::vector<bool> changed(_graph.NumberofNodes(), false);
+  for (unsigned k = 0; k < _ratetable.node.size(); k++) {
+    if (_graph.Rate(_ratetable.event[k]) != rates(k)) {
+      _graph.setRate(_ratetable.event[k], rates(k));
+      changed[_ratetable.node[k]] = true;
+    }
+  }
+  // only nodes with modified rates need a new escape rate and table
+  int rebuilt = 0;
+  for (int i = 0; i < _graph.NumberofNodes(); i++) {
+    if (changed[i]) {
+      _graph.UpdateNode(i);
+      rebuilt++;
+    }
+  }
+  return rebuilt;
+}
 
-      double destindex = _nodes[i]->events[j].destination;
-      double reorg = _nodes[i]->reorg_intorig +
-                     _nodes[destindex]->reorg_intdest +
-                     _nodes[i]->events[j].reorg_out;
-      if (std::abs(reorg) < 1e-12) {
-        throw std::runtime_error(
-            "Reorganisation energy for a pair is extremly close to zero,\n"
-            " you probably forgot to import reorganisation energies into your "
-            "sql file.");
-      }
-      double dG_Field = 0.0;
-      if (charge != 0.0) {
-        dG_Field = charge * (_nodes[i]->events[j].dr * _field);
-      }
-      double dG_Site = _nodes[destindex]->siteenergy - _nodes[i]->siteenergy;
-      double dG = dG_Site - dG_Field;
-      double J2 = _nodes[i]->events[j].Jeff2;
-
-      double rate =
-          2 * tools::conv::Pi / tools::conv::hbar * J2 /
-          sqrt(4 * tools::conv::Pi * reorg * tools::conv::kB * _temperature) *
-          exp(-(dG + reorg) * (dG + reorg) /
-              (4 * reorg * tools::conv::kB * _temperature));
-
-      // calculate relative difference compared to values in the table
-      double reldiff =
-          (_nodes[i]->events[j].rate - rate) / _nodes[i]->events[j].rate;
-      if (reldiff > maxreldiff) {
-        maxreldiff = reldiff;
-      }
-      reldiff = (_nodes[i]->events[j].rate - rate) / rate;
-      if (reldiff > maxreldiff) {
-        maxreldiff = reldiff;
-      }
+void KMCCalculator::InitialRates() {
 
-      // set rates to calculated values
-      _nodes[i]->events[j].rate = rate;
-      _nodes[i]->events[j].initialrate = rate;
+  cout << endl << "Calculating initial Marcus rates." << endl;
+  cout << "    Temperature T = " << _temperature << " K." << endl;
 
-      if (rate > maxrate) {
-        maxrate = rate;
-      } else if (rate < minrate) {
-        minrate = rate;
-      }
+  cout << "    carriertype: " << CarrierInttoLongString(_carriertype) << endl;
+  unsigned numberofsites = _graph.NumberofNodes();
+  cout << "    Rates for " << numberofsites << " sites are computed." << endl;
+  cout << "electric field =" << _field << " V/nm" << endl;
+
+  BuildRateTable();
+  Eigen::ArrayXd rates = CalculateRates(_temperature, _field);
 
-      totalnumberofrates++;
+  double maxreldiff = 0;
+  double maxrate = 0;
+  double minrate = std::numeric_limits<double>::max();
+  int totalnumberofrates = rates.size();
+  for (int k = 0; k < totalnumberofrates; k++) {
+    double oldrate = _graph.Rate(_ratetable.event[k]);
+    double rate = rates(k);
+    // calculate relative difference compared to values in the table
+    double reldiff = (oldrate - rate) / oldrate;
+    if (reldiff > maxreldiff) {
+      maxreldiff = reldiff;
+    }
+    reldiff = (oldrate - rate) / rate;
+    if (reldiff > maxreldiff) {
+      maxreldiff = reldiff;
+    }
+    if (rate > maxrate) {
+      maxrate = rate;
+    } else if (rate < minrate) {
+      minrate = rate;
     }
   }
-  // Initialise escape rates
-  for (auto* node : _nodes) {
-    node->InitEscapeRate();
-    node->MakeHuffTree();
-  }
+
+  // set rates to calculated values and initialise escape rates
+  UpdateRates(rates);
 
   cout << "    " << totalnumberofrates << " rates have been calculated."
        << endl;
@@ -353,16 +401,16 @@ double KMCCalculator::Promotetime(double cumulated_rate) {
   double dt = 0;
   double rand_u = 1 - _RandomVariable.rand_uniform();
   while (rand_u == 0) {
-    cout << "WARNING: encountered 0 as a random variable! New try." << endl;
+    *_log << "WARNING: encountered 0 as a random variable! New try." << endl;
     rand_u = 1 - _RandomVariable.rand_uniform();
   }
   dt = -1 / cumulated_rate * log(rand_u);
   return dt;
 }
 
-GLink* KMCCalculator::ChooseHoppingDest(GNode* node) {
+int KMCCalculator::ChooseHoppingDest(int node) {
   double u = 1 - _RandomVariable.rand_uniform();
-  return node->findHoppingDestination(u);
+  return _graph.FindHoppingDestination(node, u);
 }
 
 Chargecarrier* KMCCalculator::ChooseAffectedCarrier(double cumulated_rate) {
@@ -383,9 +431,9 @@ Chargecarrier* KMCCalculator::ChooseAffectedCarrier(double cumulated_rate) {
   return carrier;
 }
 
-void KMCCalculator::AddtoJumplengthdistro(const GLink* event, double dt) {
+void KMCCalculator::AddtoJumplengthdistro(int event, double dt) {
   if (dolengthdistributon) {
-    double dist = abs(event->dr) - minlength;
+    double dist = abs(_graph.dr(event)) - minlength;
     int index = int(dist / lengthresolution);
 
     _jumplengthdistro[index]++;
@@ -404,28 +452,28 @@ void KMCCalculator::PrintJumplengthdistro() {
       weightedintegral += _jumplengthdistro_weighted[i];
     }
     double noofjumps_double = double(noofjumps);
-    cout << "Total number of jumps: " << noofjumps << endl;
-    cout << " distance[nm] |   # of jumps   | # of jumps [%] | .w. by dist "
-            "[nm] | w. by timestep [%]"
-         << endl;
-    cout << "------------------------------------------------------------------"
-            "------------------"
-         << endl;
+    *_log << "Total number of jumps: " << noofjumps << endl;
+    *_log << " distance[nm] |   # of jumps   | # of jumps [%] | .w. by dist "
+             "[nm] | w. by timestep [%]"
+          << endl;
+    *_log << "-----------------------------------------------------------------"
+             "-------------------"
+          << endl;
     for (unsigned i = 0; i < _jumplengthdistro.size(); ++i) {
       double dist = lengthresolution * (i + 0.5) + minlength;
       double percent = _jumplengthdistro[i] / noofjumps_double;
       double rtimespercent = percent * dist;
-      cout << (boost::format("    %4.3f    | %15d |    %04.2f    |     %4.3e   "
-                             "  |     %04.2f") %
-               (dist) % (_jumplengthdistro[i]) % (percent * 100) %
-               (rtimespercent) %
-               (_jumplengthdistro_weighted[i] / weightedintegral * 100))
-                  .str()
-           << endl;
+      *_log << (boost::format("    %4.3f    | %15d |    %04.2f    |     "
+                              "%4.3e     |     %04.2f") %
+                (dist) % (_jumplengthdistro[i]) % (percent * 100) %
+                (rtimespercent) %
+                (_jumplengthdistro_weighted[i] / weightedintegral * 100))
+                   .str()
+            << endl;
     }
-    cout << "------------------------------------------------------------------"
-            "------------------"
-         << endl;
+    *_log << "-----------------------------------------------------------------"
+             "-------------------"
+          << endl;
   }
   return;
 }
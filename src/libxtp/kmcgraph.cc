@@ -0,0 +1,118 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <votca/xtp/kmcgraph.h>
+
+namespace votca {
+namespace xtp {
+
+KMCGraph::KMCGraph(const std::vector<GNode*>& nodes) {
+  const unsigned nnodes = nodes.size();
+  unsigned nevents = 0;
+  for (const GNode* node : nodes) {
+    nevents += node->events.size();
+  }
+
+  _offsets.reserve(nnodes + 1);
+  _destination.reserve(nevents);
+  _dr.reserve(nevents);
+  _rate.reserve(nevents);
+  _Jeff2.reserve(nevents);
+  _reorg_out.reserve(nevents);
+
+  _offsets.push_back(0);
+  for (unsigned i = 0; i < nnodes; i++) {
+    const GNode* node = nodes[i];
+    if (node->id != int(i)) {
+      throw std::runtime_error(
+          "KMCGraph: node ids have to be consecutive and start at 0");
+    }
+    for (const GLink& event : node->events) {
+      _destination.push_back(event.decayevent ? -1 : event.destination);
+      _dr.push_back(event.dr);
+      _rate.push_back(event.rate);
+      _Jeff2.push_back(event.Jeff2);
+      _reorg_out.push_back(event.reorg_out);
+    }
+    _offsets.push_back(_destination.size());
+
+    _position.push_back(node->position);
+    _siteenergy.push_back(node->siteenergy);
+    _reorg_intorig.push_back(node->reorg_intorig);
+    _reorg_intdest.push_back(node->reorg_intdest);
+    _injectable.push_back(node->injectable);
+    _hasdecay.push_back(node->hasdecay);
+  }
+
+  _cumulative.resize(nevents);
+  _escape_rate.resize(nnodes);
+  _occupied.resize(nnodes);
+  _occupationtime.resize(nnodes);
+  ResetOccupation();
+  for (unsigned i = 0; i < nnodes; i++) {
+    UpdateNode(i);
+  }
+}
+
+void KMCGraph::ResetOccupation() {
+  std::fill(_occupied.begin(), _occupied.end(), 0);
+  std::fill(_occupationtime.begin(), _occupationtime.end(), 0.0);
+  return;
+}
+
+void KMCGraph::UpdateNode(int node) {
+  const int begin = EventsBegin(node);
+  const int end = EventsEnd(node);
+  double escape_rate = 0.0;
+  for (int k = begin; k < end; k++) {
+    escape_rate += _rate[k];
+    _cumulative[k] = escape_rate;
+  }
+  _escape_rate[node] = escape_rate;
+  // a node without outgoing rates is never chosen to escape, the table only
+  // has to stay valid
+  const double norm = (escape_rate > 0.0) ? 1.0 / escape_rate : 0.0;
+  for (int k = begin; k < end; k++) {
+    _cumulative[k] *= norm;
+  }
+  if (end > begin) {
+    _cumulative[end - 1] = 1.0;
+  }
+  return;
+}
+
+int KMCGraph::FindHoppingDestination(int node, double p) const {
+  const int begin = EventsBegin(node);
+  const int end = EventsEnd(node);
+  if (begin == end) {
+    throw std::runtime_error("KMCGraph: node " + std::to_string(node) +
+                             " has no events to hop along");
+  }
+  const double* first = _cumulative.data() + begin;
+  const double* last = _cumulative.data() + end;
+  const double* chosen = std::lower_bound(first, last, p);
+  if (chosen == last) {
+    chosen--;
+  }
+  return begin + int(chosen - first);
+}
+
+}  // namespace xtp
+}  // namespace votca
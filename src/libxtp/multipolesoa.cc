@@ -0,0 +1,140 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+#include <votca/ctp/apolarsite.h>
+#include <votca/xtp/multipolesoa.h>
+
+namespace votca {
+namespace xtp {
+
+MultipoleSoA::MultipoleSoA(const std::vector<ctp::APolarSite*>& sites) {
+  const std::vector<double> noquadrupole(5, 0.0);
+  for (ctp::APolarSite* site : sites) {
+    const int rank = site->getRank();
+    const tools::vec dipole =
+        (rank > 0) ? site->getQ1() : tools::vec(0.0, 0.0, 0.0);
+    Add(site->getPos(), site->getQ00(), dipole,
+        (rank > 1) ? site->getQ2() : noquadrupole);
+  }
+}
+
+void MultipoleSoA::Add(const tools::vec& pos, double Q00, const tools::vec& Q1,
+                       const std::vector<double>& Q2) {
+  const double sqrt3 = std::sqrt(3.0);
+  _x.push_back(pos.getX());
+  _y.push_back(pos.getY());
+  _z.push_back(pos.getZ());
+  _q.push_back(Q00);
+  _dx.push_back(Q1.getX());
+  _dy.push_back(Q1.getY());
+  _dz.push_back(Q1.getZ());
+  _qxx.push_back(0.5 * (sqrt3 * Q2[3] - Q2[0]));
+  _qxy.push_back(0.5 * sqrt3 * Q2[4]);
+  _qxz.push_back(0.5 * sqrt3 * Q2[1]);
+  _qyy.push_back(-0.5 * (sqrt3 * Q2[3] + Q2[0]));
+  _qyz.push_back(0.5 * sqrt3 * Q2[2]);
+  _qzz.push_back(Q2[0]);
+  return;
+}
+
+// E = T qa qb + T_i (qa db_i - da_i qb)
+//     + T_ij (qa Qb_ij/3 + Qa_ij qb/3 - da_i db_j)
+//     - T_ijk da_i Qb_jk/3 + T_ijk Qa_ij db_k/3 + T_ijkl Qa_ij Qb_kl/9
+// with the interaction tensors T_ij..=d_i d_j.. 1/R of R=rb-ra, written as
+// contractions with R, so no tensor is set up explicitly
+double MultipoleSoA::InteractionEnergy(const MultipoleSoA& other,
+                                       const tools::vec& shift) const {
+  const int nb = other.size();
+  const double* bx = other._x.data();
+  const double* by = other._y.data();
+  const double* bz = other._z.data();
+  const double* bq = other._q.data();
+  const double* bdx = other._dx.data();
+  const double* bdy = other._dy.data();
+  const double* bdz = other._dz.data();
+  const double* bqxx = other._qxx.data();
+  const double* bqxy = other._qxy.data();
+  const double* bqxz = other._qxz.data();
+  const double* bqyy = other._qyy.data();
+  const double* bqyz = other._qyz.data();
+  const double* bqzz = other._qzz.data();
+
+  double energy = 0.0;
+  for (int i = 0; i < size(); i++) {
+    const double ax = _x[i] - shift.getX();
+    const double ay = _y[i] - shift.getY();
+    const double az = _z[i] - shift.getZ();
+    const double aq = _q[i];
+    const double adx = _dx[i];
+    const double ady = _dy[i];
+    const double adz = _dz[i];
+    const double aqxx = _qxx[i];
+    const double aqxy = _qxy[i];
+    const double aqxz = _qxz[i];
+    const double aqyy = _qyy[i];
+    const double aqyz = _qyz[i];
+    const double aqzz = _qzz[i];
+#pragma omp simd reduction(+ : energy)
+    for (int j = 0; j < nb; j++) {
+      const double rx = bx[j] - ax;
+      const double ry = by[j] - ay;
+      const double rz = bz[j] - az;
+      const double r2 = rx * rx + ry * ry + rz * rz;
+      const double r1inv = 1.0 / std::sqrt(r2);
+      const double r2inv = r1inv * r1inv;
+      const double r3inv = r1inv * r2inv;
+      const double r5inv = r3inv * r2inv;
+      const double r7inv = r5inv * r2inv;
+      const double r9inv = r7inv * r2inv;
+
+      // Q.R for both quadrupoles
+      const double QaRx = aqxx * rx + aqxy * ry + aqxz * rz;
+      const double QaRy = aqxy * rx + aqyy * ry + aqyz * rz;
+      const double QaRz = aqxz * rx + aqyz * ry + aqzz * rz;
+      const double QbRx = bqxx[j] * rx + bqxy[j] * ry + bqxz[j] * rz;
+      const double QbRy = bqxy[j] * rx + bqyy[j] * ry + bqyz[j] * rz;
+      const double QbRz = bqxz[j] * rx + bqyz[j] * ry + bqzz[j] * rz;
+
+      const double daR = adx * rx + ady * ry + adz * rz;
+      const double dbR = bdx[j] * rx + bdy[j] * ry + bdz[j] * rz;
+      const double dadb = adx * bdx[j] + ady * bdy[j] + adz * bdz[j];
+      const double RQaR = rx * QaRx + ry * QaRy + rz * QaRz;
+      const double RQbR = rx * QbRx + ry * QbRy + rz * QbRz;
+      const double daQbR = adx * QbRx + ady * QbRy + adz * QbRz;
+      const double dbQaR = bdx[j] * QaRx + bdy[j] * QaRy + bdz[j] * QaRz;
+      const double RQaQbR = QaRx * QbRx + QaRy * QbRy + QaRz * QbRz;
+      const double QaQb = aqxx * bqxx[j] + aqyy * bqyy[j] + aqzz * bqzz[j] +
+                          2.0 * (aqxy * bqxy[j] + aqxz * bqxz[j] +
+                                 aqyz * bqyz[j]);
+
+      double e = aq * bq[j] * r1inv;
+      e -= (aq * dbR - bq[j] * daR) * r3inv;
+      e += (aq * RQbR + bq[j] * RQaR - 3.0 * daR * dbR + r2 * dadb) * r5inv;
+      e += (5.0 * (daR * RQbR - dbR * RQaR) * r7inv -
+            2.0 * (daQbR - dbQaR) * r5inv);
+      e += (35.0 * RQaR * RQbR * r9inv - 20.0 * RQaQbR * r7inv +
+            2.0 * QaQb * r5inv) /
+           3.0;
+      energy += e;
+    }
+  }
+  return energy;
+}
+
+}  // namespace xtp
+}  // namespace votca
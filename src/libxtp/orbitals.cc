@@ -28,6 +28,7 @@
 #include <votca/tools/elements.h>
 #include <votca/xtp/aobasis.h>
 #include <votca/xtp/basisset.h>
+#include <votca/xtp/dimerprojection.h>
 #include <votca/xtp/vc2index.h>
 #include <votca/xtp/version.h>
 
@@ -645,15 +646,12 @@ void Orbitals::PrepareDimerGuess(const Orbitals& orbitalsA,
   int basisA = orbitalsA.getBasisSetSize();
   int basisB = orbitalsB.getBasisSetSize();
 
-  int levelsA = orbitalsA.getBasisSetSize();
-  int levelsB = orbitalsB.getBasisSetSize();
+  int levelsA = orbitalsA.MOCoefficients().cols();
+  int levelsB = orbitalsB.MOCoefficients().cols();
 
   int electronsA = orbitalsA.getNumberOfAlphaElectrons();
   int electronsB = orbitalsB.getNumberOfAlphaElectrons();
 
-  this->MOCoefficients() =
-      Eigen::MatrixXd::Zero(basisA + basisB, levelsA + levelsB);
-
   // AxB = | A 0 |  //   A = [EA, EB]  //
   //       | 0 B |  //                 //
   if (orbitalsA.getDFTbasisName() != orbitalsB.getDFTbasisName()) {
@@ -672,10 +670,8 @@ void Orbitals::PrepareDimerGuess(const Orbitals& orbitalsA,
   this->setNumberOfOccupiedLevels(electronsA + electronsB);
   this->setNumberOfAlphaElectrons(electronsA + electronsB);
 
-  this->MOCoefficients().block(0, 0, basisA, levelsA) =
-      orbitalsA.MOCoefficients();
-  this->MOCoefficients().block(basisA, levelsA, basisB, levelsB) =
-      orbitalsB.MOCoefficients();
+  this->MOCoefficients() = DimerProjection::MergeMOs(
+      orbitalsA.MOCoefficients(), orbitalsB.MOCoefficients());
 
   Eigen::VectorXd& energies = this->MOEnergies();
   energies.resize(levelsA + levelsB);
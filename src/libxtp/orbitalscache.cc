@@ -0,0 +1,80 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <votca/xtp/orbitalscache.h>
+
+namespace votca {
+namespace xtp {
+
+void OrbitalsCache::setCapacity(int capacity) {
+  tools::MutexLocker lock(_mutex);
+  _capacity = capacity;
+  Evict();
+  return;
+}
+
+int OrbitalsCache::size() {
+  tools::MutexLocker lock(_mutex);
+  return int(_lru.size());
+}
+
+void OrbitalsCache::Evict() {
+  while (int(_lru.size()) > std::max(_capacity, 0)) {
+    _index.erase(_lru.back().first);
+    _lru.pop_back();
+  }
+  return;
+}
+
+std::shared_ptr<const Orbitals> OrbitalsCache::Get(
+    const std::string& filename) {
+  {
+    tools::MutexLocker lock(_mutex);
+    std::map<std::string, LRUList::iterator>::iterator it =
+        _index.find(filename);
+    if (it != _index.end()) {
+      _lru.splice(_lru.begin(), _lru, it->second);
+      _hits++;
+      return _lru.front().second;
+    }
+  }
+
+  std::shared_ptr<Orbitals> orbitals = std::make_shared<Orbitals>();
+  orbitals->ReadFromCpt(filename);
+
+  tools::MutexLocker lock(_mutex);
+  _misses++;
+  // another thread may have read the same file in the meantime
+  std::map<std::string, LRUList::iterator>::iterator it =
+      _index.find(filename);
+  if (it != _index.end()) {
+    _lru.splice(_lru.begin(), _lru, it->second);
+    return _lru.front().second;
+  }
+  if (_capacity > 0) {
+    _lru.push_front(std::make_pair(filename, orbitals));
+    _index[filename] = _lru.begin();
+    Evict();
+  }
+  return orbitals;
+}
+
+}  // namespace xtp
+}  // namespace votca
@@ -0,0 +1,101 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <votca/xtp/outofcorearray.h>
+
+namespace votca {
+namespace xtp {
+
+namespace bfs = boost::filesystem;
+namespace bip = boost::interprocess;
+
+OutOfCoreArray::OutOfCoreArray() {}
+
+OutOfCoreArray::~OutOfCoreArray() {}
+
+void OutOfCoreArray::Allocate(std::size_t size, std::size_t max_memory,
+                              const std::string& directory) {
+  _region.reset();
+  std::vector<real_gwbse>().swap(_memory);
+  _size = size;
+  const std::size_t bytes = size * sizeof(real_gwbse);
+  if (max_memory == 0 || bytes <= max_memory) {
+    _memory.assign(size, 0);
+    _data = _memory.data();
+    return;
+  }
+
+  const bfs::path file =
+      bfs::path(directory) / bfs::unique_path("xtp-%%%%-%%%%-%%%%.scratch");
+  {
+    std::ofstream create(file.string(), std::ios::binary);
+    if (!create) {
+      throw std::runtime_error("Could not create scratch file " +
+                               file.string());
+    }
+  }
+  // the file is sparse, so it reads as zero and only written pages use disk
+  bfs::resize_file(file, bytes);
+  {
+    bip::file_mapping mapping(file.string().c_str(), bip::read_write);
+    _region.reset(new bip::mapped_region(mapping, bip::read_write));
+  }
+  bip::file_mapping::remove(file.string().c_str());
+  _data = static_cast<real_gwbse*>(_region->get_address());
+  return;
+}
+
+void OutOfCoreArray::Prefetch(std::size_t start, std::size_t size) const {
+  Advise(start, size, MADV_WILLNEED);
+  return;
+}
+
+// the mapping is shared, so modified pages are written back to the file and
+// read again on the next access
+void OutOfCoreArray::Release(std::size_t start, std::size_t size) const {
+  Advise(start, size, MADV_DONTNEED);
+  return;
+}
+
+void OutOfCoreArray::Advise(std::size_t start, std::size_t size,
+                            int advice) const {
+  if (!_region || size == 0 || start >= _size) {
+    return;
+  }
+  size = std::min(size, _size - start);
+  const std::uintptr_t page = bip::mapped_region::get_page_size();
+  const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(_data + start);
+  const std::uintptr_t end =
+      reinterpret_cast<std::uintptr_t>(_data + start + size);
+  const std::uintptr_t aligned = begin - begin % page;
+  // only a hint, failures are harmless
+  madvise(reinterpret_cast<void*>(aligned), end - aligned, advice);
+  return;
+}
+
+}  // namespace xtp
+}  // namespace votca
@@ -200,6 +200,15 @@ void QMDatabase::onCreate() {
       "frame      INT NOT NULL,"
       "top        INT NOT NULL,"
       "type      TEXT NOT NULL)");
+
+  CreateIndices();
+}
+
+void QMDatabase::CreateIndices() {
+  Exec("CREATE INDEX IF NOT EXISTS segments_top ON segments (top, id)");
+  Exec("CREATE INDEX IF NOT EXISTS pairs_top ON pairs (top, id)");
+  Exec("CREATE INDEX IF NOT EXISTS pairs_seg1 ON pairs (top, seg1)");
+  Exec("CREATE INDEX IF NOT EXISTS pairs_seg2 ON pairs (top, seg2)");
 }
 
 }  // namespace xtp
@@ -207,6 +207,7 @@ void QMMachine::RunGWBSE(string &runFolder) {
 
   // Initialize with options
   gwbse.Initialize(_gwbse_options);
+  if (_threads > 0) gwbse.setNumofThreads(_threads);
   // actual GW-BSE run
   gwbse.Evaluate();
 
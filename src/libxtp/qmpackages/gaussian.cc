@@ -89,9 +89,9 @@ void Gaussian::Initialize(tools::Property& options) {
   // check if the guess keyword is present, if yes, append the guess later
   std::string::size_type iop_pos = _options.find("cards");
   if (iop_pos != std::string::npos) {
-    _write_guess = true;
+    _use_guess = true;
   } else {
-    _write_guess = false;
+    _use_guess = false;
   }
 
   // check if the pop keyword is present, if yes, get the charges and save them
@@ -415,7 +415,7 @@ bool Gaussian::WriteInputFile(Orbitals& orbitals) {
     if (_write_charges) WriteBackgroundCharges(com_file);
 
     // write inital guess
-    if (_write_guess) {
+    if (_use_guess) {
       WriteGuess(orbitals, com_file);
     }
 
@@ -431,7 +431,7 @@ bool Gaussian::WriteInputFile(Orbitals& orbitals) {
     if (_write_pseudopotentials) WriteECP(com_file, qmatoms);
 
     // write inital guess
-    if (_write_guess) {
+    if (_use_guess) {
       WriteGuess(orbitals, com_file);
     }
 
@@ -38,6 +38,8 @@ class Gaussian : public QMPackage {
  public:
   std::string getPackageName() { return "gaussian"; }
 
+  QMPackage* Clone() const { return new Gaussian(*this); }
+
   void Initialize(tools::Property& options);
 
   bool WriteInputFile(Orbitals& orbitals);
@@ -112,11 +112,11 @@ void NWChem::Initialize(tools::Property& options) {
   }
 
   // check if the guess should be prepared, if yes, append the guess later
-  _write_guess = false;
+  _use_guess = false;
   iop_pos = _options.find("iterations 1 ");
-  if (iop_pos != std::string::npos) _write_guess = true;
+  if (iop_pos != std::string::npos) _use_guess = true;
   iop_pos = _options.find("iterations 1\n");
-  if (iop_pos != std::string::npos) _write_guess = true;
+  if (iop_pos != std::string::npos) _use_guess = true;
 }
 
 /* For QM/MM the molecules in the MM environment are represented by
@@ -325,7 +325,7 @@ bool NWChem::WriteInputFile(Orbitals& orbitals) {
     }
   }
   nw_file << _options << "\n";
-  if (_write_guess) {
+  if (_use_guess) {
     bool worked = WriteGuess(orbitals);
     if (!worked) {
       return false;
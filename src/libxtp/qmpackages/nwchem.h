@@ -38,6 +38,8 @@ class NWChem : public QMPackage {
  public:
   std::string getPackageName() { return "nwchem"; }
 
+  QMPackage* Clone() const { return new NWChem(*this); }
+
   void Initialize(tools::Property& options);
 
   bool WriteInputFile(Orbitals& orbitals);
@@ -100,11 +100,11 @@ void Orca::Initialize(tools::Property& options) {
   }
 
   // check if the guess should be prepared, if yes, append the guess later
-  _write_guess = false;
+  _use_guess = false;
   iop_pos = _options.find("Guess MORead");
-  if (iop_pos != std::string::npos) _write_guess = true;
+  if (iop_pos != std::string::npos) _use_guess = true;
   iop_pos = _options.find("Guess MORead\n");
-  if (iop_pos != std::string::npos) _write_guess = true;
+  if (iop_pos != std::string::npos) _use_guess = true;
 }
 
 /* Custom basis sets are written on a per-element basis to
@@ -353,7 +353,7 @@ bool Orca::WriteShellScript() {
   shell_file << "#!/bin/bash" << endl;
   shell_file << "mkdir -p " << _scratch_dir << endl;
 
-  if (_write_guess) {
+  if (_use_guess) {
     if (!(boost::filesystem::exists(_run_dir + "/molA.gbw") &&
           boost::filesystem::exists(_run_dir + "/molB.gbw"))) {
       throw runtime_error(
@@ -404,7 +404,7 @@ bool Orca::Run() {
  */
 void Orca::CleanUp() {
 
-  if (_write_guess) {
+  if (_use_guess) {
     remove((_run_dir + "/" + "molA.gbw").c_str());
     remove((_run_dir + "/" + "molB.gbw").c_str());
     remove((_run_dir + "/" + "dimer.gbw").c_str());
@@ -38,6 +38,8 @@ class Orca : public QMPackage {
  public:
   std::string getPackageName() { return "orca"; }
 
+  QMPackage* Clone() const { return new Orca(*this); }
+
   void Initialize(tools::Property& options);
 
   bool WriteInputFile(Orbitals& orbitals);
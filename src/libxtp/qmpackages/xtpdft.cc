@@ -51,7 +51,8 @@ void XTPDFT::Initialize(tools::Property& options) {
   _threads = _xtpdft_options.get(key + ".threads").as<int>();
   _cleanup = _xtpdft_options.get(key + ".cleanup").as<std::string>();
 
-  _write_guess = _xtpdft_options.ifExistsReturnElseReturnDefault<bool>(
+  // the DFTEngine reads the guess from the orbitals passed to WriteInputFile
+  _use_guess = _xtpdft_options.ifExistsReturnElseReturnDefault<bool>(
       key + ".read_guess", false);
 
   // check if ECPs are used in xtpdft
@@ -72,21 +73,40 @@ bool XTPDFT::WriteInputFile(Orbitals& orbitals) {
  * Run calls DFTENGINE
  */
 bool XTPDFT::Run() {
+  RunEngine(_orbitals);
+  std::string file_name = _run_dir + "/" + _log_file_name;
+  CTP_LOG(ctp::logDEBUG, *_pLog)
+      << "Writing result to " << _log_file_name << flush;
+  _orbitals.WriteToCpt(file_name);
+  return true;
+}
+
+/**
+ * Runs DFTENGINE on the orbitals directly, no checkpoint file is written
+ */
+bool XTPDFT::RunInMemory(Orbitals& orbitals) {
+  RunEngine(orbitals);
+  CTP_LOG(ctp::logDEBUG, *_pLog)
+      << (boost::format("QM energy[Hrt]: %4.8f ") % orbitals.getQMEnergy())
+             .str()
+      << flush;
+  return true;
+}
+
+void XTPDFT::RunEngine(Orbitals& orbitals) {
   DFTEngine xtpdft;
   xtpdft.Initialize(_xtpdft_options);
   xtpdft.setLogger(_pLog);
+  xtpdft.setNumofThreads(_threads);
+  xtpdft.setReadGuess(_use_guess);
 
   if (_write_charges) {
     xtpdft.setExternalcharges(_PolarSegments);
   }
-  xtpdft.Prepare(_orbitals);
-  xtpdft.Evaluate(_orbitals);
+  xtpdft.Prepare(orbitals);
+  xtpdft.Evaluate(orbitals);
   _basisset_name = xtpdft.getDFTBasisName();
-  std::string file_name = _run_dir + "/" + _log_file_name;
-  CTP_LOG(ctp::logDEBUG, *_pLog)
-      << "Writing result to " << _log_file_name << flush;
-  _orbitals.WriteToCpt(file_name);
-  return true;
+  return;
 }
 
 void XTPDFT::CleanUp() {
@@ -38,6 +38,8 @@ class XTPDFT : public QMPackage {
  public:
   std::string getPackageName() { return "xtp"; }
 
+  QMPackage* Clone() const { return new XTPDFT(*this); }
+
   void Initialize(tools::Property& options);
 
   bool WriteInputFile(Orbitals& orbitals);
@@ -52,11 +54,16 @@ class XTPDFT : public QMPackage {
 
   bool ParseOrbitalsFile(Orbitals& orbitals);
 
+  bool SupportsInMemory() const { return true; }
+
+  bool RunInMemory(Orbitals& orbitals);
+
   void setMultipoleBackground(
       std::vector<std::shared_ptr<ctp::PolarSeg> > multipoles);
 
  private:
   void WriteChargeOption() { return; }
+  void RunEngine(Orbitals& orbitals);
   tools::Property _xtpdft_options;
   std::string _cleanup;
 
@@ -0,0 +1,69 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <votca/xtp/scratcharena.h>
+
+namespace votca {
+namespace xtp {
+
+namespace {
+// 1MB, enough for all shell pairs up to f with a few contractions
+const std::size_t initial_blocksize = 131072;
+}  // namespace
+
+ScratchArena& ScratchArena::Instance() {
+  static thread_local ScratchArena arena;
+  return arena;
+}
+
+std::size_t ScratchArena::Capacity() const {
+  std::size_t capacity = 0;
+  for (const std::vector<double>& block : _blocks) {
+    capacity += block.size();
+  }
+  return capacity;
+}
+
+double* ScratchArena::Allocate(std::size_t size) {
+  std::size_t block_start = 0;
+  for (std::vector<double>& block : _blocks) {
+    std::size_t block_end = block_start + block.size();
+    if (_top < block_end) {
+      if (_top + size <= block_end) {
+        double* result = block.data() + (_top - block_start);
+        std::fill_n(result, size, 0.0);
+        _top += size;
+        return result;
+      }
+      // does not fit into the rest of this block, skip it
+      _top = block_end;
+    }
+    block_start = block_end;
+  }
+  // the storage of a block never moves, so earlier pointers stay valid
+  std::size_t blocksize =
+      std::max(size, std::max(initial_blocksize, 2 * block_start));
+  _blocks.push_back(std::vector<double>(blocksize, 0.0));
+  _top = block_start + size;
+  return _blocks.back().data();
+}
+
+}  // namespace xtp
+}  // namespace votca
@@ -44,6 +44,8 @@ void SqlApplication::Initialize(void) {
                       "  number of threads to create");
   AddProgramOptions()("save,s", propt::value<int>()->default_value(1),
                       "  whether or not to save changes to state file");
+  AddProgramOptions()("snapshot,b", propt::value<int>()->default_value(0),
+                      "  read frames from a binary topology snapshot");
 }
 
 bool SqlApplication::EvaluateOptions(void) {
@@ -69,6 +71,7 @@ void SqlApplication::Run() {
   // STATESAVER & PROGRESS OBSERVER
   string statefile = OptionsMap()["file"].as<string>();
   StateSaverSQLite statsav;
+  statsav.UseSnapshot(OptionsMap()["snapshot"].as<int>() == 1);
   statsav.Open(_top, statefile);
 
   // INITIALIZE & RUN CALCULATORS
@@ -19,6 +19,7 @@
 
 #include <votca/tools/statement.h>
 #include <votca/xtp/statesaversqlite.h>
+#include <votca/xtp/topologysnapshot.h>
 
 namespace votca {
 namespace xtp {
@@ -69,14 +70,22 @@ void StateSaverSQLite::WriteFrame() {
   cout << "... ";
 
   _db.BeginTransaction();
+  _db.CreateIndices();
 
   this->WriteMeta(hasAlready);
   this->WriteMolecules(hasAlready);
   this->WriteSegTypes(hasAlready);
-  this->WriteSegments(hasAlready);
+  // segments and pairs which are already stored are only updated column-wise
+  if (!hasAlready || !this->UpdateSegments()) {
+    this->WriteSegments(hasAlready);
+    this->SnapshotSegments();
+  }
   this->WriteFragments(hasAlready);
   this->WriteAtoms(hasAlready);
-  this->WritePairs(hasAlready);
+  if (!hasAlready || !this->UpdatePairs()) {
+    this->WritePairs(hasAlready);
+    this->SnapshotPairs();
+  }
   this->WriteSuperExchange(hasAlready);
 
   _db.EndTransaction();
@@ -323,6 +332,204 @@ void StateSaverSQLite::WriteSegments(bool update) {
   stmt = NULL;
 }
 
+const std::vector<StateSaverSQLite::Column> &
+    StateSaverSQLite::SegmentColumns() {
+  // the first column is only used to detect changes of the topology
+  static const std::vector<Column> columns = {
+      {"type", true},      {"posX", false},     {"posY", false},
+      {"posZ", false},     {"UnCnNe", false},   {"UnCnNh", false},
+      {"UcNcCe", false},   {"UcNcCh", false},   {"UcCnNe", false},
+      {"UcCnNh", false},   {"UnXnNs", false},   {"UnXnNt", false},
+      {"UxNxXs", false},   {"UxNxXt", false},   {"UxXnNs", false},
+      {"UxXnNt", false},   {"eAnion", false},   {"eNeutral", false},
+      {"eCation", false},  {"eSinglet", false}, {"eTriplet", false},
+      {"occPe", false},    {"occPh", false},    {"occPs", false},
+      {"occPt", false},    {"has_e", true},     {"has_h", true},
+      {"has_s", true},     {"has_t", true}};
+  return columns;
+}
+
+std::vector<double> StateSaverSQLite::SegmentRow(ctp::Segment *seg) const {
+  std::vector<double> row = {double(seg->getType()->getId()),
+                             seg->getPos().getX(),
+                             seg->getPos().getY(),
+                             seg->getPos().getZ(),
+                             seg->getU_nC_nN(-1),
+                             seg->getU_nC_nN(+1),
+                             seg->getU_cN_cC(-1),
+                             seg->getU_cN_cC(+1),
+                             seg->getU_cC_nN(-1),
+                             seg->getU_cC_nN(+1),
+                             seg->getU_nX_nN(+2),
+                             seg->getU_nX_nN(+3),
+                             seg->getU_xN_xX(+2),
+                             seg->getU_xN_xX(+3),
+                             seg->getU_xX_nN(+2),
+                             seg->getU_xX_nN(+3),
+                             seg->getEMpoles(-1),
+                             seg->getEMpoles(0),
+                             seg->getEMpoles(1),
+                             seg->getEMpoles(2),
+                             seg->getEMpoles(3),
+                             seg->getOcc(-1),
+                             seg->getOcc(+1),
+                             seg->getOcc(+2),
+                             seg->getOcc(+3),
+                             (seg->hasState(-1)) ? 1.0 : 0.0,
+                             (seg->hasState(+1)) ? 1.0 : 0.0,
+                             (seg->hasState(+2)) ? 1.0 : 0.0,
+                             (seg->hasState(+3)) ? 1.0 : 0.0};
+  return row;
+}
+
+const std::vector<StateSaverSQLite::Column> &StateSaverSQLite::PairColumns() {
+  // the first two columns are only used to detect changes of the topology
+  static const std::vector<Column> columns = {
+      {"seg1", true},     {"seg2", true},     {"drX", false},
+      {"drY", false},     {"drZ", false},     {"has_e", true},
+      {"has_h", true},    {"has_s", true},    {"has_t", true},
+      {"lOe", false},     {"lOh", false},     {"lOs", false},
+      {"lOt", false},     {"rate12e", false}, {"rate21e", false},
+      {"rate12h", false}, {"rate21h", false}, {"rate12s", false},
+      {"rate21s", false}, {"rate12t", false}, {"rate21t", false},
+      {"Jeff2e", false},  {"Jeff2h", false},  {"Jeff2s", false},
+      {"Jeff2t", false},  {"type", true}};
+  return columns;
+}
+
+std::vector<double> StateSaverSQLite::PairRow(ctp::QMPair *pair) const {
+  std::vector<double> row = {double(pair->Seg1PbCopy()->getId()),
+                             double(pair->Seg2PbCopy()->getId()),
+                             pair->R().getX(),
+                             pair->R().getY(),
+                             pair->R().getZ(),
+                             (pair->isPathCarrier(-1)) ? 1.0 : 0.0,
+                             (pair->isPathCarrier(+1)) ? 1.0 : 0.0,
+                             (pair->isPathCarrier(+2)) ? 1.0 : 0.0,
+                             (pair->isPathCarrier(+3)) ? 1.0 : 0.0,
+                             pair->getLambdaO(-1),
+                             pair->getLambdaO(+1),
+                             pair->getLambdaO(+2),
+                             pair->getLambdaO(+3),
+                             pair->getRate12(-1),
+                             pair->getRate21(-1),
+                             pair->getRate12(+1),
+                             pair->getRate21(+1),
+                             pair->getRate12(+2),
+                             pair->getRate21(+2),
+                             pair->getRate12(+3),
+                             pair->getRate21(+3),
+                             pair->getJeff2(-1),
+                             pair->getJeff2(+1),
+                             pair->getJeff2(+2),
+                             pair->getJeff2(+3),
+                             double(pair->getType())};
+  return row;
+}
+
+void StateSaverSQLite::SnapshotSegments() {
+  _seg_snapshot.clear();
+  _seg_snapshot.reserve(_qmtop->Segments().size());
+  for (ctp::Segment *seg : _qmtop->Segments()) {
+    _seg_snapshot.push_back(SegmentRow(seg));
+  }
+}
+
+void StateSaverSQLite::SnapshotPairs() {
+  _pair_snapshot.clear();
+  _pair_snapshot.reserve(_qmtop->NBList().size());
+  for (ctp::QMPair *pair : _qmtop->NBList()) {
+    _pair_snapshot.push_back(PairRow(pair));
+  }
+}
+
+int StateSaverSQLite::UpdateColumns(
+    const std::string &table, const std::vector<Column> &columns,
+    int firstcol, const std::vector<int> &ids,
+    const std::vector<std::vector<double> > &rows,
+    std::vector<std::vector<double> > &snapshot) {
+  // one prepared statement per column, created when the column first changes
+  std::vector<Statement *> stmts(columns.size(), NULL);
+  int updated = 0;
+  for (unsigned i = 0; i < rows.size(); i++) {
+    for (unsigned c = firstcol; c < columns.size(); c++) {
+      if (rows[i][c] == snapshot[i][c]) continue;
+      if (stmts[c] == NULL) {
+        std::string sql = "UPDATE " + table + " SET " + columns[c].name +
+                          " = ? WHERE top = ? AND id = ?;";
+        stmts[c] = _db.Prepare(sql.c_str());
+      }
+      Statement *stmt = stmts[c];
+      if (columns[c].isInt) {
+        stmt->Bind(1, int(rows[i][c]));
+      } else {
+        stmt->Bind(1, rows[i][c]);
+      }
+      stmt->Bind(2, _qmtop->getDatabaseId());
+      stmt->Bind(3, ids[i]);
+      stmt->Step();
+      stmt->Reset();
+      updated++;
+    }
+  }
+  for (Statement *stmt : stmts) {
+    delete stmt;
+  }
+  snapshot = rows;
+  return updated;
+}
+
+bool StateSaverSQLite::UpdateSegments() {
+  std::vector<ctp::Segment *> &segments = _qmtop->Segments();
+  if (segments.size() != _seg_snapshot.size()) {
+    return false;
+  }
+  std::vector<int> ids;
+  std::vector<std::vector<double> > rows;
+  ids.reserve(segments.size());
+  rows.reserve(segments.size());
+  for (unsigned i = 0; i < segments.size(); i++) {
+    rows.push_back(SegmentRow(segments[i]));
+    if (rows[i][0] != _seg_snapshot[i][0]) {
+      return false;
+    }
+    ids.push_back(segments[i]->getId());
+  }
+  cout << ", segments" << flush;
+  int updated = UpdateColumns("segments", SegmentColumns(), 1, ids, rows,
+                              _seg_snapshot);
+  cout << " (" << updated << " values updated)" << flush;
+  return true;
+}
+
+bool StateSaverSQLite::UpdatePairs() {
+  ctp::QMNBList &nblist = _qmtop->NBList();
+  if (nblist.size() != _pair_snapshot.size()) {
+    return false;
+  }
+  std::vector<int> ids;
+  std::vector<std::vector<double> > rows;
+  ids.reserve(nblist.size());
+  rows.reserve(nblist.size());
+  for (ctp::QMPair *pair : nblist) {
+    std::vector<double> row = PairRow(pair);
+    const std::vector<double> &old = _pair_snapshot[rows.size()];
+    if (row[0] != old[0] || row[1] != old[1]) {
+      return false;
+    }
+    rows.push_back(row);
+    ids.push_back(pair->getId());
+  }
+  if (!nblist.size()) {
+    return true;
+  }
+  cout << ", pairs" << flush;
+  int updated =
+      UpdateColumns("pairs", PairColumns(), 2, ids, rows, _pair_snapshot);
+  cout << " (" << updated << " values updated)" << flush;
+  return true;
+}
+
 void StateSaverSQLite::WriteFragments(bool update) {
   cout << ", fragments" << flush;
 
@@ -604,17 +811,30 @@ void StateSaverSQLite::ReadFrame() {
        << " from " << _sqlfile << endl;
   cout << "...";
 
-  _qmtop->CleanUp();
-  _qmtop->setDatabaseId(topId);
-
-  this->ReadMeta(topId);
-  this->ReadMolecules(topId);
-  this->ReadSegTypes(topId);
-  this->ReadSegments(topId);
-  this->ReadFragments(topId);
-  this->ReadAtoms(topId);
-  this->ReadPairs(topId);
-  this->ReadSuperExchange(topId);
+  TopologySnapshot snapshot(_sqlfile, topId);
+  if (_use_snapshot && snapshot.Read(*_qmtop)) {
+    cout << " snapshot " << snapshot.getFileName();
+  } else {
+    _qmtop->CleanUp();
+    _qmtop->setDatabaseId(topId);
+
+    this->ReadMeta(topId);
+    this->ReadMolecules(topId);
+    this->ReadSegTypes(topId);
+    this->ReadSegments(topId);
+    this->ReadFragments(topId);
+    this->ReadAtoms(topId);
+    this->ReadPairs(topId);
+    this->ReadSuperExchange(topId);
+
+    if (_use_snapshot) {
+      snapshot.Write(*_qmtop);
+      cout << ", wrote snapshot " << snapshot.getFileName();
+    }
+  }
+
+  this->SnapshotSegments();
+  this->SnapshotPairs();
 
   cout << ". " << endl;
 }
@@ -18,11 +18,47 @@
  */
 
 #include <votca/xtp/eigen.h>
-#include <votca/xtp/symmetric_matrix.h>
+#include <votca/xtp/scratcharena.h>
 #include <votca/xtp/threecenter.h>
 namespace votca {
 namespace xtp {
 
+namespace {
+// block size of the float products, whose results are summed up in double
+const int float_block = 1024;
+}  // namespace
+
+/*
+ * A shell pair is kept if the overlap of any two of its normalized s-type
+ * primitives, (2 sqrt(ab) / (a+b))^3/2 exp(-ab/(a+b) R^2), exceeds the
+ * threshold. The 3c integrals of the pair carry the same exponential
+ * factor.
+ */
+bool TCMatrix_dft::isSignificant(const AOShell* shell_row,
+                                 const AOShell* shell_col) const {
+  if (_pair_threshold <= 0.0) {
+    return true;
+  }
+  const tools::vec diff = shell_row->getPos() - shell_col->getPos();
+  const double distsq = diff * diff;
+  for (AOShell::GaussianIterator itr = shell_row->begin();
+       itr != shell_row->end(); ++itr) {
+    const double decay_row = itr->getDecay();
+    for (AOShell::GaussianIterator itc = shell_col->begin();
+         itc != shell_col->end(); ++itc) {
+      const double decay_col = itc->getDecay();
+      const double decay = decay_row + decay_col;
+      const double overlap =
+          std::pow(2.0 * std::sqrt(decay_row * decay_col) / decay, 1.5) *
+          std::exp(-decay_row * decay_col / decay * distsq);
+      if (overlap > _pair_threshold) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void TCMatrix_dft::Fill(const AOBasis& auxbasis, const AOBasis& dftbasis) {
 
   AOCoulomb auxAOcoulomb;
@@ -30,80 +66,225 @@ void TCMatrix_dft::Fill(const AOBasis& auxbasis, const AOBasis& dftbasis) {
   _inv_sqrt = auxAOcoulomb.Pseudo_InvSqrt(1e-8);
   _removedfunctions = auxAOcoulomb.Removedfunctions();
 
-  for (int i = 0; i < auxbasis.AOBasisSize(); i++) {
-    try {
-      _matrix.push_back(Symmetric_Matrix(dftbasis.AOBasisSize()));
-    } catch (std::bad_alloc& ba) {
-      throw std::runtime_error(
-          "Basisset/aux basis too large for 3c calculation. Not enough RAM.");
+  _auxbasis = &auxbasis;
+  _dftbasissize = dftbasis.AOBasisSize();
+  _auxsize = auxbasis.AOBasisSize();
+  _pairs.clear();
+  int pairfunctions = 0;
+  for (unsigned row = 0; row < dftbasis.getNumofShells(); row++) {
+    const AOShell* shell_row = dftbasis.getShell(row);
+    for (unsigned col = 0; col <= row; col++) {
+      const AOShell* shell_col = dftbasis.getShell(col);
+      if (isSignificant(shell_row, shell_col)) {
+        _pairs.push_back({shell_row, shell_col, pairfunctions});
+        pairfunctions += shell_row->getNumFunc() * shell_col->getNumFunc();
+      }
     }
   }
+  FillMatrix(auxbasis);
+  return;
+}
+
+void TCMatrix_dft::RefillDouble() {
+  if (!_single_precision) {
+    return;
+  }
+  _single_precision = false;
+  FillMatrix(*_auxbasis);
+  return;
+}
+
+int TCMatrix_dft::PairFunctions() const {
+  if (_pairs.empty()) {
+    return 0;
+  }
+  const ShellPair& last = _pairs.back();
+  return last.offset + last.row->getNumFunc() * last.col->getNumFunc();
+}
+
+void TCMatrix_dft::FillMatrix(const AOBasis& auxbasis) {
+  const int pairfunctions = PairFunctions();
+  try {
+    if (_single_precision) {
+      _matrix.resize(0, 0);
+      _matrix_float = Eigen::MatrixXf::Zero(pairfunctions, _auxsize);
+    } else {
+      _matrix_float.resize(0, 0);
+      _matrix = Eigen::MatrixXd::Zero(pairfunctions, _auxsize);
+    }
+  } catch (std::bad_alloc& ba) {
+    throw std::runtime_error(
+        "Basisset/aux basis too large for 3c calculation. Not enough RAM.");
+  }
 #pragma omp parallel for schedule(dynamic)
-  for (int is = dftbasis.getNumofShells() - 1; is >= 0; is--) {
-    const AOShell* dftshell = dftbasis.getShell(is);
-    std::vector<Eigen::MatrixXd> block;
-    for (int i = 0; i < dftshell->getNumFunc(); i++) {
-      int size = dftshell->getStartIndex() + i + 1;
-      block.push_back(Eigen::MatrixXd::Zero(auxbasis.AOBasisSize(), size));
+  for (unsigned i = 0; i < _pairs.size(); i++) {
+    const ShellPair& pair = _pairs[i];
+    int npair = pair.row->getNumFunc() * pair.col->getNumFunc();
+    Eigen::MatrixXd block = Eigen::MatrixXd::Zero(_auxsize, npair);
+    FillBlock(block, pair, auxbasis);
+    if (_single_precision) {
+      _matrix_float.middleRows(pair.offset, npair) =
+          (_inv_sqrt * block).transpose().cast<float>();
+    } else {
+      _matrix.middleRows(pair.offset, npair) = (_inv_sqrt * block).transpose();
     }
-    FillBlock(block, is, dftbasis, auxbasis);
-    int offset = dftshell->getStartIndex();
-    for (unsigned i = 0; i < block.size(); ++i) {
-      Eigen::MatrixXd temp = _inv_sqrt * block[i];
-      for (int mu = 0; mu < temp.rows(); ++mu) {
-        for (int j = 0; j < temp.cols(); ++j) {
-          _matrix[mu](i + offset, j) = temp(mu, j);
-        }
+  }
+  return;
+}
+
+template <typename T>
+Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> TCMatrix_dft::FullMatrix(
+    const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& matrix,
+    int aux) const {
+  Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> full =
+      Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(_dftbasissize,
+                                                             _dftbasissize);
+  for (const ShellPair& pair : _pairs) {
+    int row_start = pair.row->getStartIndex();
+    int col_start = pair.col->getStartIndex();
+    int ncol = pair.col->getNumFunc();
+    for (int i = 0; i < pair.row->getNumFunc(); i++) {
+      for (int j = 0; j < ncol; j++) {
+        T value = matrix(pair.offset + i * ncol + j, aux);
+        full(row_start + i, col_start + j) = value;
+        full(col_start + j, row_start + i) = value;
       }
     }
   }
-  return;
+  return full;
+}
+
+Eigen::MatrixXd TCMatrix_dft::FullMatrix(int aux) const {
+  if (_single_precision) {
+    return FullMatrix(_matrix_float, aux).cast<double>();
+  }
+  return FullMatrix(_matrix, aux);
+}
+
+Eigen::MatrixXf TCMatrix_dft::FullMatrixFloat(int aux) const {
+  if (_single_precision) {
+    return FullMatrix(_matrix_float, aux);
+  }
+  return FullMatrix(_matrix, aux).cast<float>();
 }
 
 /*
- * Determines the 3-center integrals for a given shell in the aux basis
- * by calculating the 3-center overlap integral of the functions in the
- * aux shell with ALL functions in the DFT basis set (FillThreeCenterOLBlock)
+ * Both contractions run over the packed pairs only. Pairs of different
+ * shells stand for the mn and the nm element and count twice, diagonal
+ * shell pairs are stored as full square blocks.
  */
+Eigen::VectorXd TCMatrix_dft::ContractRows(const Eigen::VectorXd& dpacked,
+                                           int start, int size) const {
+  if (!_single_precision) {
+    return _matrix.middleRows(start, size).transpose() *
+           dpacked.segment(start, size);
+  }
+  Eigen::VectorXd result = Eigen::VectorXd::Zero(_auxsize);
+  for (int row = start; row < start + size; row += float_block) {
+    int rows = std::min(float_block, start + size - row);
+    Eigen::VectorXf d = dpacked.segment(row, rows).cast<float>();
+    result +=
+        (_matrix_float.middleRows(row, rows).transpose() * d).cast<double>();
+  }
+  return result;
+}
 
-void TCMatrix_dft::FillBlock(std::vector<Eigen::MatrixXd>& block,
-                             int shellindex, const AOBasis& dftbasis,
-                             const AOBasis& auxbasis) {
-  const AOShell* left_dftshell = dftbasis.getShell(shellindex);
-  tensor3d::extent_gen extents;
-  int start = left_dftshell->getStartIndex();
-  // alpha-loop over the aux basis function
-  for (const AOShell* shell_aux : auxbasis) {
-    int aux_start = shell_aux->getStartIndex();
+Eigen::VectorXd TCMatrix_dft::ExpandRows(const Eigen::VectorXd& coeff,
+                                         int start, int size) const {
+  if (!_single_precision) {
+    return _matrix.middleRows(start, size) * coeff;
+  }
+  Eigen::VectorXd result = Eigen::VectorXd::Zero(size);
+  for (int aux = 0; aux < _auxsize; aux += float_block) {
+    int auxs = std::min(float_block, _auxsize - aux);
+    Eigen::VectorXf c = coeff.segment(aux, auxs).cast<float>();
+    result +=
+        (_matrix_float.block(start, aux, size, auxs) * c).cast<double>();
+  }
+  return result;
+}
 
-    for (int is = 0; is <= shellindex; is++) {
+Eigen::MatrixXd TCMatrix_dft::ContractDensity(
+    const Eigen::MatrixXd& dmat) const {
+  const int pairfunctions = PairFunctions();
+  Eigen::VectorXd dpacked = Eigen::VectorXd::Zero(pairfunctions);
+  for (const ShellPair& pair : _pairs) {
+    int row_start = pair.row->getStartIndex();
+    int col_start = pair.col->getStartIndex();
+    int ncol = pair.col->getNumFunc();
+    double factor = (pair.row == pair.col) ? 1.0 : 2.0;
+    for (int i = 0; i < pair.row->getNumFunc(); i++) {
+      for (int j = 0; j < ncol; j++) {
+        dpacked(pair.offset + i * ncol + j) =
+            factor * dmat(row_start + i, col_start + j);
+      }
+    }
+  }
 
-      const AOShell* shell_col = dftbasis.getShell(is);
-      int col_start = shell_col->getStartIndex();
-      tensor3d threec_block(extents[range(0, shell_aux->getNumFunc())][range(
-          0, left_dftshell->getNumFunc())][range(0, shell_col->getNumFunc())]);
-      for (int i = 0; i < shell_aux->getNumFunc(); ++i) {
-        for (int j = 0; j < left_dftshell->getNumFunc(); ++j) {
-          for (int k = 0; k < shell_col->getNumFunc(); ++k) {
-            threec_block[i][j][k] = 0.0;
-          }
-        }
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+  const int rows = dpacked.size();
+  std::vector<Eigen::VectorXd> coeff_thread(nthreads,
+                                            Eigen::VectorXd::Zero(_auxsize));
+#pragma omp parallel for
+  for (int thread = 0; thread < nthreads; ++thread) {
+    int start = (rows * thread) / nthreads;
+    int size = (rows * (thread + 1)) / nthreads - start;
+    coeff_thread[thread] = ContractRows(dpacked, start, size);
+  }
+  Eigen::VectorXd coeff = Eigen::VectorXd::Zero(_auxsize);
+  for (const Eigen::VectorXd& thread : coeff_thread) {
+    coeff += thread;
+  }
+
+  Eigen::VectorXd jpacked = Eigen::VectorXd::Zero(rows);
+#pragma omp parallel for
+  for (int thread = 0; thread < nthreads; ++thread) {
+    int start = (rows * thread) / nthreads;
+    int size = (rows * (thread + 1)) / nthreads - start;
+    jpacked.segment(start, size) = ExpandRows(coeff, start, size);
+  }
+
+  Eigen::MatrixXd result = Eigen::MatrixXd::Zero(dmat.rows(), dmat.cols());
+  for (const ShellPair& pair : _pairs) {
+    int row_start = pair.row->getStartIndex();
+    int col_start = pair.col->getStartIndex();
+    int ncol = pair.col->getNumFunc();
+    for (int i = 0; i < pair.row->getNumFunc(); i++) {
+      for (int j = 0; j < ncol; j++) {
+        double value = jpacked(pair.offset + i * ncol + j);
+        result(row_start + i, col_start + j) = value;
+        result(col_start + j, row_start + i) = value;
       }
+    }
+  }
+  return result;
+}
+
+/*
+ * Determines the 3-center integrals of a dft shell pair with ALL functions
+ * in the aux basis set, block(aux, row_function * ncol + col_function)
+ */
+void TCMatrix_dft::FillBlock(Eigen::MatrixXd& block, const ShellPair& pair,
+                             const AOBasis& auxbasis) {
+  const int nrow = pair.row->getNumFunc();
+  const int ncol = pair.col->getNumFunc();
+  for (const AOShell* shell_aux : auxbasis) {
+    int aux_start = shell_aux->getStartIndex();
+    ScratchArena::Frame scratch;
+    tensor3d_ref threec_block =
+        scratch.Tensor3D(shell_aux->getNumFunc(), nrow, ncol);
 
-      bool nonzero = FillThreeCenterRepBlock(threec_block, shell_aux,
-                                             left_dftshell, shell_col);
-      if (nonzero) {
-
-        for (int left = 0; left < left_dftshell->getNumFunc(); left++) {
-          for (int aux = 0; aux < shell_aux->getNumFunc(); aux++) {
-            for (int col = 0; col < shell_col->getNumFunc(); col++) {
-              // symmetry
-              if ((col_start + col) > (start + left)) {
-                break;
-              }
-              block[left](aux_start + aux, col_start + col) =
-                  threec_block[aux][left][col];
-            }
+    bool nonzero =
+        FillThreeCenterRepBlock(threec_block, shell_aux, pair.row, pair.col);
+    if (nonzero) {
+      for (int aux = 0; aux < shell_aux->getNumFunc(); aux++) {
+        for (int row = 0; row < nrow; row++) {
+          for (int col = 0; col < ncol; col++) {
+            block(aux_start + aux, row * ncol + col) =
+                threec_block[aux][row][col];
           }
         }
       }
@@ -17,6 +17,9 @@
  *
  */
 
+#include <algorithm>
+#include <stdexcept>
+#include <votca/xtp/scratcharena.h>
 #include <votca/xtp/threecenter.h>
 
 namespace votca {
@@ -34,13 +37,9 @@ void TCMatrix_gwbse::Initialize(int basissize, int mmin, int mmax, int nmin,
   _mtotal = mmax - mmin + 1;
   _basissize = basissize;
 
-  // vector has mtotal elements
-  _matrix.resize(_mtotal);
-
-  // each element is a gwabasis-by-n matrix, initialize to zero
-  for (int i = 0; i < this->msize(); i++) {
-    _matrix[i] = MatrixXfd::Zero(_ntotal, _basissize);
-  }
+  // mtotal levels, each a n-by-gwbasis matrix, initialized to zero
+  _levelstride = std::size_t(_ntotal) * _basissize;
+  _matrix.Allocate(_levelstride * _mtotal, _max_memory, _scratch_directory);
 }
 
 /*
@@ -48,16 +47,58 @@ void TCMatrix_gwbse::Initialize(int basissize, int mmin, int mmax, int nmin,
  * Coulomb interaction.
  */
 void TCMatrix_gwbse::MultiplyRightWithAuxMatrix(const Eigen::MatrixXd& matrix) {
+  if (matrix.cols() > _basissize) {
+    throw std::runtime_error(
+        "TCMatrix_gwbse: aux matrix would enlarge the aux space");
+  }
+#pragma omp parallel for
+  for (int i_occ = 0; i_occ < _mtotal; i_occ++) {
+    Prefetch(i_occ + 1);
+#if (GWBSE_DOUBLE)
+    const Eigen::MatrixXd temp = Level(i_occ) * matrix;
+#else
+    const Eigen::MatrixXd m = Level(i_occ).cast<double>();
+    const MatrixXfd temp = (m * matrix).cast<float>();
+#endif
+    Eigen::Map<MatrixXfd>(_matrix.data() + i_occ * _levelstride, _ntotal,
+                          matrix.cols()) = temp;
+    Release(i_occ);
+  }
+  _basissize = matrix.cols();
+  return;
+}
 
+void TCMatrix_gwbse::Compress() {
+  Eigen::MatrixXd gram = Eigen::MatrixXd::Zero(_basissize, _basissize);
 #pragma omp parallel for
   for (int i_occ = 0; i_occ < _mtotal; i_occ++) {
+    Prefetch(i_occ + 1);
 #if (GWBSE_DOUBLE)
-    Eigen::MatrixXd temp = _matrix[i_occ] * matrix;
-    _matrix[i_occ] = temp;
+    const Eigen::Map<const MatrixXfd> m = (*this)[i_occ];
 #else
-    const Eigen::MatrixXd m = _matrix[i_occ].cast<double>();
-    _matrix[i_occ].noalias() = (m * matrix).cast<float>();
+    const Eigen::MatrixXd m = (*this)[i_occ].cast<double>();
 #endif
+    Eigen::MatrixXd temp = m.transpose() * m;
+    Release(i_occ);
+#pragma omp critical
+    { gram += temp; }
+  }
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> es(gram);
+  const Eigen::VectorXd& eigenvalues = es.eigenvalues();
+  const double threshold = _compression * eigenvalues.sum();
+  double discarded = 0.0;
+  int removed = 0;
+  // eigenvalues are sorted ascending
+  while (removed < _basissize - 1 &&
+         discarded + eigenvalues(removed) <= threshold) {
+    discarded += eigenvalues(removed);
+    removed++;
+  }
+  _compressedfunctions = removed;
+  if (removed > 0) {
+    const Eigen::MatrixXd kept =
+        es.eigenvectors().rightCols(_basissize - removed);
+    MultiplyRightWithAuxMatrix(kept);
   }
   return;
 }
@@ -74,29 +115,18 @@ void TCMatrix_gwbse::Fill(const AOBasis& gwbasis, const AOBasis& dftbasis,
   _auxbasis = &gwbasis;
   _dftbasis = &dftbasis;
   _dft_orbitals = &dft_orbitals;
+  // a previous compression shrank the matrices
+  if (_basissize != gwbasis.AOBasisSize()) {
+    Initialize(gwbasis.AOBasisSize(), _mmin, _mmax, _nmin, _nmax);
+  }
 
-  // loop over all shells in the GW basis and get _Mmn for that shell
-#pragma omp parallel for schedule(guided)  // private(_block)
+  // loop over all shells in the GW basis and get _Mmn for that shell, the AO
+  // integrals of a shell are computed once and its columns written straight
+  // into all levels, also out of core
+#pragma omp parallel for schedule(guided)
   for (unsigned is = 0; is < gwbasis.getNumofShells(); is++) {
-    const AOShell* shell = gwbasis.getShell(is);
-    std::vector<Eigen::MatrixXd> block;
-    for (int i = 0; i < _mtotal; i++) {
-      block.push_back(Eigen::MatrixXd::Zero(_ntotal, shell->getNumFunc()));
-    }
-    // Fill block for this shell (3-center overlap with _dft_basis +
-    // multiplication with _dft_orbitals )
-    FillBlock(block, shell, dftbasis, dft_orbitals);
-
-    // put into correct position
-    for (int m_level = 0; m_level < this->msize(); m_level++) {
-      for (int i_gw = 0; i_gw < shell->getNumFunc(); i_gw++) {
-        for (int n_level = 0; n_level < this->nsize(); n_level++) {
-          _matrix[m_level](n_level, shell->getStartIndex() + i_gw) =
-              block[m_level](n_level, i_gw);
-        }  // n-th DFT orbital
-      }    // GW basis function in shell
-    }      // m-th DFT orbital
-  }        // shells of GW basis set
+    FillBlock(gwbasis.getShell(is), dftbasis, dft_orbitals);
+  }
 
   AOOverlap auxoverlap;
   auxoverlap.Fill(gwbasis);
@@ -105,6 +135,9 @@ void TCMatrix_gwbse::Fill(const AOBasis& gwbasis, const AOBasis& dftbasis,
   Eigen::MatrixXd inv_sqrt = auxcoulomb.Pseudo_InvSqrt_GWBSE(auxoverlap, 5e-7);
   _removedfunctions = auxcoulomb.Removedfunctions();
   MultiplyRightWithAuxMatrix(inv_sqrt);
+  if (_compression > 0.0) {
+    Compress();
+  }
   return;
 }
 
@@ -115,10 +148,8 @@ void TCMatrix_gwbse::Fill(const AOBasis& gwbasis, const AOBasis& dftbasis,
  * followed by a convolution of those with the DFT orbital coefficients
  */
 
-void TCMatrix_gwbse::FillBlock(std::vector<Eigen::MatrixXd>& block,
-                               const AOShell* auxshell, const AOBasis& dftbasis,
+void TCMatrix_gwbse::FillBlock(const AOShell* auxshell, const AOBasis& dftbasis,
                                const Eigen::MatrixXd& dft_orbitals) {
-  tensor3d::extent_gen extents;
   std::vector<Eigen::MatrixXd> symmstorage;
   for (int i = 0; i < auxshell->getNumFunc(); ++i) {
     symmstorage.push_back(
@@ -139,15 +170,10 @@ void TCMatrix_gwbse::FillBlock(std::vector<Eigen::MatrixXd>& block,
       const AOShell* shell_col = dftbasis.getShell(col);
       const int col_start = shell_col->getStartIndex();
 
-      tensor3d threec_block(extents[range(0, auxshell->getNumFunc())][range(
-          0, shell_row->getNumFunc())][range(0, shell_col->getNumFunc())]);
-      for (int i = 0; i < auxshell->getNumFunc(); ++i) {
-        for (int j = 0; j < shell_row->getNumFunc(); ++j) {
-          for (int k = 0; k < shell_col->getNumFunc(); ++k) {
-            threec_block[i][j][k] = 0.0;
-          }
-        }
-      }
+      ScratchArena::Frame scratch;
+      tensor3d_ref threec_block =
+          scratch.Tensor3D(auxshell->getNumFunc(), shell_row->getNumFunc(),
+                           shell_col->getNumFunc());
 
       bool nonzero =
           FillThreeCenterRepBlock(threec_block, auxshell, shell_row, shell_col);
@@ -174,11 +200,10 @@ void TCMatrix_gwbse::FillBlock(std::vector<Eigen::MatrixXd>& block,
         matrix(j, i) = matrix(i, j);
       }
     }
-    Eigen::MatrixXd threec_inMo = dftn.transpose() * matrix * dftm;
-    for (int i = 0; i < threec_inMo.cols(); ++i) {
-      for (int j = 0; j < threec_inMo.rows(); ++j) {
-        block[i](j, k) = threec_inMo(j, i);
-      }
+    const Eigen::MatrixXd threec_inMo = dftn.transpose() * matrix * dftm;
+    const int col = auxshell->getStartIndex() + k;
+    for (int i = 0; i < _mtotal; ++i) {
+      Level(i).col(col) = threec_inMo.col(i).cast<real_gwbse>();
     }
   }
   return;
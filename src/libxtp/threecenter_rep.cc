@@ -18,6 +18,8 @@
  */
 
 #include <votca/xtp/threecenter.h>
+#include <votca/xtp/boysfunction.h>
+#include <votca/xtp/scratcharena.h>
 
 using namespace std;
 
@@ -39,7 +41,7 @@ namespace xtp {
  *
  */
 
-bool TCMatrix::FillThreeCenterRepBlock(tensor3d& threec_block,
+bool TCMatrix::FillThreeCenterRepBlock(tensor3d_ref& threec_block,
                                        const AOShell* shell_3,
                                        const AOShell* shell_1,
                                        const AOShell* shell_2) {
@@ -253,33 +255,14 @@ bool TCMatrix::FillThreeCenterRepBlock(tensor3d& threec_block,
         double wmp2 = wmp.getZ();
         double wmc2 = wmc.getZ();
 
-        tensor3d::extent_gen extents;
-        tensor3d R_temp;
-        R_temp.resize(extents[range(0, ncombined)][range(0, ngamma)]
-                             [range(0, max(2, mmax + 1))]);
-        // initialize to zero
-        for (index3d i = 0; i != ncombined; ++i) {
-          for (index3d j = 0; j != ngamma; ++j) {
-            for (index3d k = 0; k != mmax + 1; ++k) {
-              R_temp[i][j][k] = 0.0;
-            }
-          }
-        }
-
-        tensor3d R;
-        R.resize(
-            extents[range(0, ncombined)][range(0, nbeta)][range(0, ngamma)]);
-        // initialize to zero
-        for (index3d i = 0; i != ncombined; ++i) {
-          for (index3d j = 0; j != nbeta; ++j) {
-            for (index3d k = 0; k != ngamma; ++k) {
-              R[i][j][k] = 0.0;
-            }
-          }
-        }
+        // zero initialised, released at the end of this primitive triple
+        ScratchArena::Frame scratch;
+        tensor3d_ref R_temp =
+            scratch.Tensor3D(ncombined, ngamma, max(2, mmax + 1));
+        tensor3d_ref R = scratch.Tensor3D(ncombined, nbeta, ngamma);
 
-        const std::vector<double> FmT =
-            AOMatrix<double>::XIntegrate(mmax + 1, U);
+        double FmT[BoysFunction::MaxSize];
+        BoysFunction::Evaluate(mmax + 1, U, FmT);
 
         // ss integrals
 
@@ -24,6 +24,7 @@
 #include "tools/dftgwbse.h"
 #include "tools/excitoncoupling.h"
 #include "tools/gencube.h"
+#include "tools/gwbseensemble.h"
 #include "tools/log2mps.h"
 #include "tools/partialcharges.h"
 #include "tools/pdb2map.h"
@@ -47,6 +48,7 @@ void QMToolFactory::RegisterAll(void) {
   QMTools().Register<Partialcharges>("partialcharges");
   QMTools().Register<DensityAnalysis>("densityanalysis");
   QMTools().Register<Coupling>("coupling");
+  QMTools().Register<GWBSEEnsemble>("gwbseensemble");
 }
 
 }  // namespace xtp
@@ -0,0 +1,218 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "gwbseensemble.h"
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <fstream>
+#include <votca/xtp/nestedteams.h>
+#include <votca/xtp/votca_config.h>
+
+using namespace std;
+
+namespace votca {
+namespace xtp {
+
+void GWBSEEnsemble::Initialize(tools::Property* options) {
+
+  std::string key = "options." + Identify();
+
+  _snapshots =
+      options->ifExistsReturnElseThrowRuntimeError<string>(key + ".snapshots");
+  _xml_output = options->ifExistsReturnElseReturnDefault<string>(
+      key + ".output", "gwbseensemble.out.xml");
+  _reporting = options->ifExistsReturnElseReturnDefault<string>(
+      key + ".reporting", "default");
+  _fill_threads =
+      options->ifExistsReturnElseReturnDefault<int>(key + ".fill_threads", 0);
+
+  string gwbse_xml = options->ifExistsReturnElseThrowRuntimeError<string>(
+      key + ".gwbse_options");
+  load_property_from_xml(_gwbse_options, gwbse_xml.c_str());
+
+  // the basis sets are the same for all snapshots, so they are parsed once
+  _dftbasisset.LoadBasisSet(
+      _gwbse_options.ifExistsReturnElseThrowRuntimeError<string>(
+          "gwbse.dftbasis"));
+  _shared_auxbasis = _gwbse_options.exists("gwbse.auxbasis");
+  if (_shared_auxbasis) {
+    _auxbasisset.LoadBasisSet(
+        _gwbse_options.get("gwbse.auxbasis").as<string>());
+  }
+}
+
+// one checkpoint file with the DFT results per line
+std::vector<std::string> GWBSEEnsemble::ReadSnapshotList() const {
+  std::ifstream in(_snapshots.c_str());
+  if (!in) {
+    throw runtime_error("Cannot open snapshot list " + _snapshots);
+  }
+  std::vector<std::string> orbfiles;
+  std::string line;
+  while (std::getline(in, line)) {
+    boost::trim(line);
+    if (line.empty() || line[0] == '#') continue;
+    orbfiles.push_back(line);
+  }
+  return orbfiles;
+}
+
+std::unique_ptr<GWBSEEnsemble::Snapshot> GWBSEEnsemble::PrepareSnapshot(
+    const std::string& orbfile) {
+  std::unique_ptr<Snapshot> snapshot(
+      new Snapshot(orbfile, _log.getReportLevel()));
+  snapshot->log.setMultithreading(false);
+  snapshot->log.setPreface(ctp::logINFO, "\n... ...");
+  snapshot->log.setPreface(ctp::logERROR, "\n... ...");
+  snapshot->log.setPreface(ctp::logWARNING, "\n... ...");
+  snapshot->log.setPreface(ctp::logDEBUG, "\n... ...");
+  // the hdf5 library is not necessarily thread safe
+#pragma omp critical(gwbseensemble_checkpoint)
+  { snapshot->orbitals.ReadFromCpt(orbfile); }
+  snapshot->gwbse.setLogger(&snapshot->log);
+  snapshot->gwbse.Initialize(_gwbse_options);
+  snapshot->gwbse.setBasisSets(&_dftbasisset,
+                               _shared_auxbasis ? &_auxbasisset : NULL);
+  snapshot->gwbse.PrepareIntegrals();
+  return snapshot;
+}
+
+void GWBSEEnsemble::SolveSnapshot(Snapshot& snapshot) {
+  snapshot.gwbse.SolveGWBSE();
+#pragma omp critical(gwbseensemble_checkpoint)
+  { snapshot.orbitals.WriteToCpt(snapshot.orbfile); }
+  boost::filesystem::path orbpath(snapshot.orbfile);
+  std::string logfile =
+      (orbpath.parent_path() / (orbpath.stem().string() + "_gwbse.log"))
+          .string();
+  std::ofstream ofs(logfile.c_str(), std::ofstream::out);
+  ofs << snapshot.log << std::endl;
+  ofs.close();
+  return;
+}
+
+bool GWBSEEnsemble::Evaluate() {
+
+  if (_reporting == "silent") _log.setReportLevel(ctp::logERROR);
+  if (_reporting == "noisy") _log.setReportLevel(ctp::logDEBUG);
+  if (_reporting == "default") _log.setReportLevel(ctp::logINFO);
+
+  _log.setMultithreading(true);
+  _log.setPreface(ctp::logINFO, "\n... ...");
+  _log.setPreface(ctp::logERROR, "\n... ...");
+  _log.setPreface(ctp::logWARNING, "\n... ...");
+  _log.setPreface(ctp::logDEBUG, "\n... ...");
+
+  std::vector<std::string> orbfiles = ReadSnapshotList();
+
+  // the threads are split between the integrals of the next snapshot and
+  // GW-BSE of the current one
+  int threads = 1;
+#ifdef _OPENMP
+  threads = omp_get_max_threads();
+#endif
+  NestedTeams nested;
+  int fill_threads = (_fill_threads > 0) ? _fill_threads : threads / 2;
+  fill_threads = std::max(1, std::min(fill_threads, threads - 1));
+  int solve_threads = std::max(1, threads - fill_threads);
+  CTP_LOG(ctp::logINFO, _log)
+      << (boost::format("GW-BSE for %1% snapshots, %2% threads for the "
+                        "integrals and %3% threads for GW-BSE") %
+          orbfiles.size() % fill_threads % solve_threads)
+             .str()
+      << flush;
+
+  tools::Property summary;
+  tools::Property& output = summary.add("output", "");
+  int failed = 0;
+  std::unique_ptr<Snapshot> prepared;
+  for (unsigned step = 0; step <= orbfiles.size(); step++) {
+    std::unique_ptr<Snapshot> current = std::move(prepared);
+    std::unique_ptr<Snapshot> next;
+    std::string fill_error;
+    std::string solve_error;
+#pragma omp parallel sections num_threads(2)
+    {
+#pragma omp section
+      {
+        if (step < orbfiles.size()) {
+#ifdef _OPENMP
+          omp_set_num_threads(fill_threads);
+#endif
+          try {
+            next = PrepareSnapshot(orbfiles[step]);
+          } catch (std::exception& e) {
+            fill_error = e.what();
+          }
+        }
+      }
+#pragma omp section
+      {
+        if (current) {
+#ifdef _OPENMP
+          omp_set_num_threads(solve_threads);
+#endif
+          try {
+            SolveSnapshot(*current);
+          } catch (std::exception& e) {
+            solve_error = e.what();
+          }
+        }
+      }
+    }
+
+    if (current) {
+      if (solve_error.empty()) {
+        tools::Property& snapshot = output.add("snapshot", "");
+        snapshot.setAttribute("file", current->orbfile);
+        current->gwbse.addoutput(snapshot);
+        CTP_LOG(ctp::logINFO, _log)
+            << "Finished GW-BSE for " << current->orbfile << flush;
+      } else {
+        failed++;
+        CTP_LOG(ctp::logERROR, _log)
+            << "GW-BSE failed for " << current->orbfile << ": " << solve_error
+            << flush;
+      }
+    }
+    if (!fill_error.empty()) {
+      failed++;
+      CTP_LOG(ctp::logERROR, _log)
+          << "Integrals failed for " << orbfiles[step] << ": " << fill_error
+          << flush;
+    }
+    prepared = std::move(next);
+  }
+
+  CTP_LOG(ctp::logINFO, _log)
+      << (boost::format("%1% of %2% snapshots failed") % failed %
+          orbfiles.size())
+             .str()
+      << flush;
+  CTP_LOG(ctp::logDEBUG, _log) << "Writing output to " << _xml_output << flush;
+  tools::PropertyIOManipulator iomXML(tools::PropertyIOManipulator::XML, 1, "");
+  std::ofstream ofout(_xml_output.c_str(), std::ofstream::out);
+  ofout << iomXML << output;
+  ofout.close();
+  return true;
+}
+
+}  // namespace xtp
+}  // namespace votca
@@ -0,0 +1,82 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_XTP_GWBSEENSEMBLE_H
+#define _VOTCA_XTP_GWBSEENSEMBLE_H
+
+#include <memory>
+#include <votca/ctp/logger.h>
+#include <votca/ctp/qmtool.h>
+#include <votca/xtp/basisset.h>
+#include <votca/xtp/gwbse.h>
+#include <votca/xtp/orbitals.h>
+
+namespace votca {
+namespace xtp {
+
+/**
+ * \brief GW-BSE on an ensemble of geometries of the same molecule
+ *
+ * Runs GW-BSE on the DFT checkpoint files of many snapshots, e.g. from MD.
+ * The basis sets are parsed once for all snapshots. The snapshots run in a
+ * pipeline of two thread groups: while GW and BSE are solved for one
+ * snapshot, the three-center integrals of the next one are computed.
+ * The results are written back into the checkpoint files.
+ */
+class GWBSEEnsemble : public ctp::QMTool {
+ public:
+  GWBSEEnsemble(){};
+  ~GWBSEEnsemble(){};
+
+  std::string Identify() { return "gwbseensemble"; }
+
+  void Initialize(tools::Property* options);
+  bool Evaluate();
+
+ private:
+  struct Snapshot {
+    Snapshot(const std::string& file, ctp::TLogLevel level)
+        : orbfile(file), log(level), gwbse(orbitals) {}
+    std::string orbfile;
+    Orbitals orbitals;
+    ctp::Logger log;
+    GWBSE gwbse;
+  };
+
+  std::vector<std::string> ReadSnapshotList() const;
+  std::unique_ptr<Snapshot> PrepareSnapshot(const std::string& orbfile);
+  void SolveSnapshot(Snapshot& snapshot);
+
+  std::string _snapshots;
+  std::string _xml_output;
+  std::string _reporting;
+  int _fill_threads;
+
+  tools::Property _gwbse_options;
+  BasisSet _dftbasisset;
+  BasisSet _auxbasisset;
+  bool _shared_auxbasis;
+
+  ctp::Logger _log;
+};
+
+}  // namespace xtp
+}  // namespace votca
+
+#endif  // _VOTCA_XTP_GWBSEENSEMBLE_H
@@ -0,0 +1,529 @@
+/*
+ *            Copyright 2009-2018 The VOTCA Development Team
+ *                       (http://www.votca.org)
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *              http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <unistd.h>
+#include <votca/xtp/topologysnapshot.h>
+
+namespace votca {
+namespace xtp {
+
+namespace {
+
+const char snapshot_magic[8] = {'X', 'T', 'P', 'T', 'O', 'P', '0', '1'};
+
+struct Header {
+  char magic[8];
+  std::uint64_t checksum;
+  double time;
+  double box[9];
+  std::int32_t topId;
+  std::int32_t step;
+  std::int32_t canRigid;
+  std::int32_t nstrings;
+  std::int32_t nmolecules;
+  std::int32_t nsegtypes;
+  std::int32_t nsegments;
+  std::int32_t nfragments;
+  std::int32_t natoms;
+  std::int32_t npairs;
+  std::int32_t nsuperexchange;
+  std::int32_t pad;
+  std::uint64_t stringbytes;
+};
+
+struct SegTypeRecord {
+  std::int32_t name;
+  std::int32_t basis;
+  std::int32_t orbfile;
+  std::int32_t coordfile;
+  std::int32_t canRigid;
+};
+
+struct SegmentRecord {
+  double pos[3];
+  double U[12];
+  double E[5];
+  double occ[4];
+  std::int32_t name;
+  std::int32_t type;
+  std::int32_t mol;
+  std::int32_t has[4];
+  std::int32_t pad;
+};
+
+struct FragmentRecord {
+  double pos[3];
+  std::int32_t name;
+  std::int32_t mol;
+  std::int32_t seg;
+  std::int32_t symmetry;
+  std::int32_t leg[3];
+  std::int32_t pad;
+};
+
+struct AtomRecord {
+  double pos[3];
+  double qmpos[3];
+  double weight;
+  std::int32_t name;
+  std::int32_t mol;
+  std::int32_t seg;
+  std::int32_t frag;
+  std::int32_t resnr;
+  std::int32_t resname;
+  std::int32_t qmid;
+  std::int32_t element;
+};
+
+struct PairRecord {
+  double lambdaO[4];
+  double rate12[4];
+  double rate21[4];
+  double jeff2[4];
+  std::int32_t seg1;
+  std::int32_t seg2;
+  std::int32_t has[4];
+  std::int32_t type;
+  std::int32_t pad;
+};
+
+// deduplicates strings, atom and residue names repeat a lot
+class StringTable {
+ public:
+  std::int32_t Add(const std::string& str) {
+    std::map<std::string, std::int32_t>::iterator it = _index.find(str);
+    if (it != _index.end()) {
+      return it->second;
+    }
+    std::int32_t id = std::int32_t(_offsets.size());
+    _index[str] = id;
+    _offsets.push_back(_chars.size());
+    _chars.insert(_chars.end(), str.begin(), str.end());
+    return id;
+  }
+
+  std::int32_t size() const { return std::int32_t(_offsets.size()); }
+  const std::vector<std::uint64_t>& Offsets() const { return _offsets; }
+  const std::vector<char>& Chars() const { return _chars; }
+
+ private:
+  std::map<std::string, std::int32_t> _index;
+  std::vector<std::uint64_t> _offsets;
+  std::vector<char> _chars;
+};
+
+template <class T>
+void WriteArray(std::ofstream& ofs, const std::vector<T>& data) {
+  if (!data.empty()) {
+    ofs.write(reinterpret_cast<const char*>(data.data()),
+              data.size() * sizeof(T));
+  }
+}
+
+// walks through the mapped region, records are read in place
+class Cursor {
+ public:
+  Cursor(const char* begin, std::size_t size)
+      : _pos(begin), _end(begin + size) {}
+
+  template <class T>
+  const T* Next(std::size_t count) {
+    std::size_t bytes = count * sizeof(T);
+    if (std::size_t(_end - _pos) < bytes) {
+      throw std::runtime_error("Topology snapshot is truncated");
+    }
+    const T* result = reinterpret_cast<const T*>(_pos);
+    _pos += bytes;
+    return result;
+  }
+
+ private:
+  const char* _pos;
+  const char* _end;
+};
+
+}  // namespace
+
+TopologySnapshot::TopologySnapshot(const std::string& sqlfile, int topId)
+    : _sqlfile(sqlfile), _topId(topId) {
+  _snapfile = sqlfile + ".frame" + std::to_string(topId) + ".snap";
+}
+
+std::uint64_t TopologySnapshot::StateFileChecksum() const {
+  // The first 100 bytes of a sqlite file contain the file change counter and
+  // the database size in pages, so every committed write changes them.
+  char header[100] = {0};
+  std::ifstream ifs(_sqlfile.c_str(), std::ios::binary);
+  if (!ifs.is_open()) {
+    throw std::runtime_error("Could not open state file " + _sqlfile);
+  }
+  ifs.read(header, sizeof(header));
+  std::uint64_t filesize = boost::filesystem::file_size(_sqlfile);
+
+  // FNV-1a
+  std::uint64_t hash = 14695981039346656037ULL;
+  const std::uint64_t prime = 1099511628211ULL;
+  for (char c : header) {
+    hash = (hash ^ std::uint64_t((unsigned char)c)) * prime;
+  }
+  for (unsigned i = 0; i < sizeof(filesize); i++) {
+    hash = (hash ^ ((filesize >> (8 * i)) & 0xFF)) * prime;
+  }
+  hash = (hash ^ std::uint64_t(_topId)) * prime;
+  return hash;
+}
+
+void TopologySnapshot::Write(ctp::Topology& qmtop) const {
+  StringTable strings;
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+  header.checksum = StateFileChecksum();
+  header.time = qmtop.getTime();
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      header.box[3 * i + j] = qmtop.getBox().get(i, j);
+    }
+  }
+  header.topId = _topId;
+  header.step = qmtop.getStep();
+  header.canRigid = (qmtop.canRigidify()) ? 1 : 0;
+
+  std::vector<std::int32_t> molecules;
+  for (ctp::Molecule* mol : qmtop.Molecules()) {
+    molecules.push_back(strings.Add(mol->getName()));
+  }
+
+  std::vector<SegTypeRecord> segtypes;
+  for (ctp::SegmentType* type : qmtop.SegmentTypes()) {
+    SegTypeRecord rec;
+    rec.name = strings.Add(type->getName());
+    rec.basis = strings.Add(type->getBasisName());
+    rec.orbfile = strings.Add(type->getOrbitalsFile());
+    rec.coordfile = strings.Add(type->getQMCoordsFile());
+    rec.canRigid = (type->canRigidify()) ? 1 : 0;
+    segtypes.push_back(rec);
+  }
+
+  std::vector<SegmentRecord> segments;
+  segments.reserve(qmtop.Segments().size());
+  for (ctp::Segment* seg : qmtop.Segments()) {
+    SegmentRecord rec;
+    std::memset(&rec, 0, sizeof(rec));
+    rec.pos[0] = seg->getPos().getX();
+    rec.pos[1] = seg->getPos().getY();
+    rec.pos[2] = seg->getPos().getZ();
+    rec.U[0] = seg->getU_nC_nN(-1);
+    rec.U[1] = seg->getU_nC_nN(+1);
+    rec.U[2] = seg->getU_cN_cC(-1);
+    rec.U[3] = seg->getU_cN_cC(+1);
+    rec.U[4] = seg->getU_cC_nN(-1);
+    rec.U[5] = seg->getU_cC_nN(+1);
+    rec.U[6] = seg->getU_nX_nN(+2);
+    rec.U[7] = seg->getU_nX_nN(+3);
+    rec.U[8] = seg->getU_xN_xX(+2);
+    rec.U[9] = seg->getU_xN_xX(+3);
+    rec.U[10] = seg->getU_xX_nN(+2);
+    rec.U[11] = seg->getU_xX_nN(+3);
+    for (int i = 0; i < 5; i++) {
+      rec.E[i] = seg->getEMpoles(i - 1);
+    }
+    const int states[4] = {-1, +1, +2, +3};
+    for (int i = 0; i < 4; i++) {
+      rec.occ[i] = seg->getOcc(states[i]);
+      rec.has[i] = (seg->hasState(states[i])) ? 1 : 0;
+    }
+    rec.name = strings.Add(seg->getName());
+    rec.type = seg->getType()->getId();
+    rec.mol = seg->getMolecule()->getId();
+    segments.push_back(rec);
+  }
+
+  std::vector<FragmentRecord> fragments;
+  fragments.reserve(qmtop.Fragments().size());
+  for (ctp::Fragment* frag : qmtop.Fragments()) {
+    FragmentRecord rec;
+    std::memset(&rec, 0, sizeof(rec));
+    rec.pos[0] = frag->getPos().getX();
+    rec.pos[1] = frag->getPos().getY();
+    rec.pos[2] = frag->getPos().getZ();
+    rec.name = strings.Add(frag->getName());
+    rec.mol = frag->getMolecule()->getId();
+    rec.seg = frag->getSegment()->getId();
+    rec.symmetry = frag->getSymmetry();
+    const std::vector<int>& trihedron = frag->getTrihedron();
+    for (unsigned i = 0; i < 3; i++) {
+      rec.leg[i] = (i < trihedron.size()) ? trihedron[i] : -1;
+    }
+    fragments.push_back(rec);
+  }
+
+  std::vector<AtomRecord> atoms;
+  atoms.reserve(qmtop.Atoms().size());
+  for (ctp::Atom* atm : qmtop.Atoms()) {
+    AtomRecord rec;
+    rec.pos[0] = atm->getPos().getX();
+    rec.pos[1] = atm->getPos().getY();
+    rec.pos[2] = atm->getPos().getZ();
+    rec.qmpos[0] = atm->getQMPos().getX();
+    rec.qmpos[1] = atm->getQMPos().getY();
+    rec.qmpos[2] = atm->getQMPos().getZ();
+    rec.weight = atm->getWeight();
+    rec.name = strings.Add(atm->getName());
+    rec.mol = atm->getMolecule()->getId();
+    rec.seg = atm->getSegment()->getId();
+    rec.frag = atm->getFragment()->getId();
+    rec.resnr = atm->getResnr();
+    rec.resname = strings.Add(atm->getResname());
+    rec.qmid = atm->getQMId();
+    rec.element = strings.Add(atm->getElement());
+    atoms.push_back(rec);
+  }
+
+  std::vector<PairRecord> pairs;
+  pairs.reserve(qmtop.NBList().size());
+  for (ctp::QMPair* pair : qmtop.NBList()) {
+    PairRecord rec;
+    std::memset(&rec, 0, sizeof(rec));
+    const int states[4] = {-1, +1, +2, +3};
+    for (int i = 0; i < 4; i++) {
+      rec.lambdaO[i] = pair->getLambdaO(states[i]);
+      rec.rate12[i] = pair->getRate12(states[i]);
+      rec.rate21[i] = pair->getRate21(states[i]);
+      rec.jeff2[i] = pair->getJeff2(states[i]);
+      rec.has[i] = (pair->isPathCarrier(states[i])) ? 1 : 0;
+    }
+    rec.seg1 = pair->Seg1PbCopy()->getId();
+    rec.seg2 = pair->Seg2PbCopy()->getId();
+    rec.type = int(pair->getType());
+    pairs.push_back(rec);
+  }
+
+  std::vector<std::int32_t> superexchange;
+  for (ctp::QMNBList::SuperExchangeType* seType :
+       qmtop.NBList().getSuperExchangeTypes()) {
+    superexchange.push_back(strings.Add(seType->asString()));
+  }
+
+  header.nstrings = strings.size();
+  header.nmolecules = std::int32_t(molecules.size());
+  header.nsegtypes = std::int32_t(segtypes.size());
+  header.nsegments = std::int32_t(segments.size());
+  header.nfragments = std::int32_t(fragments.size());
+  header.natoms = std::int32_t(atoms.size());
+  header.npairs = std::int32_t(pairs.size());
+  header.nsuperexchange = std::int32_t(superexchange.size());
+  header.stringbytes = strings.Chars().size();
+
+  // write to a temporary file first, so that concurrent readers never see a
+  // partially written snapshot
+  std::string tmpfile = _snapfile + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream ofs(tmpfile.c_str(), std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) {
+      throw std::runtime_error("Could not write topology snapshot " + tmpfile);
+    }
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    WriteArray(ofs, strings.Offsets());
+    WriteArray(ofs, strings.Chars());
+    // keep the numeric arrays 8 byte aligned in the mapping
+    std::size_t padding = (8 - strings.Chars().size() % 8) % 8;
+    ofs.write(snapshot_magic, padding);
+    WriteArray(ofs, segtypes);
+    WriteArray(ofs, molecules);
+    if ((5 * segtypes.size() + molecules.size()) % 2) {
+      std::int32_t pad = 0;
+      ofs.write(reinterpret_cast<const char*>(&pad), sizeof(pad));
+    }
+    WriteArray(ofs, segments);
+    WriteArray(ofs, fragments);
+    WriteArray(ofs, atoms);
+    WriteArray(ofs, pairs);
+    WriteArray(ofs, superexchange);
+  }
+  boost::filesystem::rename(tmpfile, _snapfile);
+}
+
+bool TopologySnapshot::Read(ctp::Topology& qmtop) const {
+  if (!boost::filesystem::exists(_snapfile)) {
+    return false;
+  }
+  std::size_t filesize = boost::filesystem::file_size(_snapfile);
+  if (filesize < sizeof(Header)) {
+    return false;
+  }
+
+  namespace bip = boost::interprocess;
+  bip::file_mapping mapping(_snapfile.c_str(), bip::read_only);
+  bip::mapped_region region(mapping, bip::read_only);
+  Cursor cursor(static_cast<const char*>(region.get_address()),
+                region.get_size());
+
+  const Header& header = *cursor.Next<Header>(1);
+  if (std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) ||
+      header.topId != _topId || header.checksum != StateFileChecksum()) {
+    return false;
+  }
+
+  const std::uint64_t* offsets =
+      cursor.Next<std::uint64_t>(std::size_t(header.nstrings));
+  const char* chars = cursor.Next<char>(header.stringbytes);
+  cursor.Next<char>((8 - header.stringbytes % 8) % 8);
+  auto str = [&](std::int32_t id) {
+    std::uint64_t end =
+        (id + 1 < header.nstrings) ? offsets[id + 1] : header.stringbytes;
+    return std::string(chars + offsets[id], chars + end);
+  };
+
+  const SegTypeRecord* segtypes = cursor.Next<SegTypeRecord>(header.nsegtypes);
+  const std::int32_t* molecules = cursor.Next<std::int32_t>(header.nmolecules);
+  cursor.Next<std::int32_t>((5 * header.nsegtypes + header.nmolecules) % 2);
+  const SegmentRecord* segments = cursor.Next<SegmentRecord>(header.nsegments);
+  const FragmentRecord* fragments =
+      cursor.Next<FragmentRecord>(header.nfragments);
+  const AtomRecord* atoms = cursor.Next<AtomRecord>(header.natoms);
+  const PairRecord* pairs = cursor.Next<PairRecord>(header.npairs);
+  const std::int32_t* superexchange =
+      cursor.Next<std::int32_t>(header.nsuperexchange);
+
+  // from here on the topology is rebuilt in the same order as
+  // StateSaverSQLite::ReadFrame does it
+  qmtop.CleanUp();
+  qmtop.setDatabaseId(_topId);
+  qmtop.setTime(header.time);
+  qmtop.setStep(header.step);
+  tools::matrix boxv;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      boxv.set(i, j, header.box[3 * i + j]);
+    }
+  }
+  qmtop.setBox(boxv);
+  qmtop.setCanRigidify(header.canRigid);
+
+  for (int i = 0; i < header.nmolecules; i++) {
+    (void)qmtop.AddMolecule(str(molecules[i]));
+  }
+
+  for (int i = 0; i < header.nsegtypes; i++) {
+    const SegTypeRecord& rec = segtypes[i];
+    ctp::SegmentType* type = qmtop.AddSegmentType(str(rec.name));
+    type->setBasisName(str(rec.basis));
+    type->setOrbitalsFile(str(rec.orbfile));
+    type->setQMCoordsFile(str(rec.coordfile));
+    type->setCanRigidify(rec.canRigid);
+  }
+
+  const int states[4] = {-1, +1, +2, +3};
+  for (int i = 0; i < header.nsegments; i++) {
+    const SegmentRecord& rec = segments[i];
+    ctp::Segment* seg = qmtop.AddSegment(str(rec.name));
+    seg->setMolecule(qmtop.getMolecule(rec.mol));
+    seg->setType(qmtop.getSegmentType(rec.type));
+    seg->setPos(tools::vec(rec.pos[0], rec.pos[1], rec.pos[2]));
+    seg->setU_nC_nN(rec.U[0], -1);
+    seg->setU_nC_nN(rec.U[1], +1);
+    seg->setU_cN_cC(rec.U[2], -1);
+    seg->setU_cN_cC(rec.U[3], +1);
+    seg->setU_cC_nN(rec.U[4], -1);
+    seg->setU_cC_nN(rec.U[5], +1);
+    seg->setU_nX_nN(rec.U[6], +2);
+    seg->setU_nX_nN(rec.U[7], +3);
+    seg->setU_xN_xX(rec.U[8], +2);
+    seg->setU_xN_xX(rec.U[9], +3);
+    seg->setU_xX_nN(rec.U[10], +2);
+    seg->setU_xX_nN(rec.U[11], +3);
+    for (int j = 0; j < 5; j++) {
+      seg->setEMpoles(j - 1, rec.E[j]);
+    }
+    for (int j = 0; j < 4; j++) {
+      seg->setOcc(rec.occ[j], states[j]);
+      seg->setHasState(rec.has[j] == 1, states[j]);
+    }
+    seg->getMolecule()->AddSegment(seg);
+  }
+
+  for (int i = 0; i < header.nfragments; i++) {
+    const FragmentRecord& rec = fragments[i];
+    std::vector<int> trihedron;
+    trihedron.push_back(rec.leg[0]);
+    if (rec.leg[1] >= 0) {
+      trihedron.push_back(rec.leg[1]);
+    }
+    if (rec.leg[2] >= 0) {
+      trihedron.push_back(rec.leg[2]);
+    }
+    ctp::Fragment* frag = qmtop.AddFragment(str(rec.name));
+    frag->setSegment(qmtop.getSegment(rec.seg));
+    frag->setMolecule(qmtop.getMolecule(rec.mol));
+    frag->setPos(tools::vec(rec.pos[0], rec.pos[1], rec.pos[2]));
+    frag->setSymmetry(rec.symmetry);
+    frag->setTrihedron(trihedron);
+    frag->getSegment()->AddFragment(frag);
+    frag->getMolecule()->AddFragment(frag);
+  }
+
+  for (int i = 0; i < header.natoms; i++) {
+    const AtomRecord& rec = atoms[i];
+    ctp::Atom* atm = qmtop.AddAtom(str(rec.name));
+    atm->setWeight(rec.weight);
+    atm->setQMPart(rec.qmid,
+                   tools::vec(rec.qmpos[0], rec.qmpos[1], rec.qmpos[2]));
+    atm->setElement(str(rec.element));
+    atm->setPos(tools::vec(rec.pos[0], rec.pos[1], rec.pos[2]));
+    atm->setFragment(qmtop.getFragment(rec.frag));
+    atm->setSegment(qmtop.getSegment(rec.seg));
+    atm->setMolecule(qmtop.getMolecule(rec.mol));
+    atm->getFragment()->AddAtom(atm);
+    atm->getSegment()->AddAtom(atm);
+    atm->getMolecule()->AddAtom(atm);
+    atm->setResnr(rec.resnr);
+    atm->setResname(str(rec.resname));
+  }
+
+  ctp::QMNBList& nblist = qmtop.NBList();
+  for (int i = 0; i < header.npairs; i++) {
+    const PairRecord& rec = pairs[i];
+    ctp::QMPair* pair =
+        nblist.Add(qmtop.getSegment(rec.seg1), qmtop.getSegment(rec.seg2),
+                   false);
+    for (int j = 0; j < 4; j++) {
+      pair->setIsPathCarrier(rec.has[j] != 0, states[j]);
+      pair->setLambdaO(rec.lambdaO[j], states[j]);
+      pair->setRate12(rec.rate12[j], states[j]);
+      pair->setRate21(rec.rate21[j], states[j]);
+      pair->setJeff2(rec.jeff2[j], states[j]);
+    }
+    pair->setType(rec.type);
+  }
+
+  for (int i = 0; i < header.nsuperexchange; i++) {
+    nblist.AddSuperExchangeType(str(superexchange[i]));
+  }
+  return true;
+}
+
+}  // namespace xtp
+}  // namespace votca
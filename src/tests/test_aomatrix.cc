@@ -581,13 +581,13 @@ BOOST_AUTO_TEST_CASE(externalmatrices_test) {
       0.043208755867, 0.10354578683, 0.043208755867, 0.10354578683,
       0.023957628139, 0.075477416664, 0.12582094161, 0.19479972247;
 
-  bool dip_check = dip_ref.isApprox(dip.Matrix(), 1e-5);
+  bool dip_check = dip_ref.isApprox(dip.getExternalpotential(), 1e-5);
   BOOST_CHECK_EQUAL(dip_check, 1);
   if (!dip_check) {
     std::cout << "dip Ref" << endl;
     std::cout << dip_ref << endl;
     std::cout << "Dip" << endl;
-    std::cout << dip.Matrix() << endl;
+    std::cout << dip.getExternalpotential() << endl;
   }
 
   AOQuadrupole_Potential quad;
@@ -656,16 +656,144 @@ BOOST_AUTO_TEST_CASE(externalmatrices_test) {
       -0.008774945581, -0.10623084333, 0.10623084333, -0.077959498143,
       -0.1710846496, -0.077959498143, -0.1710846496, -0.033638947738,
       -0.11005918435, -0.16786646053, -0.259895667;
-  bool quad_check = quad_ref.isApprox(quad.Matrix(), 1e-5);
+  bool quad_check = quad_ref.isApprox(quad.getExternalpotential(), 1e-5);
   BOOST_CHECK_EQUAL(quad_check, 1);
   if (!quad_check) {
     std::cout << "Quad Ref" << endl;
     std::cout << quad_ref << endl;
     std::cout << "Quad" << endl;
-    std::cout << quad.Matrix() << endl;
+    std::cout << quad.getExternalpotential() << endl;
   }
 }
 
+BOOST_AUTO_TEST_CASE(farfield_test) {
+  Orbitals orbitals;
+  orbitals.LoadFromXYZ("molecule.xyz");
+  BasisSet basis;
+  basis.LoadBasisSet("3-21G.xml");
+  AOBasis aobasis;
+  aobasis.AOBasisFill(basis, orbitals.QMAtoms());
+
+  // one site close to the molecule and two far away
+  ofstream mpsfile("farsites.mps");
+  mpsfile << "! Three Sites" << endl;
+  mpsfile << "! N=3 " << endl;
+  mpsfile << "Units angstrom" << endl;
+  mpsfile << "  C +0 0 3 Rank 2" << endl;
+  mpsfile << "+0.5" << endl;
+  mpsfile << "10 0 0" << endl;
+  mpsfile << "     100 0 0 0 0" << endl;
+  mpsfile
+      << "P +1.9445387 +0.0000000 +0.0000000 +1.9445387 +0.0000000 +1.9445387 "
+      << endl;
+  mpsfile << "  C +40 5 -3 Rank 2" << endl;
+  mpsfile << "-1.2" << endl;
+  mpsfile << "5 -3 8" << endl;
+  mpsfile << "     50 20 -10 30 5" << endl;
+  mpsfile
+      << "P +1.9445387 +0.0000000 +0.0000000 +1.9445387 +0.0000000 +1.9445387 "
+      << endl;
+  mpsfile << "  C -10 -35 20 Rank 2" << endl;
+  mpsfile << "+0.8" << endl;
+  mpsfile << "-6 2 4" << endl;
+  mpsfile << "     -40 10 25 -15 20" << endl;
+  mpsfile
+      << "P +1.9445387 +0.0000000 +0.0000000 +1.9445387 +0.0000000 +1.9445387 "
+      << endl;
+  mpsfile.close();
+
+  std::vector<ctp::APolarSite*> sites = ctp::APS_FROM_MPS("farsites.mps", 0);
+  std::vector<std::shared_ptr<ctp::PolarSeg> > polar_segments;
+  std::shared_ptr<ctp::PolarSeg> newPolarSegment(new ctp::PolarSeg(0, sites));
+  polar_segments.push_back(newPolarSegment);
+
+  AOESP esp;
+  esp.Fillextpotential(aobasis, polar_segments);
+  AOESP esp_far;
+  esp_far.setFarFieldAccuracy(1e-3);
+  esp_far.Fillextpotential(aobasis, polar_segments);
+  BOOST_CHECK(esp_far.getExternalpotential().isApprox(
+      esp.getExternalpotential(), 1e-3));
+
+  AODipole_Potential dip;
+  dip.Fillextpotential(aobasis, polar_segments);
+  AODipole_Potential dip_far;
+  dip_far.setFarFieldAccuracy(1e-3);
+  dip_far.Fillextpotential(aobasis, polar_segments);
+  BOOST_CHECK(dip_far.getExternalpotential().isApprox(
+      dip.getExternalpotential(), 1e-3));
+
+  AOQuadrupole_Potential quad;
+  quad.Fillextpotential(aobasis, polar_segments);
+  AOQuadrupole_Potential quad_far;
+  quad_far.setFarFieldAccuracy(1e-3);
+  quad_far.Fillextpotential(aobasis, polar_segments);
+  BOOST_CHECK(quad_far.getExternalpotential().isApprox(
+      quad.getExternalpotential(), 1e-3));
+
+  // the moments of the same shell pair around its own center
+  AOOverlap overlap;
+  overlap.Fill(aobasis);
+  const AOShell* shell = aobasis.getShell(0);
+  std::vector<Eigen::MatrixXd> moments =
+      AOMultipolePotential::FillMoments(shell, shell, shell->getPos());
+  BOOST_CHECK(moments[0].isApprox(
+      overlap.Matrix().block(0, 0, shell->getNumFunc(), shell->getNumFunc()),
+      1e-10));
+  BOOST_CHECK(moments[1].isZero(1e-10));
+
+  // the far field part alone: the error of the second order expansion falls
+  // off at least as (extent/R)^3 relative to the potential, a missing or
+  // wrong quadrupole moment term only as (extent/R)^2
+  for (double distance : {40.0, 80.0}) {
+    ofstream sitefile("farsite_" + std::to_string(int(distance)) + ".mps");
+    sitefile << "! One Site" << endl;
+    sitefile << "! N=1 " << endl;
+    sitefile << "Units angstrom" << endl;
+    sitefile << "  C " << 0.6 * distance << " " << -0.48 * distance << " "
+             << 0.64 * distance << " Rank 2" << endl;
+    sitefile << "+0.7" << endl;
+    sitefile << "4 -6 3" << endl;
+    sitefile << "     30 -15 20 10 -25" << endl;
+    sitefile
+        << "P +1.9445387 +0.0000000 +0.0000000 +1.9445387 +0.0000000 +1.9445387 "
+        << endl;
+    sitefile.close();
+  }
+  auto farfield_error = [&aobasis](AOMultipolePotential& exact,
+                                   AOMultipolePotential& far,
+                                   const std::string& filename) {
+    std::vector<std::shared_ptr<ctp::PolarSeg> > segments;
+    segments.push_back(std::shared_ptr<ctp::PolarSeg>(
+        new ctp::PolarSeg(0, ctp::APS_FROM_MPS(filename, 0))));
+    exact.Fillextpotential(aobasis, segments);
+    far.setFarFieldAccuracy(1e-3);
+    far.Fillextpotential(aobasis, segments);
+    return (far.getExternalpotential() - exact.getExternalpotential()).norm() /
+           exact.getExternalpotential().norm();
+  };
+  AOESP esp_40, esp_40_far, esp_80, esp_80_far;
+  double esp_error_40 = farfield_error(esp_40, esp_40_far, "farsite_40.mps");
+  double esp_error_80 = farfield_error(esp_80, esp_80_far, "farsite_80.mps");
+  BOOST_CHECK_GT(esp_error_40, 0.0);
+  BOOST_CHECK_GT(esp_error_40, 6 * esp_error_80);
+
+  AODipole_Potential dip_40, dip_40_far, dip_80, dip_80_far;
+  double dip_error_40 = farfield_error(dip_40, dip_40_far, "farsite_40.mps");
+  double dip_error_80 = farfield_error(dip_80, dip_80_far, "farsite_80.mps");
+  BOOST_CHECK_GT(dip_error_40, 0.0);
+  BOOST_CHECK_GT(dip_error_40, 6 * dip_error_80);
+
+  AOQuadrupole_Potential quad_40, quad_40_far, quad_80, quad_80_far;
+  double quad_error_40 =
+      farfield_error(quad_40, quad_40_far, "farsite_40.mps");
+  double quad_error_80 =
+      farfield_error(quad_80, quad_80_far, "farsite_80.mps");
+  BOOST_CHECK_GT(quad_error_40, 0.0);
+  BOOST_CHECK_GT(quad_error_40, 6 * quad_error_80);
+  BOOST_CHECK_LT(quad_error_40, 5e-4);
+}
+
 BOOST_AUTO_TEST_CASE(aomatrices_contracted_test) {
 
   std::ofstream basisfile("contracted.xml");
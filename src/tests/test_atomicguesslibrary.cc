@@ -0,0 +1,73 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE atomicguesslibrary_test
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <votca/xtp/atomicguesslibrary.h>
+
+using namespace votca::xtp;
+
+BOOST_AUTO_TEST_SUITE(atomicguesslibrary_test)
+
+BOOST_AUTO_TEST_CASE(memory) {
+  AtomicGuessLibrary library;
+  std::string key =
+      AtomicGuessLibrary::Key("C", "3-21G", "", "XC_GGA_X_PBE XC_GGA_C_PBE",
+                              "medium");
+  BOOST_CHECK(key != AtomicGuessLibrary::Key("C", "3-21G", "", "XC_GGA_X_PBE",
+                                             "medium XC_GGA_C_PBE"));
+  Eigen::MatrixXd dmat;
+  BOOST_CHECK(!library.Find(key, "", dmat));
+
+  Eigen::MatrixXd density = Eigen::MatrixXd::Random(9, 9);
+  library.Insert(key, "", density);
+  BOOST_CHECK_EQUAL(library.size(), 1);
+  BOOST_CHECK(library.Find(key, "", dmat));
+  BOOST_CHECK(dmat.isApprox(density, 1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(directory) {
+  // a fresh directory, so that files of earlier runs cannot satisfy Find
+  boost::filesystem::path dir =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("atomicguess_test_%%%%-%%%%-%%%%");
+  std::string key = AtomicGuessLibrary::Key("O", "def2-svp", "", "PBE", "fine");
+  Eigen::MatrixXd density = Eigen::MatrixXd::Random(14, 14);
+  {
+    AtomicGuessLibrary library;
+    library.Insert(key, dir.string(), density);
+  }
+  BOOST_CHECK(boost::filesystem::exists(dir / "O_def2-svp__PBE_fine.hdf5"));
+
+  // a new library reads what the first one has written
+  AtomicGuessLibrary library;
+  Eigen::MatrixXd dmat;
+  BOOST_CHECK(library.Find(key, dir.string(), dmat));
+  BOOST_CHECK(dmat.isApprox(density, 1e-12));
+  BOOST_CHECK_EQUAL(library.size(), 1);
+
+  // same file name but a different key
+  std::string other =
+      AtomicGuessLibrary::Key("O", "def2_svp", "", "PBE", "fine");
+  BOOST_CHECK(!library.Find(other, dir.string(), dmat));
+
+  boost::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE boysfunction_test
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <votca/xtp/boysfunction.h>
+
+using namespace votca::xtp;
+
+BOOST_AUTO_TEST_SUITE(boysfunction_test)
+
+// Simpson rule for int_0^1 t^2m exp(-U t^2) dt
+double Quadrature(int m, double U) {
+  const int n = 20000;
+  const double h = 1.0 / n;
+  double sum = 0.0;
+  for (int i = 0; i <= n; i++) {
+    double t = i * h;
+    double weight = (i == 0 || i == n) ? 1.0 : ((i % 2) ? 4.0 : 2.0);
+    sum += weight * std::pow(t, 2 * m) * std::exp(-U * t * t);
+  }
+  return sum * h / 3.0;
+}
+
+BOOST_AUTO_TEST_CASE(values_test) {
+  const double args[] = {0.0,  1e-12, 0.05,  0.37,  2.549, 9.99,
+                         10.0, 25.3,  99.96, 116.96, 117.0, 250.0};
+  for (double U : args) {
+    BoysFunction::Values FmU;
+    BoysFunction::Evaluate(BoysFunction::MaxSize, U, FmU);
+    for (int m = 0; m < BoysFunction::MaxSize; m++) {
+      BOOST_CHECK_CLOSE(FmU[m], Quadrature(m, U), 1e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(size_test) {
+  // lower orders do not depend on the requested size
+  BoysFunction::Values full;
+  BoysFunction::Evaluate(BoysFunction::MaxSize, 3.21, full);
+  double FmU[3];
+  BoysFunction::Evaluate(3, 3.21, FmU);
+  for (int m = 0; m < 3; m++) {
+    BOOST_CHECK_CLOSE(FmU[m], full[m], 1e-12);
+  }
+  BOOST_CHECK_THROW(BoysFunction::Evaluate(0, 1.0, FmU), std::runtime_error);
+  BOOST_CHECK_THROW(BoysFunction::Evaluate(3, -1.0, FmU), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -384,6 +384,30 @@ BOOST_AUTO_TEST_CASE(bse_hamiltonian) {
     cout << tpsi_ref << endl;
   }
   BOOST_CHECK_EQUAL(check_tpsi, true);
+
+  bse.SetupHs();
+  bse.SetupHt();
+  Eigen::MatrixXd X = Eigen::MatrixXd::Random(60, 3);
+  Eigen::MatrixXd HsX_ref = orbitals.eh_s().cast<double>() * X;
+  Eigen::MatrixXd HtX_ref = orbitals.eh_t().cast<double>() * X;
+  Eigen::MatrixXd HsX = bse.ApplyHs(X);
+  Eigen::MatrixXd HtX = bse.ApplyHt(X);
+  bool check_hsx = HsX_ref.isApprox(HsX, 1e-4);
+  if (!check_hsx) {
+    cout << "Hs*X matrix free" << endl;
+    cout << HsX << endl;
+    cout << "Hs*X ref" << endl;
+    cout << HsX_ref << endl;
+  }
+  BOOST_CHECK_EQUAL(check_hsx, true);
+  bool check_htx = HtX_ref.isApprox(HtX, 1e-4);
+  if (!check_htx) {
+    cout << "Ht*X matrix free" << endl;
+    cout << HtX << endl;
+    cout << "Ht*X ref" << endl;
+    cout << HtX_ref << endl;
+  }
+  BOOST_CHECK_EQUAL(check_htx, true);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
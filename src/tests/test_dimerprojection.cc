@@ -0,0 +1,143 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE dimerprojection_test
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+#include <votca/xtp/aomatrix.h>
+#include <votca/xtp/dimerprojection.h>
+
+using namespace votca::xtp;
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(dimerprojection_test)
+
+// orthonormal orbitals of the molecule in the xyz file
+void SetupOrbitals(Orbitals& orbitals, const string& xyzfile) {
+  orbitals.LoadFromXYZ(xyzfile);
+  orbitals.setDFTbasisName("3-21G.xml");
+  BasisSet basis;
+  basis.LoadBasisSet("3-21G.xml");
+  AOBasis aobasis;
+  aobasis.AOBasisFill(basis, orbitals.QMAtoms());
+  orbitals.setBasisSetSize(aobasis.AOBasisSize());
+  AOOverlap overlap;
+  overlap.Fill(aobasis);
+  orbitals.MOCoefficients() = overlap.Pseudo_InvSqrt(1e-9);
+  orbitals.AOOverlap() = overlap.Matrix();
+}
+
+BOOST_AUTO_TEST_CASE(project_test) {
+  ofstream xyzA("monomerA.xyz");
+  xyzA << " 2" << endl;
+  xyzA << " H2" << endl;
+  xyzA << " H            .000000     .000000     .000000" << endl;
+  xyzA << " H            .740000     .000000     .000000" << endl;
+  xyzA.close();
+  ofstream xyzB("monomerB.xyz");
+  xyzB << " 2" << endl;
+  xyzB << " H2" << endl;
+  xyzB << " H            .000000    1.500000     .000000" << endl;
+  xyzB << " H            .740000    1.500000     .000000" << endl;
+  xyzB.close();
+  ofstream xyzAB("dimer.xyz");
+  xyzAB << " 5" << endl;
+  xyzAB << " H2 H2 with linker" << endl;
+  xyzAB << " H            .000000     .000000     .000000" << endl;
+  xyzAB << " H            .740000     .000000     .000000" << endl;
+  xyzAB << " H            .000000    1.500000     .000000" << endl;
+  xyzAB << " H            .740000    1.500000     .000000" << endl;
+  xyzAB << " H            .370000     .750000     .500000" << endl;
+  xyzAB.close();
+
+  ofstream basisfile("3-21G.xml");
+  basisfile << "<basis name=\"3-21G\">" << endl;
+  basisfile << "  <element name=\"H\">" << endl;
+  basisfile << "    <shell scale=\"1.0\" type=\"S\">" << endl;
+  basisfile << "      <constant decay=\"5.447178e+00\">" << endl;
+  basisfile << "        <contractions factor=\"1.562850e-01\" type=\"S\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "      <constant decay=\"8.245470e-01\">" << endl;
+  basisfile << "        <contractions factor=\"9.046910e-01\" type=\"S\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "    </shell>" << endl;
+  basisfile << "    <shell scale=\"1.0\" type=\"S\">" << endl;
+  basisfile << "      <constant decay=\"1.831920e-01\">" << endl;
+  basisfile << "        <contractions factor=\"1.000000e+00\" type=\"S\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "    </shell>" << endl;
+  basisfile << "  </element>" << endl;
+  basisfile << "</basis>" << endl;
+  basisfile.close();
+
+  Orbitals orbitalsA;
+  SetupOrbitals(orbitalsA, "monomerA.xyz");
+  Orbitals orbitalsB;
+  SetupOrbitals(orbitalsB, "monomerB.xyz");
+  Orbitals orbitalsAB;
+  SetupOrbitals(orbitalsAB, "dimer.xyz");
+
+  // reference with the full dimer overlap
+  int basisAB = orbitalsAB.getBasisSetSize();
+  Eigen::MatrixXd psi_AxB = Eigen::MatrixXd::Zero(basisAB, 3 + 2);
+  psi_AxB.block(0, 0, 4, 3) = orbitalsA.MOCoefficients().middleCols(1, 3);
+  psi_AxB.block(4, 3, 4, 2) = orbitalsB.MOCoefficients().middleCols(0, 2);
+  Eigen::MatrixXd overlapAB = orbitalsAB.AOOverlap();
+  Eigen::MatrixXd ref =
+      psi_AxB.transpose() * overlapAB * orbitalsAB.MOCoefficients();
+
+  DimerProjection from_overlap;
+  from_overlap.Initialize(orbitalsA, orbitalsB, orbitalsAB);
+  Eigen::MatrixXd projection =
+      from_overlap.Project(orbitalsA, orbitalsB, orbitalsAB, 1, 3, 0, 2);
+  BOOST_CHECK(projection.isApprox(ref, 1e-8));
+
+  // only the inter-monomer overlap is integrated
+  orbitalsAB.AOOverlap().resize(0, 0);
+  DimerProjection from_integrals;
+  from_integrals.Initialize(orbitalsA, orbitalsB, orbitalsAB);
+  projection =
+      from_integrals.Project(orbitalsA, orbitalsB, orbitalsAB, 1, 3, 0, 2);
+  BOOST_CHECK(projection.isApprox(ref, 1e-8));
+
+  // incomplete set of monomer orbitals needs the monomer overlap
+  orbitalsA.MOCoefficients().conservativeResize(4, 3);
+  from_integrals.Initialize(orbitalsA, orbitalsB, orbitalsAB);
+  projection =
+      from_integrals.Project(orbitalsA, orbitalsB, orbitalsAB, 0, 3, 0, 2);
+  psi_AxB.block(0, 0, 4, 3) = orbitalsA.MOCoefficients();
+  ref = psi_AxB.transpose() * overlapAB * orbitalsAB.MOCoefficients();
+  BOOST_CHECK(projection.isApprox(ref, 1e-8));
+}
+
+BOOST_AUTO_TEST_CASE(merge_test) {
+  Eigen::MatrixXd mosA = Eigen::MatrixXd::Constant(2, 3, 1.0);
+  Eigen::MatrixXd mosB = Eigen::MatrixXd::Constant(4, 2, 2.0);
+  Eigen::MatrixXd merged = DimerProjection::MergeMOs(mosA, mosB);
+  BOOST_CHECK_EQUAL(merged.rows(), 6);
+  BOOST_CHECK_EQUAL(merged.cols(), 5);
+  BOOST_CHECK(merged.topLeftCorner(2, 3).isApprox(mosA));
+  BOOST_CHECK(merged.bottomRightCorner(4, 2).isApprox(mosB));
+  BOOST_CHECK(merged.topRightCorner(2, 2).isZero());
+  BOOST_CHECK(merged.bottomLeftCorner(4, 3).isZero());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE gwbseensemble_test
+#include "../libxtp/tools/gwbseensemble.h"
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+#include <votca/xtp/aomatrix.h>
+#include <votca/xtp/gwbse.h>
+#include <votca/xtp/orbitals.h>
+
+using namespace votca::xtp;
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(gwbseensemble_test)
+
+// core Hamiltonian orbitals of methane, together with a zero Vxc matrix
+// this is a complete GW-BSE input without a DFT run
+void WriteSnapshot(const std::string& orbfile, double bond) {
+  ofstream xyzfile("ensemble.xyz");
+  xyzfile << " 5" << endl;
+  xyzfile << " methane" << endl;
+  xyzfile << " C  0.0 0.0 0.0" << endl;
+  xyzfile << " H  " << bond << " " << bond << " " << bond << endl;
+  xyzfile << " H  " << -bond << " " << -bond << " " << bond << endl;
+  xyzfile << " H  " << bond << " " << -bond << " " << -bond << endl;
+  xyzfile << " H  " << -bond << " " << bond << " " << -bond << endl;
+  xyzfile.close();
+
+  Orbitals orbitals;
+  orbitals.LoadFromXYZ("ensemble.xyz");
+  BasisSet basis;
+  basis.LoadBasisSet("3-21G.xml");
+  AOBasis aobasis;
+  aobasis.AOBasisFill(basis, orbitals.QMAtoms());
+  AOOverlap overlap;
+  overlap.Fill(aobasis);
+  AOKinetic kinetic;
+  kinetic.Fill(aobasis);
+  AOESP esp;
+  esp.Fillnucpotential(aobasis, orbitals.QMAtoms());
+  Eigen::MatrixXd H0 = kinetic.Matrix() + esp.getNuclearpotential();
+  Eigen::GeneralizedSelfAdjointEigenSolver<Eigen::MatrixXd> es(
+      H0, overlap.Matrix());
+
+  int basissize = aobasis.AOBasisSize();
+  orbitals.setBasisSetSize(basissize);
+  orbitals.setNumberOfAlphaElectrons(5);
+  orbitals.setNumberOfOccupiedLevels(5);
+  orbitals.setDFTbasisName("3-21G.xml");
+  orbitals.setQMpackage("xtp");
+  orbitals.MOEnergies() = es.eigenvalues();
+  orbitals.MOCoefficients() = es.eigenvectors();
+  orbitals.AOVxc() = Eigen::MatrixXd::Zero(basissize, basissize);
+  orbitals.WriteToCpt(orbfile);
+}
+
+BOOST_AUTO_TEST_CASE(pipeline_matches_evaluate) {
+
+  ofstream basisfile("3-21G.xml");
+  basisfile << "<basis name=\"3-21G\">" << endl;
+  basisfile << "  <element name=\"H\">" << endl;
+  basisfile << "    <shell scale=\"1.0\" type=\"S\">" << endl;
+  basisfile << "      <constant decay=\"5.447178e+00\">" << endl;
+  basisfile << "        <contractions factor=\"1.562850e-01\" type=\"S\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "      <constant decay=\"8.245470e-01\">" << endl;
+  basisfile << "        <contractions factor=\"9.046910e-01\" type=\"S\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "    </shell>" << endl;
+  basisfile << "    <shell scale=\"1.0\" type=\"S\">" << endl;
+  basisfile << "      <constant decay=\"1.831920e-01\">" << endl;
+  basisfile << "        <contractions factor=\"1.000000e+00\" type=\"S\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "    </shell>" << endl;
+  basisfile << "  </element>" << endl;
+  basisfile << "  <element name=\"C\">" << endl;
+  basisfile << "    <shell scale=\"1.0\" type=\"S\">" << endl;
+  basisfile << "      <constant decay=\"1.722560e+02\">" << endl;
+  basisfile << "        <contractions factor=\"6.176690e-02\" type=\"S\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "      <constant decay=\"2.591090e+01\">" << endl;
+  basisfile << "        <contractions factor=\"3.587940e-01\" type=\"S\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "      <constant decay=\"5.533350e+00\">" << endl;
+  basisfile << "        <contractions factor=\"7.007130e-01\" type=\"S\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "    </shell>" << endl;
+  basisfile << "    <shell scale=\"1.0\" type=\"SP\">" << endl;
+  basisfile << "      <constant decay=\"3.664980e+00\">" << endl;
+  basisfile << "        <contractions factor=\"-3.958970e-01\" type=\"S\"/>"
+            << endl;
+  basisfile << "        <contractions factor=\"2.364600e-01\" type=\"P\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "      <constant decay=\"7.705450e-01\">" << endl;
+  basisfile << "        <contractions factor=\"1.215840e+00\" type=\"S\"/>"
+            << endl;
+  basisfile << "        <contractions factor=\"8.606190e-01\" type=\"P\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "    </shell>" << endl;
+  basisfile << "    <shell scale=\"1.0\" type=\"SP\">" << endl;
+  basisfile << "      <constant decay=\"1.958570e-01\">" << endl;
+  basisfile << "        <contractions factor=\"1.000000e+00\" type=\"S\"/>"
+            << endl;
+  basisfile << "        <contractions factor=\"1.000000e+00\" type=\"P\"/>"
+            << endl;
+  basisfile << "      </constant>" << endl;
+  basisfile << "    </shell>" << endl;
+  basisfile << "  </element>" << endl;
+  basisfile << "</basis>" << endl;
+  basisfile.close();
+
+  ofstream gwbsefile("ensemble_gwbse.xml");
+  gwbsefile << "<gwbse>" << endl;
+  gwbsefile << "  <dftbasis>3-21G.xml</dftbasis>" << endl;
+  gwbsefile << "  <auxbasis>3-21G.xml</auxbasis>" << endl;
+  gwbsefile << "  <ranges>default</ranges>" << endl;
+  gwbsefile << "  <mode>G0W0</mode>" << endl;
+  gwbsefile << "  <tasks>singlets</tasks>" << endl;
+  gwbsefile << "  <store>singlets</store>" << endl;
+  gwbsefile << "  <exctotal>5</exctotal>" << endl;
+  gwbsefile << "</gwbse>" << endl;
+  gwbsefile.close();
+
+  std::vector<std::string> orbfiles = {"ensemble_0.orb", "ensemble_1.orb"};
+  WriteSnapshot(orbfiles[0], 0.629118);
+  WriteSnapshot(orbfiles[1], 0.68);
+  ofstream listfile("ensemble.txt");
+  for (const std::string& orbfile : orbfiles) {
+    listfile << orbfile << endl;
+  }
+  listfile.close();
+
+  votca::tools::Property root;
+  votca::tools::Property& options =
+      root.add("options", "").add("gwbseensemble", "");
+  options.add("snapshots", "ensemble.txt");
+  options.add("gwbse_options", "ensemble_gwbse.xml");
+  options.add("output", "ensemble.out.xml");
+  GWBSEEnsemble ensemble;
+  ensemble.Initialize(&root);
+  ensemble.Evaluate();
+
+  // the integrals of the second molecule are computed while GW-BSE of the
+  // first one is solved, each must still match a plain GWBSE::Evaluate
+  votca::tools::Property gwbse_options;
+  load_property_from_xml(gwbse_options, "ensemble_gwbse.xml");
+  std::vector<Eigen::VectorXd> qp_energies;
+  for (const std::string& orbfile : orbfiles) {
+    Orbitals pipelined;
+    pipelined.ReadFromCpt(orbfile);
+    BOOST_REQUIRE_GT(pipelined.BSESingletEnergies().size(), 0);
+
+    Orbitals reference;
+    reference.ReadFromCpt(orbfile);
+    votca::ctp::Logger log;
+    GWBSE gwbse(reference);
+    gwbse.setLogger(&log);
+    gwbse.Initialize(gwbse_options);
+    gwbse.Evaluate();
+
+    BOOST_CHECK(pipelined.QPpertEnergies().isApprox(
+        reference.QPpertEnergies(), 1e-5));
+    BOOST_CHECK(pipelined.BSESingletEnergies().isApprox(
+        reference.BSESingletEnergies(), 1e-5));
+    qp_energies.push_back(pipelined.QPpertEnergies().col(0));
+  }
+  // the results must not be swapped between the snapshots
+  BOOST_CHECK(!qp_energies[0].isApprox(qp_energies[1], 1e-5));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
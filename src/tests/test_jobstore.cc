@@ -0,0 +1,210 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE jobstore_test
+#include <boost/test/unit_test.hpp>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <votca/ctp/topology.h>
+#include <votca/xtp/jobstore.h>
+#include <votca/xtp/jobstorecalc.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace votca::xtp;
+using votca::tools::Property;
+
+BOOST_AUTO_TEST_SUITE(jobstore_test)
+
+// runs no calculation, records the threads every job was run with
+class ThreadRecorder : public JobStoreCalc {
+ public:
+  explicit ThreadRecorder(const std::string& jobfile) { _jobfile = jobfile; }
+  std::string Identify() { return "threadrecorder"; }
+  void Initialize(Property* options) { return; }
+
+  votca::ctp::Job::JobResult EvalJob(votca::ctp::Topology* top,
+                                     votca::ctp::Job* job,
+                                     votca::ctp::QMThread* thread) {
+    allocated[job->getId()] = JobThreads(thread);
+#ifdef _OPENMP
+    used[job->getId()] = omp_get_max_threads();
+#endif
+    votca::ctp::Job::JobResult result;
+    result.setStatus(votca::ctp::Job::COMPLETE);
+    return result;
+  }
+
+  std::map<int, int> allocated;
+  std::map<int, int> used;
+
+ protected:
+  double JobCost(votca::ctp::Topology* top, votca::ctp::Job* job) {
+    return (job->getId() == 1) ? 3.0 : 1.0;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(property_encoding) {
+  Property root;
+  Property& input = root.add("input", "");
+  Property& segment = input.add("segment", "");
+  segment.setAttribute("id", "12");
+  segment.setAttribute("type", "DCV:2");
+  input.add("note", "a < b & 3:4");
+
+  std::string code = JobStore::EncodeProperty(input);
+  Property decoded;
+  JobStore::DecodeProperty(code, decoded);
+
+  BOOST_CHECK(decoded.exists("input.segment"));
+  Property& seg = decoded.get("input.segment");
+  BOOST_CHECK_EQUAL(seg.getAttribute<int>("id"), 12);
+  BOOST_CHECK_EQUAL(seg.getAttribute<std::string>("type"), "DCV:2");
+  BOOST_CHECK_EQUAL(decoded.get("input.note").as<std::string>(),
+                    "a < b & 3:4");
+  BOOST_CHECK_EQUAL(JobStore::EncodeProperty(decoded.get("input")), code);
+}
+
+BOOST_AUTO_TEST_CASE(claim_report_restart) {
+  std::remove("jobstore_test.sql");
+  std::ofstream jobfile("jobstore_test.xml");
+  jobfile << "<jobs>" << std::endl;
+  for (int id = 1; id <= 3; id++) {
+    jobfile << "  <job>" << std::endl;
+    jobfile << "    <id>" << id << "</id>" << std::endl;
+    jobfile << "    <tag>pair" << id << "</tag>" << std::endl;
+    jobfile << "    <input><segment id=\"" << id << "\" type=\"A\"/></input>"
+            << std::endl;
+    jobfile << "    <status>AVAILABLE</status>" << std::endl;
+    jobfile << "  </job>" << std::endl;
+  }
+  jobfile << "</jobs>" << std::endl;
+  jobfile.close();
+
+  JobStore store;
+  store.Open("jobstore_test.sql");
+  BOOST_CHECK_EQUAL(store.ImportJobs("jobstore_test.xml"), 3);
+  BOOST_CHECK_EQUAL(store.CountJobs("AVAILABLE"), 3);
+
+  std::vector<votca::ctp::Job*> jobs = store.ClaimJobs(2, "node1:100");
+  BOOST_CHECK_EQUAL(jobs.size(), 2);
+  BOOST_CHECK_EQUAL(jobs[0]->getId(), 1);
+  BOOST_CHECK_EQUAL(jobs[1]->getId(), 2);
+  BOOST_CHECK_EQUAL(
+      jobs[1]->getInput().get("segment").getAttribute<int>("id"), 2);
+  BOOST_CHECK_EQUAL(store.CountJobs("AVAILABLE"), 1);
+  BOOST_CHECK_EQUAL(store.CountJobs("ASSIGNED"), 2);
+
+  votca::ctp::Job::JobResult result;
+  Property output;
+  output.add("output", "").add("coupling", "0.5");
+  result.setStatus(votca::ctp::Job::COMPLETE);
+  result.setOutput(output.get("output"));
+  store.ReportJob(*jobs[0], result, "node1:100");
+  for (votca::ctp::Job* job : jobs) {
+    delete job;
+  }
+  BOOST_CHECK_EQUAL(store.CountJobs("COMPLETE"), 1);
+
+  // job 2 was left behind by a crashed process
+  store.ResetJobs("host(node1:100)");
+  BOOST_CHECK_EQUAL(store.CountJobs("AVAILABLE"), 2);
+  BOOST_CHECK_EQUAL(store.CountJobs("COMPLETE"), 1);
+
+  store.ExportJobs("jobstore_test.xml");
+  store.Close();
+
+  std::vector<votca::ctp::Job*> exported =
+      votca::ctp::LOAD_JOBS("jobstore_test.xml");
+  BOOST_CHECK_EQUAL(exported.size(), 3);
+  BOOST_CHECK_EQUAL(exported[0]->getStatusStr(), "COMPLETE");
+  Property exported_output = exported[0]->getOutput();
+  BOOST_CHECK_EQUAL(exported_output.get("coupling").as<double>(), 0.5);
+  BOOST_CHECK_EQUAL(exported[1]->getStatusStr(), "AVAILABLE");
+  for (votca::ctp::Job* job : exported) {
+    delete job;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(largest_first) {
+  std::remove("jobstore_cost.sql");
+  std::ofstream jobfile("jobstore_cost.xml");
+  jobfile << "<jobs>" << std::endl;
+  for (int id = 1; id <= 4; id++) {
+    jobfile << "  <job><id>" << id << "</id><tag>seg" << id << "</tag>"
+            << "<input><segment id=\"" << id << "\"/></input>"
+            << "<status>AVAILABLE</status></job>" << std::endl;
+  }
+  jobfile << "</jobs>" << std::endl;
+  jobfile.close();
+
+  std::vector<double> costs = {0.0, 2.0, 9.0, 1.0, 9.0};
+  JobStore store;
+  store.Open("jobstore_cost.sql");
+  store.ImportJobs("jobstore_cost.xml", [&costs](votca::ctp::Job* job) {
+    return costs[job->getId()];
+  });
+  BOOST_CHECK_CLOSE(store.MeanCost("AVAILABLE"), 5.25, 1e-10);
+
+  std::vector<double> claimed_costs;
+  std::vector<votca::ctp::Job*> jobs =
+      store.ClaimJobs(3, "node1:100", &claimed_costs);
+  BOOST_CHECK_EQUAL(jobs.size(), 3);
+  BOOST_CHECK_EQUAL(jobs[0]->getId(), 2);
+  BOOST_CHECK_EQUAL(jobs[1]->getId(), 4);
+  BOOST_CHECK_EQUAL(jobs[2]->getId(), 1);
+  BOOST_CHECK_CLOSE(claimed_costs[2], 2.0, 1e-10);
+  for (votca::ctp::Job* job : jobs) {
+    delete job;
+  }
+  store.Close();
+}
+
+#ifdef _OPENMP
+BOOST_AUTO_TEST_CASE(cost_scaled_threads) {
+  std::remove("jobstore_threads.xml.sql");
+  std::ofstream jobfile("jobstore_threads.xml");
+  jobfile << "<jobs>" << std::endl;
+  for (int id = 1; id <= 2; id++) {
+    jobfile << "  <job><id>" << id << "</id><tag>seg" << id << "</tag>"
+            << "<input><segment id=\"" << id << "\"/></input>"
+            << "<status>AVAILABLE</status></job>" << std::endl;
+  }
+  jobfile << "</jobs>" << std::endl;
+  jobfile.close();
+
+  const int default_threads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  votca::ctp::Topology top;
+  ThreadRecorder calc("jobstore_threads.xml");
+  calc.setnThreads(1);
+  calc.UseJobStore(8, -1, "");
+  calc.EvaluateFrame(&top);
+  omp_set_num_threads(default_threads);
+
+  // mean cost 2 on 4 cores, the large job gets all of them
+  BOOST_CHECK_EQUAL(calc.allocated[1], 4);
+  BOOST_CHECK_EQUAL(calc.allocated[2], 2);
+  BOOST_CHECK_EQUAL(calc.used[1], 4);
+  BOOST_CHECK_EQUAL(calc.used[2], 2);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
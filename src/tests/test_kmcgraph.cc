@@ -0,0 +1,95 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#define BOOST_TEST_MODULE kmcgraph_test
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <vector>
+#include <votca/xtp/gnode.h>
+#include <votca/xtp/kmcgraph.h>
+
+using namespace votca::xtp;
+
+BOOST_AUTO_TEST_SUITE(kmcgraph_test)
+
+BOOST_AUTO_TEST_CASE(layout_test) {
+  GNode a;
+  a.id = 0;
+  a.AddEvent(1, 10, votca::tools::vec(1, 0, 0), 0.0, 0.0);
+  a.AddEvent(2, 30, votca::tools::vec(0, 1, 0), 0.0, 0.0);
+  GNode b;
+  b.id = 1;
+  b.AddEvent(0, 5, votca::tools::vec(-1, 0, 0), 0.0, 0.0);
+  b.AddDecayEvent(15);
+  GNode c;
+  c.id = 2;
+  c.AddEvent(0, 7, votca::tools::vec(0, -1, 0), 0.0, 0.0);
+  std::vector<GNode*> nodes = {&a, &b, &c};
+
+  KMCGraph graph(nodes);
+  BOOST_CHECK_EQUAL(graph.NumberofNodes(), 3);
+  BOOST_CHECK_EQUAL(graph.NumberofEvents(), 5);
+  BOOST_CHECK_EQUAL(graph.EventsBegin(1), 2);
+  BOOST_CHECK_EQUAL(graph.EventsEnd(1), 4);
+  BOOST_CHECK_EQUAL(graph.Destination(1), 2);
+  BOOST_CHECK_EQUAL(graph.isDecay(3), true);
+  BOOST_CHECK_EQUAL(graph.hasDecay(1), true);
+  BOOST_CHECK_CLOSE(graph.EscapeRate(0), 40, 1e-12);
+  BOOST_CHECK_CLOSE(graph.EscapeRate(1), 20, 1e-12);
+  BOOST_CHECK_CLOSE(graph.dr(2).getX(), -1, 1e-12);
+
+  graph.setRate(4, 3);
+  graph.UpdateNode(2);
+  BOOST_CHECK_CLOSE(graph.EscapeRate(2), 3, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(count_test) {
+  GNode g;
+  g.id = 0;
+  std::vector<double> rates = {15, 9, 11, 8, 12, 7, 13, 6, 14, 5, 100};
+  for (unsigned i = 0; i < rates.size(); i++) {
+    g.AddEvent(i, rates[i], votca::tools::vec(0.0), 0.0, 0.0);
+  }
+  std::vector<GNode*> nodes = {&g};
+  KMCGraph graph(nodes);
+
+  std::vector<int> count(rates.size(), 0);
+  for (int i = 1; i <= 200000; i++) {
+    double p = i / 200000.0;
+    count[graph.Destination(graph.FindHoppingDestination(0, p))]++;
+  }
+  for (unsigned i = 0; i < rates.size(); i++) {
+    BOOST_CHECK_CLOSE(double(count[i]), rates[i] * 1000, 0.1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(no_events_test) {
+  GNode a;
+  a.id = 0;
+  a.AddEvent(1, 10, votca::tools::vec(1, 0, 0), 0.0, 0.0);
+  GNode b;
+  b.id = 1;
+  std::vector<GNode*> nodes = {&a, &b};
+  KMCGraph graph(nodes);
+
+  BOOST_CHECK_EQUAL(graph.EventsBegin(1), graph.EventsEnd(1));
+  BOOST_CHECK_EQUAL(graph.EscapeRate(1), 0.0);
+  BOOST_CHECK_EQUAL(graph.FindHoppingDestination(0, 0.5), 0);
+  BOOST_CHECK_THROW(graph.FindHoppingDestination(1, 0.5), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE multipolesoa_test
+#include <boost/test/unit_test.hpp>
+#include <votca/xtp/multipolesoa.h>
+
+using namespace votca::xtp;
+using votca::tools::vec;
+
+BOOST_AUTO_TEST_SUITE(multipolesoa_test)
+
+struct PointCharge {
+  double x, y, z, q;
+};
+
+// charges, dipole and quadrupole of a cluster of point charges around center
+void AddCluster(MultipoleSoA& soa, const vec& center,
+                const std::vector<PointCharge>& charges) {
+  double q = 0.0;
+  double d[3] = {0.0, 0.0, 0.0};
+  double Q[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+  for (const PointCharge& c : charges) {
+    double r[3] = {c.x, c.y, c.z};
+    double r2 = c.x * c.x + c.y * c.y + c.z * c.z;
+    q += c.q;
+    for (int i = 0; i < 3; i++) {
+      d[i] += c.q * r[i];
+      for (int j = 0; j < 3; j++) {
+        Q[i][j] += 0.5 * c.q * (3.0 * r[i] * r[j] - ((i == j) ? r2 : 0.0));
+      }
+    }
+  }
+  const double sqrt3 = std::sqrt(3.0);
+  std::vector<double> Q2 = {Q[2][2], 2.0 / sqrt3 * Q[0][2],
+                            2.0 / sqrt3 * Q[1][2], (Q[0][0] - Q[1][1]) / sqrt3,
+                            2.0 / sqrt3 * Q[0][1]};
+  soa.Add(center, q, vec(d[0], d[1], d[2]), Q2);
+}
+
+void AddCharges(MultipoleSoA& soa, const vec& center,
+                const std::vector<PointCharge>& charges) {
+  const std::vector<double> noquadrupole(5, 0.0);
+  for (const PointCharge& c : charges) {
+    soa.Add(vec(center.getX() + c.x, center.getY() + c.y, center.getZ() + c.z),
+            c.q, vec(0.0, 0.0, 0.0), noquadrupole);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(charge_charge) {
+  MultipoleSoA a;
+  MultipoleSoA b;
+  const std::vector<double> noquadrupole(5, 0.0);
+  a.Add(vec(0.0, 0.0, 0.0), 1.0, vec(0.0, 0.0, 0.0), noquadrupole);
+  b.Add(vec(0.0, 0.0, 1.0), -2.0, vec(0.0, 0.0, 0.0), noquadrupole);
+  BOOST_CHECK_CLOSE(a.InteractionEnergy(b, vec(0.0, 0.0, 1.0)), -1.0, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(multipoles_vs_pointcharges) {
+  std::vector<PointCharge> clusterA = {{0.0025, 0.005, -0.0025, 0.3},
+                                       {-0.005, 0.0025, 0.005, -0.5},
+                                       {0.00375, -0.0025, 0.0025, 0.4},
+                                       {-0.0025, -0.005, -0.00375, -0.1}};
+  std::vector<PointCharge> clusterB = {{0.005, -0.0025, 0.0025, -0.2},
+                                       {-0.0025, 0.005, -0.005, 0.6},
+                                       {0.0025, 0.00375, 0.005, -0.3},
+                                       {-0.005, -0.0025, -0.0025, 0.1}};
+  vec centerA = vec(0.1, -0.2, 0.3);
+  vec centerB = vec(0.5, 0.3, -0.2);
+  vec shift = vec(1.0, 0.8, 1.2);
+
+  MultipoleSoA multipolesA;
+  MultipoleSoA multipolesB;
+  AddCluster(multipolesA, centerA, clusterA);
+  AddCluster(multipolesB, centerB, clusterB);
+  MultipoleSoA chargesA;
+  MultipoleSoA chargesB;
+  AddCharges(chargesA, centerA, clusterA);
+  AddCharges(chargesB, centerB, clusterB);
+
+  double E_ref = chargesA.InteractionEnergy(chargesB, shift);
+  double E = multipolesA.InteractionEnergy(multipolesB, shift);
+  // remaining difference is octupole and higher
+  BOOST_CHECK_CLOSE(E, E_ref, 1e-3);
+}
+
+// compares the multipole energy of two clusters with that of their point
+// charges, the relative remainder is of order (size/distance)^2
+void CheckVsPointCharges(const std::vector<PointCharge>& clusterA,
+                         const std::vector<PointCharge>& clusterB) {
+  vec centerA = vec(0.1, -0.2, 0.3);
+  vec centerB = vec(0.5, 0.3, -0.2);
+  vec shift = vec(1.0, 0.8, 1.2);
+
+  MultipoleSoA multipolesA;
+  MultipoleSoA multipolesB;
+  AddCluster(multipolesA, centerA, clusterA);
+  AddCluster(multipolesB, centerB, clusterB);
+  MultipoleSoA chargesA;
+  MultipoleSoA chargesB;
+  AddCharges(chargesA, centerA, clusterA);
+  AddCharges(chargesB, centerB, clusterB);
+
+  double E_ref = chargesA.InteractionEnergy(chargesB, shift);
+  double E = multipolesA.InteractionEnergy(multipolesB, shift);
+  BOOST_CHECK_CLOSE(E, E_ref, 0.5);
+}
+
+// +q and -q symmetric about the center, no charge and no quadrupole
+std::vector<PointCharge> PureDipole(double x, double y, double z, double q) {
+  return {{x, y, z, q}, {-x, -y, -z, -q}};
+}
+
+// +q at both ends and -2q at the center, no charge and no dipole
+std::vector<PointCharge> PureQuadrupole(double x, double y, double z,
+                                        double q) {
+  return {{x, y, z, q}, {-x, -y, -z, q}, {0.0, 0.0, 0.0, -2.0 * q}};
+}
+
+BOOST_AUTO_TEST_CASE(dipole_quadrupole) {
+  CheckVsPointCharges(PureDipole(0.02, -0.01, 0.015, 1.0),
+                      PureQuadrupole(-0.01, 0.02, 0.01, 1.0));
+  CheckVsPointCharges(PureQuadrupole(0.015, 0.01, -0.02, 1.0),
+                      PureDipole(0.01, 0.02, 0.01, -1.0));
+}
+
+BOOST_AUTO_TEST_CASE(quadrupole_quadrupole) {
+  CheckVsPointCharges(PureQuadrupole(0.02, -0.01, 0.015, 1.0),
+                      PureQuadrupole(-0.01, 0.02, 0.01, -1.0));
+  CheckVsPointCharges(PureQuadrupole(0.0, 0.0, 0.02, 1.0),
+                      PureQuadrupole(0.02, 0.01, 0.0, 1.0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE orbitalscache_test
+#include <boost/test/unit_test.hpp>
+#include <votca/xtp/orbitalscache.h>
+
+using namespace votca::xtp;
+
+BOOST_AUTO_TEST_SUITE(orbitalscache_test)
+
+BOOST_AUTO_TEST_CASE(least_recently_used) {
+  for (int i = 1; i <= 3; i++) {
+    Orbitals orbitals;
+    orbitals.setBasisSetSize(i);
+    orbitals.WriteToCpt("cache_" + std::to_string(i) + ".orb");
+  }
+
+  OrbitalsCache cache(2);
+  std::shared_ptr<const Orbitals> orb1 = cache.Get("cache_1.orb");
+  BOOST_CHECK_EQUAL(orb1->getBasisSetSize(), 1);
+  cache.Get("cache_2.orb");
+  BOOST_CHECK(cache.Get("cache_1.orb") == orb1);
+  BOOST_CHECK_EQUAL(cache.Hits(), 1);
+  BOOST_CHECK_EQUAL(cache.Misses(), 2);
+
+  // cache_2.orb is the least recently used and is evicted
+  cache.Get("cache_3.orb");
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK(cache.Get("cache_1.orb") == orb1);
+  BOOST_CHECK_EQUAL(cache.Get("cache_2.orb")->getBasisSetSize(), 2);
+  BOOST_CHECK_EQUAL(cache.Hits(), 2);
+  BOOST_CHECK_EQUAL(cache.Misses(), 4);
+
+  cache.setCapacity(0);
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+  BOOST_CHECK_EQUAL(cache.Get("cache_3.orb")->getBasisSetSize(), 3);
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+
+  BOOST_CHECK_THROW(cache.Get("cache_missing.orb"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2009-2018 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_MODULE scratcharena_test
+#include <boost/test/unit_test.hpp>
+#include <votca/xtp/scratcharena.h>
+
+using namespace votca::xtp;
+
+BOOST_AUTO_TEST_SUITE(scratcharena_test)
+
+BOOST_AUTO_TEST_CASE(frames_test) {
+  ScratchArena::Frame outer;
+  tensor3d_ref a = outer.Tensor3D(2, 3, 4);
+  a[1][2][3] = 5.0;
+  BOOST_CHECK_EQUAL(a.num_elements(), 24);
+
+  double* inner_data = NULL;
+  {
+    ScratchArena::Frame inner;
+    tensor4d_ref b = inner.Tensor4D(100, 100, 10, 10);
+    b[99][99][9][9] = 1.0;
+    inner_data = b.data();
+  }
+  std::size_t capacity = ScratchArena::Instance().Capacity();
+  {
+    // the memory of the released frame is reused and zeroed again
+    ScratchArena::Frame inner;
+    tensor4d_ref b = inner.Tensor4D(100, 100, 10, 10);
+    BOOST_CHECK_EQUAL(b.data(), inner_data);
+    BOOST_CHECK_EQUAL(b[99][99][9][9], 0.0);
+  }
+  BOOST_CHECK_EQUAL(ScratchArena::Instance().Capacity(), capacity);
+  BOOST_CHECK_EQUAL(a[1][2][3], 5.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -108,13 +108,12 @@ BOOST_AUTO_TEST_CASE(threecenter_dft) {
   TCMatrix_dft threec;
   threec.Fill(aobasis, aobasis);
 
-  Eigen::MatrixXd Res0 =
-      Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
-  threec[0].AddtoEigenMatrix(Res0);
+  // all shell pairs of a small molecule are significant
+  int nshells = aobasis.getNumofShells();
+  BOOST_CHECK_EQUAL(threec.SignificantPairs(), nshells * (nshells + 1) / 2);
 
-  Eigen::MatrixXd Res4 =
-      Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
-  threec[4].AddtoEigenMatrix(Res4);
+  Eigen::MatrixXd Res0 = threec.FullMatrix(0);
+  Eigen::MatrixXd Res4 = threec.FullMatrix(4);
 
   Eigen::MatrixXd Ref0 =
       Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
@@ -239,6 +238,30 @@ BOOST_AUTO_TEST_CASE(threecenter_dft) {
     cout << Ref4 << endl;
   }
   BOOST_CHECK_EQUAL(check_three2, true);
+
+  Eigen::MatrixXd dmat = Eigen::MatrixXd::Identity(aobasis.AOBasisSize(),
+                                                   aobasis.AOBasisSize());
+  dmat(0, 1) = 0.3;
+  dmat(1, 0) = 0.3;
+  Eigen::MatrixXd J_ref =
+      Eigen::MatrixXd::Zero(aobasis.AOBasisSize(), aobasis.AOBasisSize());
+  for (int i = 0; i < threec.size(); i++) {
+    Eigen::MatrixXd threecenter = threec.FullMatrix(i);
+    J_ref += threecenter.cwiseProduct(dmat).sum() * threecenter;
+  }
+  Eigen::MatrixXd J = threec.ContractDensity(dmat);
+  BOOST_CHECK_EQUAL(J.isApprox(J_ref, 1e-10), true);
+
+  TCMatrix_dft single;
+  single.setSinglePrecision(true);
+  single.Fill(aobasis, aobasis);
+  Eigen::MatrixXd Res4_single = single.FullMatrixFloat(4).cast<double>();
+  BOOST_CHECK_EQUAL(Res4_single.isApprox(Res4, 1e-6), true);
+  BOOST_CHECK_EQUAL(single.ContractDensity(dmat).isApprox(J, 1e-5), true);
+  single.RefillDouble();
+  BOOST_CHECK_EQUAL(single.isSinglePrecision(), false);
+  BOOST_CHECK_EQUAL(single.FullMatrix(4).isApprox(Res4, 1e-12), true);
+  BOOST_CHECK_EQUAL(single.ContractDensity(dmat).isApprox(J, 1e-12), true);
 }
 
 BOOST_AUTO_TEST_CASE(threecenter_gwbse) {
@@ -419,5 +442,40 @@ BOOST_AUTO_TEST_CASE(threecenter_gwbse) {
   }
 
   BOOST_CHECK_EQUAL(check4_before, true);
+
+  // the error of contractions over the aux index is bounded by the sum of
+  // the dropped eigenvalues, i.e. by tolerance x trace
+  const double tolerance = 1e-2;
+  TCMatrix_gwbse compressed;
+  compressed.Initialize(aobasis.AOBasisSize(), 0, 5, 0, 7);
+  compressed.setCompression(tolerance);
+  compressed.Fill(aobasis, aobasis, MOs);
+  BOOST_CHECK_GT(compressed.Compressedfunctions(), 0);
+  BOOST_CHECK_EQUAL(compressed.auxsize() + compressed.Compressedfunctions(),
+                    aobasis.AOBasisSize());
+  double trace = 0.0;
+  for (int m = 0; m < tc.msize(); m++) {
+    trace += tc[m].cast<double>().squaredNorm();
+  }
+  for (int m = 0; m < tc.msize(); m++) {
+    MatrixXfd contracted = tc[m] * tc[0].transpose();
+    MatrixXfd contracted_compressed =
+        compressed[m] * compressed[0].transpose();
+    double error = (contracted_compressed - contracted).cast<double>().norm();
+    BOOST_CHECK_LE(error, 1.01 * tolerance * trace);
+  }
+
+  // a limit below the size of one level stores all levels in a scratch file,
+  // into which Fill writes the integrals of one aux shell after the other
+  TCMatrix_gwbse outofcore;
+  outofcore.setOutOfCore(1, ".");
+  outofcore.Initialize(aobasis.AOBasisSize(), 0, 5, 0, 7);
+  BOOST_CHECK_EQUAL(outofcore.isOutOfCore(), true);
+  outofcore.Fill(aobasis, aobasis, MOs);
+  for (int m = 0; m < tc.msize(); m++) {
+    outofcore.Prefetch(m);
+    BOOST_CHECK(outofcore[m].isApprox(tc[m], 1e-5));
+    outofcore.Release(m);
+  }
 }
 BOOST_AUTO_TEST_SUITE_END()